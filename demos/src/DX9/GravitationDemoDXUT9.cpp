@@ -227,7 +227,7 @@ int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdL
 #endif
 
 	// random seed
-	randomSeed = static_cast<unsigned int>(time(NULL));
+	SPKContext::get().setRandomSeed(static_cast<unsigned int>(time(NULL)));
 
 	// Sets the update step
 	System::setClampStep(true,0.01f);			// clamp the step to 10 ms
@@ -256,7 +256,7 @@ int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdL
 	// SPARK INITS
 
 	// random seed
-	randomSeed = static_cast<unsigned int>(time(NULL));
+	SPKContext::get().setRandomSeed(static_cast<unsigned int>(time(NULL)));
 
 	// Sets the update step
 	System::setClampStep(true,0.1f);			// clamp the step to 100 ms
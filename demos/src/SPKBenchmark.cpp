@@ -0,0 +1,218 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+// Console benchmark of the update of a group of particles.
+// No rendering is performed, only the simulation is measured.
+
+#include <cstdlib>
+#include <ctime>
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#include <chrono>
+#define BENCHMARK_WALL_CLOCK
+#endif
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <SPARK.h>
+
+const size_t DEFAULT_NB_PARTICLES = 1000000;
+const size_t NB_UPDATES = 100;
+const float DELTA_TIME = 0.016f;
+
+// The columns of particle data streamed by the update of the benchmark group
+enum Column
+{
+	COLUMN_AGES,
+	COLUMN_LIFETIMES,
+	COLUMN_ENERGIES,
+	COLUMN_POSITIONS,
+	COLUMN_OLD_POSITIONS,
+	COLUMN_VELOCITIES,
+	COLUMN_COLORS,
+	COLUMN_SCALES,
+	COLUMN_MASSES,
+	COLUMN_SQR_DISTS,
+	NB_COLUMNS,
+};
+
+const size_t COLUMN_SIZES[NB_COLUMNS] =
+{
+	sizeof(float),			// COLUMN_AGES
+	sizeof(float),			// COLUMN_LIFETIMES
+	sizeof(float),			// COLUMN_ENERGIES
+	sizeof(SPK::Vector3D),	// COLUMN_POSITIONS
+	sizeof(SPK::Vector3D),	// COLUMN_OLD_POSITIONS
+	sizeof(SPK::Vector3D),	// COLUMN_VELOCITIES
+	sizeof(SPK::Color),		// COLUMN_COLORS
+	sizeof(float),			// COLUMN_SCALES
+	sizeof(float),			// COLUMN_MASSES
+	sizeof(float),			// COLUMN_SQR_DISTS
+};
+
+#define COLUMN(c) (1 << (c))
+
+// A stage of the update with the columns it reads and writes
+struct Stage
+{
+	const char* name;
+	unsigned int read;
+	unsigned int written;
+};
+
+const Stage STAGES[] =
+{
+	{ "age",			COLUMN(COLUMN_AGES),											COLUMN(COLUMN_AGES) },
+	{ "energy",			COLUMN(COLUMN_AGES) | COLUMN(COLUMN_LIFETIMES),					COLUMN(COLUMN_ENERGIES) },
+	{ "integrate",		COLUMN(COLUMN_POSITIONS) | COLUMN(COLUMN_VELOCITIES),			COLUMN(COLUMN_POSITIONS) | COLUMN(COLUMN_OLD_POSITIONS) },
+	{ "color",			COLUMN(COLUMN_ENERGIES),										COLUMN(COLUMN_COLORS) },
+	{ "scale",			COLUMN(COLUMN_ENERGIES),										COLUMN(COLUMN_SCALES) },
+	{ "gravity",		COLUMN(COLUMN_VELOCITIES),										COLUMN(COLUMN_VELOCITIES) },
+	{ "friction",		COLUMN(COLUMN_VELOCITIES) | COLUMN(COLUMN_MASSES),				COLUMN(COLUMN_VELOCITIES) },
+	{ "distance",		COLUMN(COLUMN_POSITIONS),										COLUMN(COLUMN_SQR_DISTS) },
+};
+
+const size_t NB_STAGES = sizeof(STAGES) / sizeof(Stage);
+
+size_t getColumnsSize(unsigned int columns)
+{
+	size_t size = 0;
+	for (size_t i = 0; i < NB_COLUMNS; ++i)
+		if (columns & COLUMN(i))
+			size += COLUMN_SIZES[i];
+	return size;
+}
+
+// Estimates the number of bytes moved between the memory and the cache per particle and per update.
+// This is an analytical estimate derived from the STAGES table, not a measure of the traffic.
+// Stage by stage, each stage streams its own columns as the whole group does not fit in cache.
+// Tile by tile, each column is read and written once as the tile stays in cache between the stages.
+size_t computeTrafficPerParticle(bool fused)
+{
+	size_t traffic = 0;
+	if (fused)
+	{
+		unsigned int read = 0;
+		unsigned int written = 0;
+		for (size_t i = 0; i < NB_STAGES; ++i)
+		{
+			read |= STAGES[i].read & ~written; // A column written by a previous stage of the tile is already in cache
+			written |= STAGES[i].written;
+		}
+		traffic = getColumnsSize(read) + getColumnsSize(written);
+	}
+	else
+		for (size_t i = 0; i < NB_STAGES; ++i)
+			traffic += getColumnsSize(STAGES[i].read) + getColumnsSize(STAGES[i].written);
+
+	return traffic;
+}
+
+// Gets the time in seconds (wall clock time when available so that parallel updates are measured correctly)
+double getTime()
+{
+#ifdef BENCHMARK_WALL_CLOCK
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+SPK::Ref<SPK::System> createSystem(size_t nbParticles,bool fused,bool split,bool parallel)
+{
+	SPK::Ref<SPK::System> system = SPK::System::create(true);
+	system->setCameraPosition(SPK::Vector3D(0.0f,0.0f,10.0f));
+
+	SPK::Ref<SPK::Group> group = system->createGroup(nbParticles);
+	group->setLifeTime(1000.0f,1000.0f); // No particle dies during the benchmark
+	group->enableDistanceComputation(true);
+	group->enableFusedUpdate(fused);
+	group->enableSplitStorage(split);
+	group->enableParallelUpdate(parallel);
+	group->setColorInterpolator(SPK::ColorSimpleInterpolator::create(0xFFFFFFFF,0x00000000));
+	group->setParamInterpolator(SPK::PARAM_SCALE,SPK::FloatSimpleInterpolator::create(1.0f,0.0f));
+	group->setParamInterpolator(SPK::PARAM_MASS,SPK::FloatRandomInitializer::create(0.5f,2.0f));
+	group->addModifier(SPK::Gravity::create(SPK::Vector3D(0.0f,-1.0f,0.0f)));
+	group->addModifier(SPK::Friction::create(0.2f));
+
+	group->addParticles(nbParticles,SPK::Sphere::create(SPK::Vector3D(),1.0f),SPK::Vector3D(0.0f,1.0f,0.0f));
+	group->flushBufferedParticles();
+
+	return system;
+}
+
+double benchmark(size_t nbParticles,bool fused,bool split,bool parallel)
+{
+	SPK::Ref<SPK::System> system = createSystem(nbParticles,fused,split,parallel);
+
+	double start = getTime();
+	for (size_t i = 0; i < NB_UPDATES; ++i)
+		system->updateParticles(DELTA_TIME);
+	double end = getTime();
+
+	return (end - start) * 1.0e9 / (static_cast<double>(nbParticles) * NB_UPDATES);
+}
+
+void printResult(const std::string& name,double time,bool fused)
+{
+	std::cout << std::setw(28) << std::left << name
+		<< std::setw(24) << std::fixed << std::setprecision(2) << time
+		<< computeTrafficPerParticle(fused) << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t nbParticles = DEFAULT_NB_PARTICLES;
+	if (argc > 1)
+		nbParticles = std::strtoul(argv[1],NULL,10);
+
+	SPK::System::setClampStep(false);
+	SPK::System::useRealStep();
+
+	std::cout << "SPARK update benchmark - " << nbParticles << " particles - " << NB_UPDATES << " updates" << std::endl;
+	std::cout << std::endl;
+	std::cout << std::setw(28) << std::left << "update"
+		<< std::setw(24) << "time/particle (ns)"
+		<< "estimated traffic/particle (bytes)" << std::endl;
+
+	for (int split = 0; split < 2; ++split)
+		for (int fused = 0; fused < 2; ++fused)
+		{
+			std::string name = fused != 0 ? "tile by tile" : "stage by stage";
+			if (split != 0)
+				name += " (split)";
+			printResult(name,benchmark(nbParticles,fused != 0,split != 0,false),fused != 0);
+		}
+
+	SPK::ThreadPool* threadPool = SPK_NEW(SPK::ThreadPool);
+	SPK::SPKContext::get().setTaskScheduler(threadPool);
+	std::cout << std::endl << "parallel update - " << threadPool->getNbWorkers() + 1 << " threads" << std::endl;
+	for (int fused = 0; fused < 2; ++fused)
+		printResult(fused != 0 ? "tile by tile" : "stage by stage",benchmark(nbParticles,fused != 0,false,true),fused != 0);
+	SPK::SPKContext::get().setTaskScheduler(NULL);
+	SPK_DELETE(threadPool);
+
+	std::cout << std::endl << "The traffic is estimated from the columns read and written by each stage, it is not measured." << std::endl;
+
+	SPK_DUMP_MEMORY
+
+	return 0;
+}
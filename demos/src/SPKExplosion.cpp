@@ -49,6 +49,7 @@ float screenRatio;
 typedef std::list<SPK::Ref<SPK::System> > SystemList;
 SystemList particleSystems;
 SPK::Ref<SPK::System> baseSystem;
+SPK::SystemPool* explosionPool = NULL;
 
 const float PI = 3.14159f;
 
@@ -432,11 +433,10 @@ SPK::Ref<SPK::System> createParticleSystemBase(GLuint textureExplosion,GLuint te
 // Creates a particle system from the base system
 SPK::Ref<SPK::System> createParticleSystem(const SPK::Vector3D& pos)
 {
-	// Creates a copy of the base system
-	SPK::Ref<SPK::System> system = SPK::SPKObject::copy(baseSystem);
+	// Gets an instance of the base system from the pool (copied only if none is available)
+	SPK::Ref<SPK::System> system = explosionPool->acquire();
 
 	// Locates the system at the given position
-	system->initialize();
 	system->getTransform().setPosition(pos);
 	system->updateTransform(); // updates the world transform of system and its children
 	system->enableAABBComputation(enableBB);
@@ -503,6 +503,7 @@ int main(int argc, char *argv[])
 
 	// creates the base system
 	baseSystem = createParticleSystemBase(textureExplosion,textureFlash,textureSpark1,textureSpark2,textureWave);
+	explosionPool = SPK_NEW(SPK::SystemPool,baseSystem,16);
 	
 	bool exit = false;
 	bool paused = false;
@@ -602,7 +603,8 @@ int main(int argc, char *argv[])
 				// Updates the particle systems
 				if (!(*it)->updateParticles(deltaTime * 0.001f))
 				{
-					// And erases its entry in the container
+					// And gives it back to the pool and erases its entry in the container
+					explosionPool->release(*it);
 					it = particleSystems.erase(it);
 				}
 				else
@@ -628,6 +630,7 @@ int main(int argc, char *argv[])
 	
 	SPK_DUMP_MEMORY
 	particleSystems.clear();
+	SPK_DELETE(explosionPool);
 	baseSystem = SPK_NULL_REF;
 	SPK_DUMP_MEMORY
 
@@ -636,4 +639,4 @@ int main(int argc, char *argv[])
 	system("pause"); // Waits for the user to close the console
 
 	return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -22,9 +22,12 @@
 #ifndef H_SPK_ACTION
 #define H_SPK_ACTION
 
+#include <vector>
+
 namespace SPK
 {
 	class Particle;
+	class Group;
 
 	/**
 	* @brief An abstract class that allows to perform an action on a single particle
@@ -59,6 +62,15 @@ namespace SPK
 		*/
 		virtual void apply(Particle& particle) const = 0;
 
+		/**
+		* @brief Gets the groups this action adds particles to
+		* When the groups of a system are updated concurrently, the target groups are updated after the group triggering the action
+		* and on the same thread (see System::enableParallelUpdate(bool)).<br>
+		* Actions adding particles to other groups must therefore override this method.
+		* @param targets : the vector to which the target groups are appended
+		*/
+		virtual void getTargetGroups(std::vector<Group*>& targets) const {}
+
 	public :
 		spark_description(Action, SPKObject)
 		(
@@ -107,6 +107,9 @@ namespace SPK
 		~ArrayData<T>();
 
 		virtual void swap(size_t index0,size_t index1);
+		virtual void compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles);
+		virtual bool resize(size_t capacity,size_t nbParticles);
+		virtual bool copyData(const Data& data,size_t nbParticles);
 	};
 
 	typedef ArrayData<float>	FloatArrayData;		/**< @brief ArrayData holding floats */
@@ -184,6 +187,34 @@ namespace SPK
 		for (size_t i = 0; i < sizePerParticle; ++i)
 			std::swap(data[index0 + i],data[index1 + i]);
 	}
+
+	template<typename T>
+	inline void ArrayData<T>::compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles)
+	{
+		compactArray(data,sizePerParticle,deadIndices,nbDead,nbParticles);
+	}
+
+	template<typename T>
+	inline bool ArrayData<T>::resize(size_t capacity,size_t nbParticles)
+	{
+		T* oldData = data;
+		totalSize = capacity * sizePerParticle;
+		data = SPK_NEW_ARRAY(T,totalSize);
+		std::copy(oldData,oldData + nbParticles * sizePerParticle,data);
+		SPK_DELETE_ARRAY(oldData);
+		return true;
+	}
+
+	template<typename T>
+	inline bool ArrayData<T>::copyData(const Data& data,size_t nbParticles)
+	{
+		const ArrayData<T>& arrayData = static_cast<const ArrayData<T>&>(data);
+		if (arrayData.sizePerParticle != sizePerParticle || nbParticles * sizePerParticle > totalSize)
+			return false;
+
+		std::copy(arrayData.data,arrayData.data + nbParticles * sizePerParticle,this->data);
+		return true;
+	}
 }
 
 #endif
@@ -0,0 +1,212 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_BUDGETMANAGER
+#define H_SPK_BUDGETMANAGER
+
+#include <vector>
+
+namespace SPK
+{
+	/**
+	* @brief A manager enforcing a global budget on a set of systems
+	*
+	* The manager updates its systems and enforces two budgets on them :<br>
+	* <ul>
+	* <li>A maximum number of particles shared by all the groups of the systems</li>
+	* <li>A maximum time spent updating the systems</li>
+	* </ul>
+	* At each update, the groups are ranked by the priority of their system, then by their own priority and then by the distance of their system to the camera.
+	* The particles are granted to the groups in that order : the groups ranked last have their births refused
+	* and their particles with the lowest energy dropped first (see Group::setParticleBudget(size_t)).<br>
+	* The particles alive are granted first. The births left in the budget are then reserved in the same order
+	* for the births requested by each group (see Group::getNbRequestedBirths(float)) so that the budgets of all the groups never exceed the maximum.<br>
+	* <br>
+	* When the update takes longer than the time budget, the flows of the emitters and the budget of particles are scaled down (see Group::setEmissionScale(float)).
+	* They are scaled back up progressively once the update fits in the time budget.
+	*/
+	class SPK_PREFIX BudgetManager
+	{
+	public :
+
+		/**
+		* @brief Constructor of budget manager
+		* @param maxParticles : the maximum number of particles of all the systems or 0 for no maximum
+		* @param maxUpdateTime : the maximum time in seconds spent updating the systems or 0 for no maximum
+		*/
+		BudgetManager(size_t maxParticles = 0,float maxUpdateTime = 0.0f);
+
+		/** @brief Destructor of budget manager */
+		~BudgetManager();
+
+		/**
+		* @brief Adds a system to this manager
+		* @param system : the system to add
+		*/
+		void addSystem(const Ref<System>& system);
+
+		/**
+		* @brief Removes a system from this manager
+		* The budget and the emission scale of the groups of the system are reset.
+		* @param system : the system to remove
+		*/
+		void removeSystem(const Ref<System>& system);
+
+		/** @brief Removes all the systems from this manager */
+		void removeAllSystems();
+
+		/**
+		* @brief Gets the number of systems of this manager
+		* @return the number of systems
+		*/
+		size_t getNbSystems() const;
+
+		/**
+		* @brief Gets a system of this manager
+		* @param index : the index of the system
+		* @return the system
+		*/
+		const Ref<System>& getSystem(size_t index) const;
+
+		/**
+		* @brief Sets the maximum number of particles of all the systems
+		* @param maxParticles : the maximum number of particles or 0 for no maximum
+		*/
+		void setMaxParticles(size_t maxParticles);
+
+		/**
+		* @brief Gets the maximum number of particles of all the systems
+		* @return the maximum number of particles or 0 if there is no maximum
+		*/
+		size_t getMaxParticles() const;
+
+		/**
+		* @brief Sets the maximum time spent updating the systems
+		* @param maxUpdateTime : the maximum time in seconds or 0 for no maximum
+		*/
+		void setMaxUpdateTime(float maxUpdateTime);
+
+		/**
+		* @brief Gets the maximum time spent updating the systems
+		* @return the maximum time in seconds or 0 if there is no maximum
+		*/
+		float getMaxUpdateTime() const;
+
+		/**
+		* @brief Gets the scale currently applied to the flows of the emitters and to the budget of particles
+		* @return the current scale within ]0,1]
+		*/
+		float getEmissionScale() const;
+
+		/**
+		* @brief Gets the time spent by the last update of the systems
+		* @return the time in seconds
+		*/
+		float getLastUpdateTime() const;
+
+		/**
+		* @brief Gets the number of particles of all the systems
+		* @return the number of particles
+		*/
+		size_t getNbParticles() const;
+
+		/**
+		* @brief Distributes the budget to the groups and updates all the systems
+		* @param deltaTime : the time step
+		*/
+		void updateSystems(float deltaTime);
+
+		/** @brief Renders all the systems */
+		void renderSystems() const;
+
+	private :
+
+		// A group ranked for the distribution of the budget
+		struct RankedGroup
+		{
+			Group* group;
+			size_t nbGranted; // Number of particles alive granted to the group
+			int systemPriority;
+			int groupPriority;
+			float sqrDist;
+
+			bool operator<(const RankedGroup& rankedGroup) const;
+		};
+
+		std::vector<Ref<System> > systems;
+		std::vector<RankedGroup> rankedGroups;
+
+		size_t maxParticles;
+		float maxUpdateTime;
+		float emissionScale;
+		float lastUpdateTime;
+
+		void distributeBudget(float deltaTime);
+
+		static void resetBudget(const Ref<System>& system);
+
+		BudgetManager(const BudgetManager&); // Not used
+		BudgetManager& operator=(const BudgetManager&); // Not used
+	};
+
+	inline BudgetManager::~BudgetManager()
+	{
+		removeAllSystems();
+	}
+
+	inline size_t BudgetManager::getNbSystems() const
+	{
+		return systems.size();
+	}
+
+	inline const Ref<System>& BudgetManager::getSystem(size_t index) const
+	{
+		SPK_ASSERT(index < systems.size(),"BudgetManager::getSystem(size_t) - Index of system is out of bounds : " << index);
+		return systems[index];
+	}
+
+	inline void BudgetManager::setMaxParticles(size_t maxParticles)
+	{
+		this->maxParticles = maxParticles;
+	}
+
+	inline size_t BudgetManager::getMaxParticles() const
+	{
+		return maxParticles;
+	}
+
+	inline float BudgetManager::getMaxUpdateTime() const
+	{
+		return maxUpdateTime;
+	}
+
+	inline float BudgetManager::getEmissionScale() const
+	{
+		return emissionScale;
+	}
+
+	inline float BudgetManager::getLastUpdateTime() const
+	{
+		return lastUpdateTime;
+	}
+}
+
+#endif
@@ -426,6 +426,17 @@ namespace SPK
 			generateRandom(c0.getB(),c1.getB()),
 			generateRandom(c0.getA(),c1.getA()));
 	}
+
+	template<>
+	inline Color RandomStream::generate(const Color& c0,const Color& c1)
+	{
+		// The components are generated in order (arguments evaluation order is unspecified)
+		int r = generate(c0.getR(),c1.getR());
+		int g = generate(c0.getG(),c1.getG());
+		int b = generate(c0.getB(),c1.getB());
+		int a = generate(c0.getA(),c1.getA());
+		return Color(r,g,b,a);
+	}
 }
 
 #endif
@@ -0,0 +1,38 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef H_SPK_CONFIG
+#define H_SPK_CONFIG
+
+// This file holds the options that change the layout of the classes of SPARK.
+// They must be the same when building the library and the applications using it, so they are only set here.
+
+// Uncomment this to build SPARK without the C++11 thread library (thread pools have no worker then)
+// Note: this is required with compilers not supporting C++11
+// #define SPK_NO_THREADS
+
+// Uncomment this to count the references of objects atomically, so that references to an object can be taken and released from several threads at once
+// Note: this is not needed to update the systems of a World, whose update does not take nor release references to the objects shared by its systems
+// Note: this requires the C++11 thread library
+// #define SPK_ATOMIC_REFERENCES
+
+#endif
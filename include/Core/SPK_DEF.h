@@ -24,6 +24,10 @@
 
 #include <cstdlib>
 #include <climits>
+#include <cmath>
+#include <limits>
+
+#include "Core/SPK_Config.h"
 
 // for windows platform only
 #if defined(WIN32) || defined(_WIN32)
@@ -47,13 +51,34 @@
 #define SPK_PREFIX
 #endif
 
+// Threads are used unless SPK_NO_THREADS is defined in SPK_Config.h (the language version is not checked so that the library and the applications always agree)
+#ifndef SPK_NO_THREADS
+#define SPK_THREADS
+#endif
+
+#ifdef SPK_THREADS
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define SPK_THREAD_LOCAL __declspec(thread)
+#else
+#define SPK_THREAD_LOCAL thread_local
+#endif
+#else
+#define SPK_THREAD_LOCAL
+#endif
+
+// The current random stream is read inline unless it is thread local within a DLL, as Windows cannot export thread local data
+#if !defined(SPK_THREADS) || !(defined(WIN32) || defined(_WIN32)) || !(defined(SPK_CORE_EXPORT) || defined(SPK_IMPORT) || defined(SPK_CORE_IMPORT))
+#define SPK_INLINE_RANDOM_STREAM
+#endif
+
 #include "Core/SPK_MemoryTracer.h"
 #include "Core/SPK_Reference.h"
 #include "Core/SPK_Enum.h"
 
 /**
 * @brief A macro returning a random value within [min,max[
-* This is a shortcut syntax to <i>SPK::SPKContext::get().generateRandom(min,max)</i>
+* This is a shortcut syntax to <i>SPK::SPKContext::get().generateRandom(min,max)</i><br>
+* The value is drawn from the current random stream (the one of the group being updated or the global one, see SPKContext::getRandomStream()).
 * @param min : the minimum bound of the interval (inclusive)
 * @param max : the maximum bound of the interval (exclusive)
 * @return a random number within [min,max[
@@ -97,6 +122,7 @@ namespace SPK
 #endif
 
 	class Zone;
+	class TaskScheduler;
 
 #ifdef SPK_DOXYGEN_ONLY // for documentation purpose only
 
@@ -195,6 +221,117 @@ namespace SPK
 
 	SPK_DECLARE_ENUM(ConnectionStatus, SPK_ENUM_CONNECTION_STATUS)
 
+	/**
+	* @brief A counter based stream of random numbers
+	*
+	* The n-th number of a stream is a hash of its seed and of n. Therefore numbers can be generated in any order or in bulk
+	* (see fill(float*,size_t,float,float)) and several streams are independent from each other.<br>
+	* Each group has its own stream, seeded by its system (see System::setSeed(unsigned int)), so that the particles of a group do not depend
+	* on the update of the other groups.
+	*/
+	class SPK_PREFIX RandomStream
+	{
+	public :
+
+		/**
+		* @brief Constructor of random stream
+		* @param seed : the seed of the stream
+		*/
+		RandomStream(uint32 seed = 0);
+
+		/**
+		* @brief Sets the seed of this stream
+		* The stream is restarted from its first number.
+		* @param seed : the seed of the stream
+		*/
+		void setSeed(uint32 seed);
+
+		/**
+		* @brief Gets the seed of this stream
+		* @return the seed of the stream
+		*/
+		uint32 getSeed() const;
+
+		/**
+		* @brief Sets the index of the next number of this stream
+		* @param counter : the index of the next number
+		*/
+		void setCounter(uint32 counter);
+
+		/**
+		* @brief Gets the index of the next number of this stream
+		* @return the index of the next number
+		*/
+		uint32 getCounter() const;
+
+		/**
+		* @brief Gets the next 32 bits random integer of this stream
+		* @return a random integer
+		*/
+		uint32 generateUint();
+
+		/**
+		* @brief Gets the next random value within the interval [min,max[
+		* @param min : the minimum bound of the interval (inclusive)
+		* @param max : the maximum bound of the interval (exclusive)
+		* @return a random value within [min,max[
+		*/
+		template<typename T>
+		T generate(const T& min,const T& max);
+
+		/**
+		* @brief Fills an array with the next random floats within the interval [min,max[
+		* The array holds the same values than nb successive calls to generate(const T&,const T&) but is filled with SIMD instructions when available.
+		* @param values : the array to fill
+		* @param nb : the number of values to generate
+		* @param min : the minimum bound of the interval (inclusive)
+		* @param max : the maximum bound of the interval (exclusive)
+		*/
+		void fill(float* values,size_t nb,float min,float max);
+
+		/**
+		* @brief Fills an array with the next random values within the interval [min,max[
+		* @param values : the array to fill
+		* @param nb : the number of values to generate
+		* @param min : the minimum bound of the interval (inclusive)
+		* @param max : the maximum bound of the interval (exclusive)
+		*/
+		template<typename T>
+		void fill(T* values,size_t nb,const T& min,const T& max);
+
+		/**
+		* @brief Hashes a 32 bits integer
+		* @param value : the value to hash
+		* @return the hashed value
+		*/
+		static uint32 hash(uint32 value);
+
+		/**
+		* @brief Gets the number at a given index of a stream
+		* @param key : the key of the stream (the hash of its seed)
+		* @param counter : the index of the number
+		* @return the random integer
+		*/
+		static uint32 generateUint(uint32 key,uint32 counter);
+
+		/**
+		* @brief Converts a random integer to a float within [0,1[
+		* @param value : the random integer
+		* @return a float within [0,1[
+		*/
+		static float toUnit(uint32 value);
+
+	private :
+
+		// Converts a random integer to a value within [min,max[
+		template<typename T,bool INTEGER = std::numeric_limits<T>::is_integer>
+		struct Converter;
+
+		uint32 seed;
+		uint32 key;
+		uint32 counter;
+	};
+
 	/** A singleton class that holds some static objects needed by SPARK */
 	class SPK_PREFIX SPKContext
 	{
@@ -225,10 +362,53 @@ namespace SPK
 		template<typename T>
 		T generateRandom(const T& min,const T& max);
 
+		/**
+		* @brief Gets the random stream used by SPK_RANDOM on the calling thread
+		* During the sequential phases of its update (births, deaths, modifiers...), a group makes its own stream the current one.
+		* The workers of a ThreadPool have their own stream otherwise. On the other threads, the global stream of the context is used :
+		* it is not thread safe, so the threads of another scheduler must set their own stream with setCurrentRandomStream(RandomStream*).
+		* @return the current random stream
+		*/
+		RandomStream& getRandomStream();
+
+		/**
+		* @brief Sets the random stream used by SPK_RANDOM on the calling thread
+		* This is used by the groups during their update. The stream must remain valid while it is current.
+		* @param stream : the stream to use or NULL to use the global stream of the context
+		* @return the previous stream or NULL if it was the global stream
+		*/
+		RandomStream* setCurrentRandomStream(RandomStream* stream);
+
+		/**
+		* @brief Sets the seed of the global random stream
+		* By default, the global stream is seeded with the time at start up.
+		* @param seed : the seed of the global stream
+		*/
+		void setRandomSeed(uint32 seed);
+
+		/**
+		* @brief Sets the scheduler used to update groups and systems in parallel
+		* The scheduler (a ThreadPool or the job system of an engine) is not owned by the context and must remain valid while it is set.<br>
+		* By default, there is no scheduler and everything is updated on the calling thread.
+		* @param taskScheduler : the scheduler or NULL to update everything on the calling thread
+		*/
+		void setTaskScheduler(TaskScheduler* taskScheduler);
+
+		/**
+		* @brief Gets the scheduler used to update groups and systems in parallel
+		* @return the scheduler or NULL if there is none
+		*/
+		TaskScheduler* getTaskScheduler() const;
+
 	private :
 
+#ifdef SPK_INLINE_RANDOM_STREAM
+		static SPK_THREAD_LOCAL RandomStream* currentRandomStream; // The stream used by SPK_RANDOM on each thread (NULL for the global stream)
+#endif
+
 		Ref<Zone> defaultZone;
-		unsigned int randomSeed;
+		RandomStream randomStream;
+		TaskScheduler* taskScheduler;
 
 		SPKContext();
 		~SPKContext();
@@ -237,23 +417,119 @@ namespace SPK
 		SPKContext& operator=(const SPKContext&); // Not used
 	};
 
+	inline void SPKContext::setTaskScheduler(TaskScheduler* taskScheduler)
+	{
+		this->taskScheduler = taskScheduler;
+	}
+
+	inline TaskScheduler* SPKContext::getTaskScheduler() const
+	{
+		return taskScheduler;
+	}
+
+	inline void SPKContext::setRandomSeed(uint32 seed)
+	{
+		randomStream.setSeed(seed);
+	}
+
+#ifdef SPK_INLINE_RANDOM_STREAM
+	inline RandomStream& SPKContext::getRandomStream()
+	{
+		return currentRandomStream != NULL ? *currentRandomStream : randomStream;
+	}
+#endif
+
 	template<typename T>
 	inline T SPKContext::generateRandom(const T& min,const T& max)
 	{
-		// optimized standard minimal
-		long tmp0 = 16807L * (randomSeed & 0xFFFFL);
-		long tmp1 = 16807L * (randomSeed >> 16);
-		long tmp2 = (tmp0 >> 16) + tmp1;
-		tmp0 = ((tmp0 & 0xFFFF)|((tmp2 & 0x7FFF) << 16)) + (tmp2 >> 15);
+		return getRandomStream().generate(min,max);
+	}
+
+	inline RandomStream::RandomStream(uint32 seed)
+	{
+		setSeed(seed);
+	}
+
+	inline void RandomStream::setSeed(uint32 seed)
+	{
+		this->seed = seed;
+		key = hash(seed);
+		counter = 0;
+	}
 
-		// correction of the error
-		if ((tmp0 & 0x80000000L) != 0)
-			tmp0 = (tmp0 + 1) & 0x7FFFFFFFL;
+	inline uint32 RandomStream::getSeed() const
+	{
+		return seed;
+	}
 
-		randomSeed = tmp0;
+	inline void RandomStream::setCounter(uint32 counter)
+	{
+		this->counter = counter;
+	}
 
-		// find a random number in the interval
-		return static_cast<T>(min + ((randomSeed - 1) / 2147483646.0) * (max - min));
+	inline uint32 RandomStream::getCounter() const
+	{
+		return counter;
+	}
+
+	inline uint32 RandomStream::generateUint()
+	{
+		return generateUint(key,counter++);
+	}
+
+	template<typename T,bool INTEGER>
+	struct RandomStream::Converter
+	{
+		static T convert(uint32 value,const T& min,const T& max)
+		{
+			return static_cast<T>(min + toUnit(value) * (max - min));
+		}
+	};
+
+	// Integers use a double unit value as a float one could round up to max for intervals wider than 2^24
+	template<typename T>
+	struct RandomStream::Converter<T,true>
+	{
+		static T convert(uint32 value,const T& min,const T& max)
+		{
+			double offset = std::floor(value * (1.0 / 4294967296.0) * (static_cast<double>(max) - static_cast<double>(min)));
+			return static_cast<T>(static_cast<double>(min) + offset);
+		}
+	};
+
+	template<typename T>
+	inline T RandomStream::generate(const T& min,const T& max)
+	{
+		return Converter<T>::convert(generateUint(),min,max);
+	}
+
+	template<typename T>
+	void RandomStream::fill(T* values,size_t nb,const T& min,const T& max)
+	{
+		for (size_t i = 0; i < nb; ++i)
+			values[i] = generate(min,max);
+	}
+
+	inline uint32 RandomStream::hash(uint32 value)
+	{
+		// lowbias32 integer hash
+		value ^= value >> 16;
+		value *= 0x7FEB352DU;
+		value ^= value >> 15;
+		value *= 0x846CA68BU;
+		value ^= value >> 16;
+		return value;
+	}
+
+	inline uint32 RandomStream::generateUint(uint32 key,uint32 counter)
+	{
+		return hash(hash(counter ^ key) + key);
+	}
+
+	inline float RandomStream::toUnit(uint32 value)
+	{
+		// The 24 upper bits fit exactly in the mantissa of a float
+		return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
 	}
 }
 
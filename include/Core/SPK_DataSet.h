@@ -22,6 +22,8 @@
 #ifndef H_SPK_DATASET
 #define H_SPK_DATASET
 
+#include <algorithm> // for std::copy
+
 /**
 * @brief A convenience macro to get a Data of a given type from a Dataset
 * @param type : type of the data (used to cast the data)
@@ -65,6 +67,18 @@ namespace SPK
 		Data();
 		virtual  ~Data() {}
 
+		/**
+		* @brief Removes the elements of dead particles from an array holding a fixed number of elements per particle
+		* The elements of the remaining particles are kept in order and moved in bulk, run by run, at the beginning of the array.
+		* @param array : the array to compact
+		* @param sizePerParticle : the number of elements per particle
+		* @param deadIndices : the sorted indices of the dead particles
+		* @param nbDead : the number of dead particles (must be strictly positive)
+		* @param nbParticles : the number of particles before the compaction
+		*/
+		template<typename T>
+		static void compactArray(T* array,size_t sizePerParticle,const size_t* deadIndices,size_t nbDead,size_t nbParticles);
+
 	private :
 
 		long flag;
@@ -76,6 +90,36 @@ namespace SPK
 		* @param index1 : index of the second particle
 		*/
 		virtual void swap(size_t index0,size_t index1) = 0;
+
+		/**
+		* @brief Removes the additional data of dead particles
+		* The data of the remaining particles is kept in order and packed at the beginning.<br>
+		* The default implementation relies on swap(size_t,size_t) and can be overridden to move the data in bulk.
+		* @param deadIndices : the sorted indices of the dead particles
+		* @param nbDead : the number of dead particles (must be strictly positive)
+		* @param nbParticles : the number of particles before the compaction
+		*/
+		virtual void compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles);
+
+		/**
+		* @brief Resizes the data to hold the given number of particles
+		* The data of the first nbParticles particles must be kept.<br>
+		* The default implementation returns false, in which case the data is destroyed and created again by its DataHandler.
+		* @param capacity : the new maximum number of particles
+		* @param nbParticles : the number of particles whose data must be kept
+		* @return true if the data was resized, false if not
+		*/
+		virtual bool resize(size_t capacity,size_t nbParticles);
+
+		/**
+		* @brief Copies the additional data of particles from a data of the same type
+		* This is used by the asynchronous update to bring the data of a group up to date from its render state (see System::enableAsyncUpdate(bool)).<br>
+		* The default implementation returns false, in which case the data is created again by its DataHandler without the values of the particles.
+		* @param data : the data to copy from, created by the same DataHandler for a group of the same capacity
+		* @param nbParticles : the number of particles whose data must be copied
+		* @return true if the data was copied, false if not
+		*/
+		virtual bool copyData(const Data& data,size_t nbParticles);
 	};
 
 	/**
@@ -148,6 +192,10 @@ namespace SPK
 
 		void setInitialized();
 		void swap(size_t index0,size_t index1);
+		void compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles);
+		bool resize(size_t capacity,size_t nbParticles);
+		void copy(const DataSet& dataSet,size_t nbParticles);
+		void swapData(DataSet& dataSet);
 	};
 
 	inline Data::Data() :
@@ -164,6 +212,39 @@ namespace SPK
 		return flag;
 	}
 
+	template<typename T>
+	void Data::compactArray(T* array,size_t sizePerParticle,const size_t* deadIndices,size_t nbDead,size_t nbParticles)
+	{
+		T* dst = array + deadIndices[0] * sizePerParticle;
+		for (size_t i = 0; i < nbDead; ++i)
+		{
+			size_t runEnd = i + 1 < nbDead ? deadIndices[i + 1] : nbParticles;
+			dst = std::copy(array + (deadIndices[i] + 1) * sizePerParticle,array + runEnd * sizePerParticle,dst);
+		}
+	}
+
+	inline void Data::compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles)
+	{
+		// The particles between 2 dead particles are swapped one by one with the first free slot
+		size_t dst = deadIndices[0];
+		for (size_t i = 0; i < nbDead; ++i)
+		{
+			size_t runEnd = i + 1 < nbDead ? deadIndices[i + 1] : nbParticles;
+			for (size_t src = deadIndices[i] + 1; src < runEnd; ++src)
+				swap(dst++,src);
+		}
+	}
+
+	inline bool Data::resize(size_t,size_t)
+	{
+		return false;
+	}
+
+	inline bool Data::copyData(const Data&,size_t)
+	{
+		return false;
+	}
+
 	inline DataSet::DataSet() :
 		nbData(0),
 		initialized(false),
@@ -204,7 +285,15 @@ namespace SPK
 	inline void DataSet::swap(size_t index0,size_t index1)
 	{
 		for (size_t i = 0; i < nbData; ++i)
-			dataArray[i]->swap(index0,index1);
+			if (dataArray[i] != NULL)
+				dataArray[i]->swap(index0,index1);
+	}
+
+	inline void DataSet::compact(const size_t* deadIndices,size_t nbDead,size_t nbParticles)
+	{
+		for (size_t i = 0; i < nbData; ++i)
+			if (dataArray[i] != NULL)
+				dataArray[i]->compact(deadIndices,nbDead,nbParticles);
 	}
 };
 
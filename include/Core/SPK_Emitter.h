@@ -243,10 +243,11 @@ namespace SPK
 
 		mutable float fraction;
 		
-		void emit(Particle& particle) const;
+		void emitRange(Group& group,size_t start,size_t end) const;
 
 		size_t updateTankFromTime(float deltaTime);
 		size_t updateTankFromNb(size_t nb);
+		size_t getNbBornFromTime(float deltaTime) const; // The number of births updateTankFromTime(float) would return
 
 		/**
 		* @brief Gives the particle an initial velocity
@@ -259,6 +260,28 @@ namespace SPK
 		* @param speed : the desired speed of the particle
 		*/
 		virtual void generateVelocity(Particle& particle,float speed) const = 0;
+
+		/**
+		* @brief Gives the particles of a group within [start,end[ an initial velocity
+		*
+		* The speed of each particle is derived from the force of the emitter and the mass of the particle (see generateSpeed(const Particle&)).<br>
+		* The default implementation calls generateVelocity(Particle&,float) for each particle
+		* and can be overriden to initialize a burst of particles at once.
+		*
+		* @param group : the group of particles
+		* @param start : the index of the first particle
+		* @param end : the index following the last particle
+		*/
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
+
+	protected :
+
+		/**
+		* @brief Generates a random speed for the given particle
+		* @param particle : the particle to launch
+		* @return a speed derived from the force range of this emitter and the mass of the particle
+		*/
+		float generateSpeed(const Particle& particle) const;
 	};
 
 	inline void Emitter::setActive(bool active)
@@ -360,6 +383,20 @@ namespace SPK
 		return nbBorn;
 	}
 
+	inline size_t Emitter::getNbBornFromTime(float deltaTime) const
+	{
+		if (deltaTime < 0.0f || currentTank == 0)
+			return 0;
+
+		if (flow < 0.0f)
+			return currentTank > 0 ? currentTank : 0;
+
+		size_t nbBorn = static_cast<size_t>(fraction + flow * deltaTime);
+		if (currentTank > 0 && nbBorn > static_cast<size_t>(currentTank))
+			nbBorn = currentTank;
+		return nbBorn;
+	}
+
 	inline size_t  Emitter::updateTankFromNb(size_t nb)
 	{
 		if (currentTank < 0)
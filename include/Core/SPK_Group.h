@@ -100,6 +100,63 @@ namespace SPK
 		void reallocate(size_t capacity);
 		void empty();
 
+		/**
+		* @brief Enables or disables the elastic capacity of the group
+		*
+		* An elastic group grows its capacity when more particles are born than it can hold instead of dropping them.
+		* The capacity is multiplied by the growth factor, without exceeding the maximum capacity.<br>
+		* Once the number of particles stays below the capacity divided by the square of the growth factor for the shrink delay,
+		* the capacity shrinks back to the number of particles times the growth factor, but never below the capacity set with reallocate(size_t).<br>
+		* <br>
+		* Particles are kept when the capacity changes and the additional data of the group is resized in place.
+		* Only data that cannot be resized (see Data::resize(size_t,size_t)) is created again.
+		*
+		* @param elastic : true to enable the elastic capacity, false to disable it
+		*/
+		void enableElasticCapacity(bool elastic);
+
+		/**
+		* @brief Tells whether the elastic capacity is enabled or not
+		* @return true if the elastic capacity is enabled, false if not
+		*/
+		bool isElasticCapacityEnabled() const;
+
+		/**
+		* @brief Sets the factor by which the capacity of an elastic group grows
+		* @param growthFactor : the growth factor (must be greater than 1)
+		*/
+		void setGrowthFactor(float growthFactor);
+
+		/**
+		* @brief Gets the factor by which the capacity of an elastic group grows
+		* @return the growth factor
+		*/
+		float getGrowthFactor() const;
+
+		/**
+		* @brief Sets the capacity an elastic group cannot grow beyond
+		* @param maxCapacity : the maximum capacity or 0 for no maximum
+		*/
+		void setMaxCapacity(unsigned int maxCapacity);
+
+		/**
+		* @brief Gets the capacity an elastic group cannot grow beyond
+		* @return the maximum capacity or 0 if there is no maximum
+		*/
+		unsigned int getMaxCapacity() const;
+
+		/**
+		* @brief Sets the time an elastic group must stay underpopulated before its capacity shrinks
+		* @param shrinkDelay : the shrink delay in seconds
+		*/
+		void setShrinkDelay(float shrinkDelay);
+
+		/**
+		* @brief Gets the time an elastic group must stay underpopulated before its capacity shrinks
+		* @return the shrink delay in seconds
+		*/
+		float getShrinkDelay() const;
+
 		void addEmitter(const Ref<Emitter>& emitter);
 		void removeEmitter(const Ref<Emitter>& emitter);
 		void removeAllEmitters();
@@ -121,6 +178,148 @@ namespace SPK
 		void enableSorting(bool sorting);
 		bool isSortingEnabled() const;
 
+		/**
+		* @brief Enables or disables the sorting of the group by index
+		*
+		* When enabled, a sorted group does not move its particles anymore.
+		* Instead, the indices of the particles are radix sorted from the farthest to the nearest one into a permutation buffer.
+		* Renderers draw particles in that order (see ConstSortedGroupIterator).<br>
+		* The order of the previous update is kept from an update to another so that a nearly sorted order is only refined.<br>
+		* <br>
+		* Note that the sorting must be enabled for this option to be taken into account (see enableSorting(bool)).
+		*
+		* @param indexSorting : true to sort the indices of the particles, false to sort the particles themselves
+		*/
+		void enableIndexSorting(bool indexSorting);
+
+		/**
+		* @brief Tells whether the sorting by index is enabled or not
+		* @return true if the sorting by index is enabled, false if not
+		*/
+		bool isIndexSortingEnabled() const;
+
+		/**
+		* @brief Gets the indices of the particles sorted from the farthest to the nearest one
+		*
+		* The order is only available if the group is sorted by index and if it is up to date with the particles of the group.<br>
+		* In that case the returned array holds getNbParticles() indices.
+		*
+		* @return the sorted indices of the particles or NULL if there are not available
+		*/
+		const unsigned int* getSortedIndices() const;
+
+		/**
+		* @brief Enables or disables the fused update of the group
+		*
+		* When the fused update is enabled, particles are updated tile by tile instead of stage by stage.<br>
+		* Within a tile, ages, energies, positions, interpolated parameters, modifiers supporting ranges and distances to the camera
+		* are computed one after the other while the data of the tile is still in cache.<br>
+		* Stages that cannot be fused (interpolators or modifiers not supporting ranges, modifiers needing the neighbor structure...) are performed
+		* afterwards on the whole group, so that the order of the stages remains the same than with the default update.
+		*
+		* @param fused : true to enable the fused update, false to disable it
+		*/
+		void enableFusedUpdate(bool fused);
+
+		/**
+		* @brief Tells whether the fused update is enabled or not
+		* @return true if the fused update is enabled, false if not
+		*/
+		bool isFusedUpdateEnabled() const;
+
+		/**
+		* @brief Sets the number of particles per tile used by the fused update
+		* The tile size should be chosen so that the data of a tile fits in the L1 cache.
+		* @param tileSize : the number of particles per tile
+		*/
+		void setTileSize(unsigned int tileSize);
+
+		/**
+		* @brief Gets the number of particles per tile used by the fused update
+		* @return the number of particles per tile
+		*/
+		unsigned int getTileSize() const;
+
+		/**
+		* @brief Enables or disables the split storage of the group
+		*
+		* With split storage, positions, velocities and old positions are stored as separate x, y and z arrays of floats,
+		* aligned and padded to the SIMD width, so that integration, distance and AABB computations are vectorized.<br>
+		* The arrays of Vector3D remain available through Particle::position(), getPositionAddress()... as a view of the split arrays.
+		* This view is gathered whenever it is accessed after the split arrays were modified
+		* and modifications made through it are copied back before the next vectorized computation.<br>
+		* <br>
+		* Split storage is therefore worth it for groups whose modifiers and renderer seldom access particles vectors.
+		*
+		* @param split : true to enable the split storage, false to disable it
+		*/
+		void enableSplitStorage(bool split);
+
+		/**
+		* @brief Tells whether the split storage is enabled or not
+		* @return true if the split storage is enabled, false if not
+		*/
+		bool isSplitStorageEnabled() const;
+
+		/**
+		* @brief Enables or disables the parallel update of the group
+		*
+		* When the parallel update is enabled and a scheduler is set in the context (see SPKContext::setTaskScheduler(TaskScheduler*)),
+		* the particles are split in ranges updated concurrently by the threads of the scheduler.<br>
+		* Ages, energies, positions and distances are always updated in parallel. Interpolators and modifiers are updated in parallel
+		* under the same conditions than for the fused update, provided they are parallel safe (see Modifier::isParallelSafe()).
+		* Other modifiers, the renderer, births and deaths are still handled on the calling thread.
+		* The neighbor structure is built in parallel as well (see NeighborStructure).<br>
+		* The update is not split while the group is updated concurrently with other groups of its system (see System::enableParallelUpdate(bool)).<br>
+		* <br>
+		* The ranges are made of whole tiles if the fused update is enabled so that the results are the same than without the parallel update.
+		*
+		* @param parallel : true to enable the parallel update, false to disable it
+		*/
+		void enableParallelUpdate(bool parallel);
+
+		/**
+		* @brief Tells whether the parallel update is enabled or not
+		* @return true if the parallel update is enabled, false if not
+		*/
+		bool isParallelUpdateEnabled() const;
+
+		/**
+		* @brief Gets the scheduler splitting the current update of this group in ranges
+		* Modifiers can use it to split their own work (see Collider for instance).
+		* @return the scheduler of the context, or NULL if the update of this group is not split
+		*/
+		TaskScheduler* getTaskScheduler() const;
+
+		/**
+		* @brief Enables or disables the deferral of the render side of the update to the last substep
+		*
+		* When the system performs several updates within a call (constant or adaptive step mode), only the results of the last one are rendered.
+		* When enabled, the update of the renderer and the computation of the distances from the camera are only performed by the last update of the call.
+		* The renderer can get the time elapsed since its last update with getRendererDeltaTime().<br>
+		* <br>
+		* The deferral is enabled by default.
+		*
+		* @param deferred : true to defer the render side of the update to the last substep, false to perform it at each substep
+		*/
+		void enableDeferredRenderSide(bool deferred);
+
+		/**
+		* @brief Tells whether the render side of the update is deferred to the last substep
+		* @return true if the render side is deferred, false if not
+		*/
+		bool isDeferredRenderSideEnabled() const;
+
+		/**
+		* @brief Gets the time elapsed since the last update of the renderer
+		*
+		* This is meant to be called by the renderer within Renderer::update(const Group&,DataSet*).
+		* It covers all the updates of the particles since the last update of the renderer (substeps, catch up of a sleeping system...).
+		*
+		* @return the time elapsed since the last update of the renderer in seconds
+		*/
+		float getRendererDeltaTime() const;
+
 		const void* getColorAddress() const;
 		const void* getPositionAddress() const;
 		const void* getVelocityAddress() const;
@@ -290,9 +489,276 @@ namespace SPK
 		*/
 		float addParticles(const Vector3D& start,const Vector3D& end,const Vector3D& velocity,float step,float offset = 0.0f);
 
+		/**
+		* @brief Enqueues some Particles to add to this Group from any thread
+		*
+		* Unlike addParticles, this method can be called concurrently from several threads (gameplay threads, modifiers updated in parallel...)
+		* while the group is updated. The request is pushed within a preallocated lock-free queue so that no lock is taken and no memory is allocated.<br>
+		* The queue is drained in bulk at the next call to update or flushBufferedParticles() and the particles are born after the ones added with addParticles.<br>
+		* <br>
+		* The zone and the emitter are not referenced by the request, they must stay valid until its particles are born or discarded.
+		* This is done at the latest when the second spawn cycle following the call ends (see getNbSpawnCycles()).
+		* The tank of the emitter is not affected.<br>
+		* <br>
+		* The spawn queue must have been enabled with setSpawnQueueCapacity(unsigned int) beforehand.
+		*
+		* @param nb : the number of Particles to add
+		* @param position : the position of the Particles if zone is NULL
+		* @param velocity : the velocity of the Particles if emitter is NULL
+		* @param zone : the zone generating the positions of the Particles or NULL
+		* @param emitter : the emitter generating the velocities of the Particles or NULL
+		* @param full : true to generate the positions within the whole zone, false to generate them at its borders
+		* @return true if the request was enqueued, false if the spawn queue is full or disabled
+		*/
+		bool enqueueParticles(unsigned int nb,const Vector3D& position,const Vector3D& velocity,Zone* zone = NULL,Emitter* emitter = NULL,bool full = true);
+
+		/**
+		* @brief Enqueues some Particles to add to this Group from any thread
+		*
+		* See enqueueParticles(unsigned int,const Vector3D&,const Vector3D&,Zone*,Emitter*,bool) for a complete description.<br>
+		* The number of Particles is limited by the tank of the emitter, which is only updated if the request is enqueued.
+		*
+		* @param nb : the number of Particles to add
+		* @param emitter : the Emitter that will be used to generate the velocity and whose Zone will be used to generate the position
+		* @return true if the request was enqueued, false if the spawn queue is full or disabled
+		*/
+		bool enqueueParticles(unsigned int nb,Emitter* emitter);
+
+		/**
+		* @brief Enqueues some Particles to add to this Group from any thread
+		*
+		* See enqueueParticles(unsigned int,const Vector3D&,const Vector3D&,Zone*,Emitter*,bool) for a complete description.<br>
+		* The number of Particles is determined by the flow of the emitter, whose tank is only updated if the request is enqueued.
+		*
+		* @param emitter : the Emitter that will be used to generate the velocity and whose Zone will be used to generate the position
+		* @param deltaTime : the step time that will be used to determine how many particles to generate
+		* @return true if the request was enqueued, false if the spawn queue is full or disabled
+		*/
+		bool enqueueParticles(Emitter* emitter,float deltaTime);
+
+		/**
+		* @brief Sets the maximum number of pending requests of the spawn queue
+		*
+		* The capacity is rounded up to a power of 2. 0 disables the spawn queue (default).<br>
+		* Pending requests are lost. This method must not be called while particles are enqueued.
+		*
+		* @param capacity : the maximum number of pending requests
+		*/
+		void setSpawnQueueCapacity(unsigned int capacity);
+
+		/**
+		* @brief Gets the maximum number of pending requests of the spawn queue
+		* @return the maximum number of pending requests or 0 if the spawn queue is disabled
+		*/
+		unsigned int getSpawnQueueCapacity() const;
+
+		/**
+		* @brief Gets the number of spawn cycles of this group
+		*
+		* A spawn cycle ends each time the added and enqueued particles are born or discarded (at the end of an update, in flushBufferedParticles() or when the system is restarted).<br>
+		* The owner of the zones and emitters passed to enqueueParticles(unsigned int,const Vector3D&,const Vector3D&,Zone*,Emitter*,bool)
+		* can release or modify them once this number is 2 above its value at the time of the call.
+		*
+		* @return the number of spawn cycles since the creation of this group
+		*/
+		unsigned int getNbSpawnCycles() const;
+
 		void flushBufferedParticles();
 
-		Ref<System> getSystem() const;
+		System* getSystem() const;
+
+		////////////
+		// Random //
+		////////////
+
+		/**
+		* @brief Gets the random stream of this group
+		*
+		* The stream is seeded by the system of the group (see System::setSeed(unsigned int)).
+		* It is the current stream of SPK_RANDOM during the sequential phases of the update of the group.
+		*
+		* @return the random stream of this group
+		*/
+		RandomStream& getRandomStream();
+
+		/**
+		* @brief Gets a random stream specific to a particle for the current update
+		*
+		* The stream only depends on the seed of the current update and on the index of the particle.
+		* It can therefore be used by modifiers and interpolators updating ranges of particles in parallel
+		* and the results do not depend on the number of threads.
+		*
+		* @param index : the index of the particle
+		* @return a random stream for the particle
+		*/
+		RandomStream getParticleRandomStream(size_t index) const;
+
+		////////////////
+		// Instancing //
+		////////////////
+
+		/** @brief The instance of the particles that do not belong to any instance */
+		static const size_t NO_INSTANCE = static_cast<unsigned int>(-1);
+
+		/**
+		* @brief Enables or disables the instancing of this group
+		*
+		* Many small copies of the same effect are cheaper to update as instances of a single group than as many groups :
+		* the particles of all the instances are stored together and the interpolators, the modifiers and the renderer
+		* process them all at once.<br>
+		* <br>
+		* When instancing is enabled, the emitters of the group are templates and do not emit by themselves.
+		* Each instance owns copies of them, placed with the transform of the instance (see createInstance(const float*)).
+		* The modifiers are shared by all the instances and use the transform of the group.<br>
+		* <br>
+		* Disabling instancing destroys all the instances (their particles remain).
+		*
+		* @param instancing : true to enable the instancing, false to disable it
+		*/
+		void enableInstancing(bool instancing);
+
+		/**
+		* @brief Tells whether the instancing is enabled or not
+		* @return true if the instancing is enabled, false if not
+		*/
+		bool isInstancingEnabled() const;
+
+		/**
+		* @brief Creates an instance of this group
+		*
+		* The emitters of the group are copied with their current state. The copies of a destroyed instance are recycled
+		* so that creating an instance does not allocate any memory once enough instances were created.<br>
+		* An instance is destroyed automatically once it has no more particles and all its emitters are exhausted or inactive.
+		* Its identifier may then be given to a new instance.
+		*
+		* @param transform : the transform of the instance relative to the group (see Transform::set(const float*))
+		* @return the identifier of the instance or NO_INSTANCE if instancing is disabled
+		*/
+		size_t createInstance(const float* transform = Transform::IDENTITY);
+
+		/**
+		* @brief Destroys an instance of this group
+		* The particles of the instance are killed at the next update and its emitters stop emitting.
+		* @param id : the identifier of the instance
+		*/
+		void destroyInstance(size_t id);
+
+		/**
+		* @brief Sets the transform of an instance
+		* @param id : the identifier of the instance
+		* @param transform : the transform of the instance relative to the group
+		*/
+		void setInstanceTransform(size_t id,const float* transform);
+
+		/**
+		* @brief Tells whether an instance exists or not
+		* @param id : the identifier of the instance
+		* @return true if the instance exists, false if it was destroyed
+		*/
+		bool isInstanceAlive(size_t id) const;
+
+		/**
+		* @brief Gets the number of instances of this group
+		* @return the number of instances alive
+		*/
+		size_t getNbInstances() const;
+
+		/**
+		* @brief Gets the number of particles of an instance
+		* @param id : the identifier of the instance
+		* @return the number of particles of the instance at the end of the last update
+		*/
+		size_t getInstanceNbParticles(size_t id) const;
+
+		/**
+		* @brief Gets the minimum point of the axis aligned bounding box of an instance
+		* The bounding box is computed at each update from the positions of the particles of the instance.
+		* @param id : the identifier of the instance
+		* @return the minimum point of the bounding box
+		*/
+		const Vector3D& getInstanceAABBMin(size_t id) const;
+
+		/**
+		* @brief Gets the maximum point of the axis aligned bounding box of an instance
+		* @param id : the identifier of the instance
+		* @return the maximum point of the bounding box
+		*/
+		const Vector3D& getInstanceAABBMax(size_t id) const;
+
+		/**
+		* @brief Gets the time elapsed since the creation of an instance
+		* @param id : the identifier of the instance
+		* @return the age of the instance in seconds
+		*/
+		float getInstanceAge(size_t id) const;
+
+		/**
+		* @brief Gets the instance of a particle
+		* @param index : the index of the particle
+		* @return the identifier of the instance of the particle or NO_INSTANCE if the particle does not belong to any instance
+		*/
+		size_t getParticleInstance(size_t index) const;
+
+		////////////
+		// Budget //
+		////////////
+
+		/** @brief The budget of a group without any limit on its number of particles */
+		static const size_t NO_BUDGET = static_cast<size_t>(-1);
+
+		/**
+		* @brief Sets the priority of this group
+		* When a budget is enforced on several systems (see BudgetManager), the particles of groups with lower priorities are dropped first.
+		* @param priority : the priority of this group (0 by default)
+		*/
+		void setPriority(int priority);
+
+		/**
+		* @brief Gets the priority of this group
+		* @return the priority of this group
+		*/
+		int getPriority() const;
+
+		/**
+		* @brief Sets the scale applied to the flows of the emitters of this group
+		* The emitters emit as if the elapsed time was scaled. Emitters with an infinite flow are not affected.
+		* @param scale : the scale of the flows (1 by default)
+		*/
+		void setEmissionScale(float scale);
+
+		/**
+		* @brief Gets the scale applied to the flows of the emitters of this group
+		* @return the scale of the flows
+		*/
+		float getEmissionScale() const;
+
+		/**
+		* @brief Sets the maximum number of particles this group may hold
+		*
+		* Births that would exceed the budget are refused.
+		* If the group holds more particles than its budget, the ones with the lowest energy are killed at the next update.<br>
+		* The budget is usually set at each frame by a BudgetManager.
+		*
+		* @param budget : the maximum number of particles or NO_BUDGET for no limit (default)
+		*/
+		void setParticleBudget(size_t budget);
+
+		/**
+		* @brief Gets the maximum number of particles this group may hold
+		* @return the maximum number of particles or NO_BUDGET if there is no limit
+		*/
+		size_t getParticleBudget() const;
+
+		/**
+		* @brief Gets the number of births this group requests for its next update
+		*
+		* The births are the ones of the emitters for the given elapsed time scaled by the emission scale
+		* and the particles added manually but not created yet. They do not take the budget into account.
+		*
+		* @param deltaTime : the elapsed time of the next update
+		* @return the number of births requested
+		*/
+		size_t getNbRequestedBirths(float deltaTime) const;
 
 		/////////////
 		// Actions //
@@ -354,9 +820,120 @@ namespace SPK
 		*/
 		RenderBuffer* getRenderBuffer();
 
+		/**
+		* @brief Sets the type of structure used to find the neighbors of the particles
+		*
+		* The structure is only built if at least one of the modifiers of the group needs it (see Modifier::NEEDS_OCTREE).<br>
+		* The octree (NEIGHBOR_STRUCTURE_OCTREE) is used by default.
+		* The flat grid (NEIGHBOR_STRUCTURE_GRID) is faster to build and to query for groups of particles of similar sizes.<br>
+		* Modifiers query the neighbors through the NeighborStructure interface whatever its type.
+		*
+		* @param type : the type of the neighbor structure
+		*/
+		void setNeighborStructureType(NeighborStructureType type);
+
+		/**
+		* @brief Gets the type of structure used to find the neighbors of the particles
+		* @return the type of the neighbor structure
+		*/
+		NeighborStructureType getNeighborStructureType() const;
+
+		/**
+		* @brief Sets the maximum level of the octree
+		*
+		* The deepest cells of the octree are 2^maxLevel times smaller than the group along each axis.
+		* Less levels are used when the cells would be smaller than their minimum size (see setOctreeCellSizeFactor(float)).<br>
+		* The maximum level cannot exceed Octree::MAX_LEVEL_INDEX_LIMIT as the number of cells grows as 8^maxLevel.<br>
+		* It is 4 by default.
+		*
+		* @param maxLevel : the maximum level of the octree
+		*/
+		void setOctreeMaxLevel(unsigned int maxLevel);
+
+		/**
+		* @brief Gets the maximum level of the octree
+		* @return the maximum level of the octree
+		*/
+		unsigned int getOctreeMaxLevel() const;
+
+		/**
+		* @brief Sets the number of particles above which a cell of the octree is split
+		*
+		* Cells of the maximum level are never split whatever their number of particles.<br>
+		* It is 32 by default.
+		*
+		* @param maxParticlesPerCell : the maximum number of particles per cell (must be greater than 0)
+		*/
+		void setOctreeMaxParticlesPerCell(unsigned int maxParticlesPerCell);
+
+		/**
+		* @brief Gets the number of particles above which a cell of the octree is split
+		* @return the maximum number of particles per cell
+		*/
+		unsigned int getOctreeMaxParticlesPerCell() const;
+
+		/**
+		* @brief Sets the minimum size of the cells of the octree relative to the mean radius of the particles
+		*
+		* Bigger cells reduce the number of particles lying in several cells but increase the number of particles per cell.<br>
+		* It is 4 by default.
+		*
+		* @param cellSizeFactor : the minimum size of the cells in mean radius (must be positive)
+		*/
+		void setOctreeCellSizeFactor(float cellSizeFactor);
+
+		/**
+		* @brief Gets the minimum size of the cells of the octree relative to the mean radius of the particles
+		* @return the minimum size of the cells in mean radius
+		*/
+		float getOctreeCellSizeFactor() const;
+
+		/**
+		* @brief Enables or disables the incremental update of the octree
+		*
+		* When enabled, the cells of the octree are kept from an update to another
+		* and only the particles that crossed a cell boundary are moved to their new cells.
+		* The octree is rebuilt only when the bounds of the group changed significantly (see setOctreeRebuildThreshold(float)).<br>
+		* This suits dense groups of slow particles which would otherwise pay a complete rebuild at each update.<br>
+		* Cells are never merged until the next rebuild. The incremental update is disabled by default.
+		*
+		* @param incremental : true to update the octree incrementally, false to rebuild it at each update
+		*/
+		void enableIncrementalOctree(bool incremental);
+
+		/**
+		* @brief Tells whether the octree is updated incrementally
+		* @return true if the octree is updated incrementally, false if it is rebuilt at each update
+		*/
+		bool isIncrementalOctreeEnabled() const;
+
+		/**
+		* @brief Sets the displacement of the bounds of the group triggering a rebuild of an incremental octree
+		*
+		* The threshold is a fraction of the biggest dimension of the group at the last rebuild.
+		* The octree is rebuilt when a side of the bounds of the group moves further.<br>
+		* It is 0.1 by default.
+		*
+		* @param threshold : the rebuild threshold (must be positive)
+		*/
+		void setOctreeRebuildThreshold(float threshold);
+
+		/**
+		* @brief Gets the displacement of the bounds of the group triggering a rebuild of an incremental octree
+		* @return the rebuild threshold
+		*/
+		float getOctreeRebuildThreshold() const;
+
+		/**
+		* @brief Gets the neighbor structure
+		* A group will have a neighbor structure only if at least one of its modifiers has requested it.
+		* @return the neighbor structure if some or NULL otherwise
+		*/
+		NeighborStructure* getNeighborStructure();
+
 		/**
 		* @brief Gets the octree
-		* A group will have an octree only if at least one of its modifiers has requested it.
+		* A group will have an octree only if at least one of its modifiers has requested it and if the octree is its neighbor structure.
 		* @return the octree if some or NULL otherwise
 		*/
 		Octree* getOctree();
@@ -371,12 +948,31 @@ namespace SPK
 		spark_description(Group, Transformable)
 		(
 			spk_attribute(unsigned int, capacity, reallocate, getCapacity);
+			spk_attribute(bool, elasticCapacity, enableElasticCapacity, isElasticCapacityEnabled);
+			spk_attribute(float, growthFactor, setGrowthFactor, getGrowthFactor);
+			spk_attribute(unsigned int, maxCapacity, setMaxCapacity, getMaxCapacity);
+			spk_attribute(float, shrinkDelay, setShrinkDelay, getShrinkDelay);
+			spk_attribute(unsigned int, spawnQueueCapacity, setSpawnQueueCapacity, getSpawnQueueCapacity);
 			spk_attribute(Pair<float>, lifeTime, setLifeTime, getMinLifeTime, getMaxLifeTime);
 			spk_attribute(bool, immortal, setImmortal, isImmortal);
 			spk_attribute(bool, still, setStill, isStill);
 			spk_attribute(bool, computeDistances, enableDistanceComputation, isDistanceComputationEnabled);
 			spk_attribute(bool, sortParticles, enableSorting, isSortingEnabled);
+			spk_attribute(bool, indexSorting, enableIndexSorting, isIndexSortingEnabled);
+			spk_attribute(bool, fusedUpdate, enableFusedUpdate, isFusedUpdateEnabled);
+			spk_attribute(unsigned int, tileSize, setTileSize, getTileSize);
+			spk_attribute(bool, splitStorage, enableSplitStorage, isSplitStorageEnabled);
+			spk_attribute(bool, parallelUpdate, enableParallelUpdate, isParallelUpdateEnabled);
+			spk_attribute(bool, deferredRenderSide, enableDeferredRenderSide, isDeferredRenderSideEnabled);
+			spk_attribute(bool, instancing, enableInstancing, isInstancingEnabled);
+			spk_attribute(int, priority, setPriority, getPriority);
 			spk_attribute(float, physicalRadius, setPhysicalRadius, getPhysicalRadius);
+			spk_attribute(NeighborStructureType, neighborStructure, setNeighborStructureType, getNeighborStructureType);
+			spk_attribute(unsigned int, octreeMaxLevel, setOctreeMaxLevel, getOctreeMaxLevel);
+			spk_attribute(unsigned int, octreeMaxParticlesPerCell, setOctreeMaxParticlesPerCell, getOctreeMaxParticlesPerCell);
+			spk_attribute(float, octreeCellSizeFactor, setOctreeCellSizeFactor, getOctreeCellSizeFactor);
+			spk_attribute(bool, incrementalOctree, enableIncrementalOctree, isIncrementalOctreeEnabled);
+			spk_attribute(float, octreeRebuildThreshold, setOctreeRebuildThreshold, getOctreeRebuildThreshold);
 			spk_attribute(float, graphicalRadius, setGraphicalRadius, getGraphicalRadius);
 			spk_attribute(Ref<ColorInterpolator>, colorInterpolator, setColorInterpolator, getColorInterpolator);
 			spk_attribute(Ref<FloatInterpolator>, scaleInterpolator, setScaleInterpolator, getScaleInterpolator);
@@ -396,10 +992,43 @@ namespace SPK
 		static const size_t NB_PARAMETERS = 5;
 		static const float DEFAULT_VALUES[NB_PARAMETERS];
 
+		static const unsigned int DEFAULT_TILE_SIZE = 256;
+		static const float DEFAULT_GROWTH_FACTOR;
+		static const size_t PARALLEL_GRAIN_SIZE = 4096; // The minimum number of particles updated by a thread at once
+		static const size_t MAX_SORT_SHIFTS_PER_PARTICLE = 4; // Above this number of shifts, the previous order is radix sorted instead of refined
+
+		// The arrays of vectors that can be stored split
+		enum VectorArray
+		{
+			VECTOR_ARRAY_POSITIONS,
+			VECTOR_ARRAY_VELOCITIES,
+			VECTOR_ARRAY_OLD_POSITIONS,
+			NB_VECTOR_ARRAYS,
+		};
+
+		// The split storage of an array of vectors (one aligned array per coordinate)
+		struct SplitArray
+		{
+			float* coords[3];
+
+			mutable bool viewValid;		// true if the array of Vector3D is up to date
+			mutable size_t dirtyStart;	// the range of the array of Vector3D modified since it was last copied to the split arrays
+			mutable size_t dirtyEnd;
+
+			SplitArray() :
+				viewValid(true),
+				dirtyStart(0),
+				dirtyEnd(0)
+			{
+				coords[0] = coords[1] = coords[2] = NULL;
+			}
+		};
+
 		// This holds the structure of arrays (SOA) containing data of particles
 		struct ParticleData
 		{
 			bool initialized;
+			bool splitStorage;
 
 			size_t nbParticles;
 			size_t maxParticles;
@@ -418,8 +1047,19 @@ namespace SPK
 			Color* colors;
 			float* parameters[NB_PARAMETERS];
 
+			unsigned int* instanceIds; // Only allocated if instancing is enabled
+
+			// Split storage of vectors
+			SplitArray splitArrays[NB_VECTOR_ARRAYS];
+			bool trackVectorWrites; // false while tiles copy back their vectors by themselves
+
+			// Aligned block of memory holding all the columns above one after the other
+			char* slab;
+			size_t slabSize;
+
 			ParticleData() :
 				initialized(false),
+				splitStorage(false),
 				nbParticles(0),
 				maxParticles(0),
 				positions(NULL),
@@ -429,7 +1069,11 @@ namespace SPK
 				energies(NULL),
 				lifeTimes(NULL),
 				sqrDists(NULL),
-				colors(NULL)
+				colors(NULL),
+				instanceIds(NULL),
+				trackVectorWrites(true),
+				slab(NULL),
+				slabSize(0)
 			{
 				for (size_t i = 0; i < NB_PARAMETERS; ++i)
 					parameters[i] = NULL;
@@ -440,13 +1084,27 @@ namespace SPK
 		{
 			Emitter* obj;
 			size_t nbBorn;
+			size_t instance;
 
-			WeakEmitterPair(const Ref<Emitter>& obj,size_t nbBorn) :
+			WeakEmitterPair(const Ref<Emitter>& obj,size_t nbBorn,size_t instance = NO_INSTANCE) :
 				obj(obj.get()),
-				nbBorn(nbBorn)
+				nbBorn(nbBorn),
+				instance(instance)
 			{}
 		};
 
+		struct Instance
+		{
+			float transform[Transform::TRANSFORM_LENGTH];
+			std::vector<Ref<Emitter> > emitters; // Copies of the emitters of the group placed with the transform of the instance
+			std::vector<const Emitter*> templates; // The emitters of the group the copies were made from
+			bool alive;
+			float age;
+			size_t nbParticles;
+			Vector3D AABBMin;
+			Vector3D AABBMax;
+		};
+
 		template<class T>
 		struct DataHandlerDef
 		{
@@ -555,6 +1213,8 @@ namespace SPK
 
 		std::list<DataSet> dataSets;
 
+		std::vector<size_t> deadParticles; // Sorted indices of the particles to remove at the end of the update
+
 		float minLifeTime;
 		float maxLifeTime;
 		bool immortal;
@@ -562,6 +1222,38 @@ namespace SPK
 
 		bool distanceComputationEnabled;
 		bool sortingEnabled;
+		bool indexSortingEnabled;
+
+		// Elastic capacity
+		bool elasticCapacityEnabled;
+		float growthFactor;
+		unsigned int maxCapacity;
+		float shrinkDelay;
+		float shrinkTime; // Time the group has been underpopulated
+		size_t minCapacity; // The capacity set with reallocate(size_t)
+
+		// Sorting by index
+		std::vector<unsigned int> sortedIndices; // Permutation of the particles indices from the farthest to the nearest one
+		std::vector<unsigned int> sortBuffer;
+		std::vector<unsigned int> sortKeys;
+
+		bool fusedUpdateEnabled;
+		unsigned int tileSize;
+		bool parallelUpdateEnabled;
+
+		bool deferredRenderSideEnabled;
+
+		// Set by the system to skip the render side of the update (substeps, level of detail, catch up, prewarm...)
+		bool rendererUpdateEnabled;
+		bool distanceUpdateEnabled;
+		float rendererDeltaTime; // Time elapsed since the last update of the renderer
+		bool prewarming; // Set by the system so that the modifiers skipped in prewarm are not applied
+		bool concurrentUpdate; // true while the group is updated concurrently with other groups (its update is not split then)
+
+		// Stages of the current update performed by updateRanges(float)
+		bool fusedInterpolators;
+		size_t nbFusedModifiers;
+		bool fusedDistances;
 
 		Vector3D AABBMin;
 		Vector3D AABBMax;
@@ -569,26 +1261,105 @@ namespace SPK
 		float physicalRadius;
 		float graphicalRadius;
 
-		Octree* octree;
+		NeighborStructure* neighborStructure;
+		NeighborStructureType neighborStructureType;
+
+		unsigned int octreeMaxLevel;
+		unsigned int octreeMaxParticlesPerCell;
+		float octreeCellSizeFactor;
+		bool incrementalOctreeEnabled;
+		float octreeRebuildThreshold;
+
+		RandomStream randomStream;
+		uint32 updateSeed; // Drawn from the stream at each update to seed the streams of the particles
+
+		int priority;
+		float emissionScale;
+		size_t particleBudget;
+
+		void dropParticles(size_t nb);
+
+		bool instancingEnabled;
+		std::vector<Instance> instances; // Destroyed instances are kept to be recycled
+		std::vector<size_t> freeInstances;
+		size_t nbInstances;
+
+		bool updateEmitters(const std::vector<Ref<Emitter> >& emitters,float deltaTime,size_t instance,size_t& nbBorn);
+		static size_t getNbBornFromEmitters(const std::vector<Ref<Emitter> >& emitters,float deltaTime);
+		void placeInstanceEmitters(Instance& instance);
+		void updateInstances(float deltaTime);
 
 		Group(const Ref<System>& system = SPK_NULL_REF,size_t capacity = 100);
 		Group(const Group& group);
 
 		bool updateParticles(float deltaTime);
+
+		// Stages of updateParticles(float), called separately by the system which prepares the data of all its groups before updating them concurrently
+		void updateRanges(float deltaTime);
+		bool completeUpdate(float deltaTime);
+		void updateTile(size_t start,size_t end,float deltaTime,bool interpolate,size_t nbModifiers,bool computeDistances);
+
+		// Updates the particles of a range tile by tile (or all at once if the fused update is disabled)
+		class UpdateTask : public RangeTask
+		{
+		public :
+
+			UpdateTask(Group& group,float deltaTime,bool interpolate,size_t nbModifiers,bool computeDistances,const ParticleData* renderColumns);
+			virtual void execute(size_t start,size_t end);
+
+		private :
+
+			Group& group;
+			float deltaTime;
+			bool interpolate;
+			size_t nbModifiers;
+			bool computeDistances;
+			const ParticleData* renderColumns; // The columns each tile is copied from before being updated (NULL if none)
+		};
+
+		template<typename T>
+		static bool canUpdateRange(const T& handler,bool parallel);
+		void integrateParticles(size_t start,size_t end,float deltaTime);
+		void updateDistances(size_t start,size_t end);
 		void renderParticles();
 
-		bool initParticle(size_t index,size_t& emitterIndex,size_t& nbManualBorn);
+		void updateRenderSide();
+		void initParticles(size_t nb,size_t& emitterIndex,size_t& nbManualBorn);
 		void swapParticles(size_t index0,size_t index1);
+		void compactParticles();
 
 		void recomputeEnabledParamIndices();
 
+		// Changes the capacity keeping the particles and resizing the data sets (returns false if some data sets were destroyed)
+		bool resizeCapacity(size_t capacity);
+		void growCapacity(size_t nbNeeded);
+		void shrinkCapacity(float deltaTime);
+
+		// All the columns of particles are allocated at once within a slab
+		void reallocateSlab(size_t capacity,size_t copySize);
 		template<typename T>
-		void reallocateArray(T*& t,size_t newSize,size_t copySize);
+		static void placeColumn(T*& column,char*& address,size_t capacity,size_t copySize);
+		static size_t getColumnSize(size_t elementSize,size_t capacity);
+
+		Vector3D* getVectorArray(VectorArray array) const;
+		void destroySplitArrays();
+
+		// Keeps the arrays of Vector3D and the split arrays consistent
+		void readVectors(VectorArray array) const;
+		void writeVectors(VectorArray array,size_t index);
+		void gatherVectors(VectorArray array) const;
+		void scatterVectors(VectorArray array);
+		void invalidateVectors(VectorArray array);
+		void checkVectors(VectorArray array) const;
 
 		DataSet* attachDataSet(DataHandler* dataHandler);
 		void detachDataSet(DataSet* dataHandler);
 
 		void sortParticles(int start,int end);
+		void sortIndices();
+		bool insertionSortIndices(size_t maxShifts);
+		void radixSortIndices();
+		void remapSortedIndices(const size_t* deadIndices,size_t nbDead,size_t nbParticles);
 		virtual void propagateUpdateTransform();
 
 		void sortParticles();
@@ -603,15 +1374,61 @@ namespace SPK
 			bool full = false);
 
 		void emptyBufferedParticles();
+		void drainSpawnQueue();
+		void generateBufferedParticles(size_t start,size_t end,const Vector3D& position,const Vector3D& velocity,Zone* zone,Emitter* emitter,bool full);
 
 		// creation data
 		std::deque<CreationData> creationBuffer;
 		unsigned int nbBufferedParticles;
 
+		// Requests enqueued concurrently, drained in spawnRequests before the births
+		SpawnQueue spawnQueue;
+		std::vector<SpawnRequest> spawnRequests;
+		size_t nbSpawnRequests;
+		size_t spawnRequestIndex; // The next drained request to generate
+		unsigned int nbSpawnCycles;
+
 		void prepareAdditionnalData();
-		void manageOctreeInstance(bool needsOctree);
+		void manageNeighborStructureInstance(bool needsNeighborStructure);
 
 		void initData();
+
+		// Render state of the asynchronous update (see System::enableAsyncUpdate(bool))
+		// It holds the columns and the data of the renderer of the last joined update, rendered while the group is updated.
+		// Its columns are the ones of the group until the group writes its particles again : the group then moves to the spare slab
+		struct RenderState
+		{
+			ParticleData particleData;
+			DataSet rendererData;
+
+			bool shared; // true while the columns of the state are the ones of the group
+			bool rendererDataPending; // true while the data of the renderer of the group must be copied back from the state
+
+			char* spareSlab;
+			size_t spareSlabSize;
+
+			RenderState() :
+				shared(false),
+				rendererDataPending(false),
+				spareSlab(NULL),
+				spareSlabSize(0)
+			{}
+		};
+
+		RenderState* renderState; // NULL if the group is not updated asynchronously
+		Ref<Group> renderView; // Renderers read the particles from a group, this one reads the render state
+
+		void prepareRenderState();
+		void completeRenderState();
+		void swapRenderState();
+		void releaseRenderState();
+
+		// Called before the group writes its particles, returns the columns to copy from (NULL if the columns are already separate)
+		const ParticleData* separateRenderState();
+		void restoreRendererData();
+
+		void rebaseColumns(const char* oldSlab);
+		void copyColumns(const ParticleData& source,size_t start,size_t end);
 	};
 
 	inline Ref<Group> Group::create(size_t capacity)
@@ -620,13 +1437,19 @@ namespace SPK
 	}
 
 	template<typename T>
-	void Group::reallocateArray(T*& t,size_t newSize,size_t copySize)
+	void Group::placeColumn(T*& column,char*& address,size_t capacity,size_t copySize)
 	{
-		T* oldT = t;
-		t = SPK_NEW_ARRAY(T,newSize);
-		if (oldT != NULL && copySize != 0)
-			std::memcpy(oldT,t,copySize * sizeof(T));
-		SPK_DELETE_ARRAY(oldT);
+		T* oldColumn = column;
+		column = reinterpret_cast<T*>(address);
+		if (oldColumn != NULL && copySize != 0)
+			std::memcpy(column,oldColumn,copySize * sizeof(T)); // The particles are copied from the old column to the new one
+		address += getColumnSize(sizeof(T),capacity);
+	}
+
+	inline size_t Group::getColumnSize(size_t elementSize,size_t capacity)
+	{
+		// Columns are padded to the SIMD width and aligned so that vectorized kernels can process them by whole registers
+		return (SIMD::getPaddedSize(capacity) * elementSize + SIMD::ALIGNMENT - 1) / SIMD::ALIGNMENT * SIMD::ALIGNMENT;
 	}
 
 	inline bool Group::isInitialized() const
@@ -749,6 +1572,137 @@ namespace SPK
 		particleData.nbParticles = 0;
 	}
 
+	inline void Group::enableElasticCapacity(bool elastic)
+	{
+		elasticCapacityEnabled = elastic;
+		shrinkTime = 0.0f;
+	}
+
+	inline bool Group::isElasticCapacityEnabled() const
+	{
+		return elasticCapacityEnabled;
+	}
+
+	inline float Group::getGrowthFactor() const
+	{
+		return growthFactor;
+	}
+
+	inline void Group::setMaxCapacity(unsigned int maxCapacity)
+	{
+		this->maxCapacity = maxCapacity;
+	}
+
+	inline unsigned int Group::getMaxCapacity() const
+	{
+		return maxCapacity;
+	}
+
+	inline void Group::setShrinkDelay(float shrinkDelay)
+	{
+		this->shrinkDelay = shrinkDelay;
+	}
+
+	inline float Group::getShrinkDelay() const
+	{
+		return shrinkDelay;
+	}
+
+	inline unsigned int Group::getSpawnQueueCapacity() const
+	{
+		return static_cast<unsigned int>(spawnQueue.getCapacity());
+	}
+
+	inline unsigned int Group::getNbSpawnCycles() const
+	{
+		return nbSpawnCycles;
+	}
+
+	inline void Group::setPriority(int priority)
+	{
+		this->priority = priority;
+	}
+
+	inline int Group::getPriority() const
+	{
+		return priority;
+	}
+
+	inline void Group::setEmissionScale(float scale)
+	{
+		emissionScale = scale;
+	}
+
+	inline float Group::getEmissionScale() const
+	{
+		return emissionScale;
+	}
+
+	inline void Group::setParticleBudget(size_t budget)
+	{
+		particleBudget = budget;
+	}
+
+	inline size_t Group::getParticleBudget() const
+	{
+		return particleBudget;
+	}
+
+	inline bool Group::isInstancingEnabled() const
+	{
+		return instancingEnabled;
+	}
+
+	inline bool Group::isInstanceAlive(size_t id) const
+	{
+		return id < instances.size() && instances[id].alive;
+	}
+
+	inline size_t Group::getNbInstances() const
+	{
+		return nbInstances;
+	}
+
+	inline size_t Group::getInstanceNbParticles(size_t id) const
+	{
+		SPK_ASSERT(isInstanceAlive(id),"Group::getInstanceNbParticles(size_t) - The instance does not exist : " << id);
+		return instances[id].nbParticles;
+	}
+
+	inline const Vector3D& Group::getInstanceAABBMin(size_t id) const
+	{
+		SPK_ASSERT(isInstanceAlive(id),"Group::getInstanceAABBMin(size_t) - The instance does not exist : " << id);
+		return instances[id].AABBMin;
+	}
+
+	inline const Vector3D& Group::getInstanceAABBMax(size_t id) const
+	{
+		SPK_ASSERT(isInstanceAlive(id),"Group::getInstanceAABBMax(size_t) - The instance does not exist : " << id);
+		return instances[id].AABBMax;
+	}
+
+	inline float Group::getInstanceAge(size_t id) const
+	{
+		SPK_ASSERT(isInstanceAlive(id),"Group::getInstanceAge(size_t) - The instance does not exist : " << id);
+		return instances[id].age;
+	}
+
+	inline size_t Group::getParticleInstance(size_t index) const
+	{
+		SPK_ASSERT(index < particleData.nbParticles,"Group::getParticleInstance(size_t) - Particle index is out of bounds : " << index);
+		return particleData.instanceIds != NULL ? particleData.instanceIds[index] : NO_INSTANCE;
+	}
+
+	inline RandomStream& Group::getRandomStream()
+	{
+		return randomStream;
+	}
+
+	inline RandomStream Group::getParticleRandomStream(size_t index) const
+	{
+		return RandomStream(updateSeed ^ RandomStream::hash(static_cast<uint32>(index)));
+	}
+
 	inline const Ref<Emitter>& Group::getEmitter(size_t index) const
 	{
 		SPK_ASSERT(index < getNbEmitters(),"Group::getEmitter(size_t) - Index of emitter is out of bounds : " << index);
@@ -796,6 +1750,74 @@ namespace SPK
 		return sortingEnabled;
 	}
 
+	inline void Group::enableIndexSorting(bool indexSorting)
+	{
+		indexSortingEnabled = indexSorting;
+	}
+
+	inline bool Group::isIndexSortingEnabled() const
+	{
+		return indexSortingEnabled;
+	}
+
+	inline const unsigned int* Group::getSortedIndices() const
+	{
+		if (!sortingEnabled || !indexSortingEnabled || sortedIndices.empty() || sortedIndices.size() != particleData.nbParticles)
+			return NULL;
+		return &sortedIndices[0];
+	}
+
+	inline void Group::enableFusedUpdate(bool fused)
+	{
+		fusedUpdateEnabled = fused;
+	}
+
+	inline bool Group::isFusedUpdateEnabled() const
+	{
+		return fusedUpdateEnabled;
+	}
+
+	inline unsigned int Group::getTileSize() const
+	{
+		return tileSize;
+	}
+
+	inline void Group::enableParallelUpdate(bool parallel)
+	{
+		parallelUpdateEnabled = parallel;
+	}
+
+	inline bool Group::isParallelUpdateEnabled() const
+	{
+		return parallelUpdateEnabled;
+	}
+
+	inline void Group::enableDeferredRenderSide(bool deferred)
+	{
+		deferredRenderSideEnabled = deferred;
+	}
+
+	inline bool Group::isDeferredRenderSideEnabled() const
+	{
+		return deferredRenderSideEnabled;
+	}
+
+	inline float Group::getRendererDeltaTime() const
+	{
+		return rendererDeltaTime;
+	}
+
+	template<typename T>
+	inline bool Group::canUpdateRange(const T& handler,bool parallel)
+	{
+		return parallel ? handler.isParallelSafe() : handler.supportsRange();
+	}
+
+	inline bool Group::isSplitStorageEnabled() const
+	{
+		return particleData.splitStorage;
+	}
+
 	inline const void* Group::getColorAddress() const
 	{
 		return particleData.colors;
@@ -803,11 +1825,13 @@ namespace SPK
 
 	inline const void* Group::getPositionAddress() const
 	{
+		readVectors(VECTOR_ARRAY_POSITIONS);
 		return particleData.positions;
 	}
 
 	inline const void* Group::getVelocityAddress() const
 	{
+		readVectors(VECTOR_ARRAY_VELOCITIES);
 		return particleData.velocities;
 	}
 
@@ -842,12 +1866,47 @@ namespace SPK
 		return physicalRadius;
 	}
 
+	inline NeighborStructureType Group::getNeighborStructureType() const
+	{
+		return neighborStructureType;
+	}
+
+	inline unsigned int Group::getOctreeMaxLevel() const
+	{
+		return octreeMaxLevel;
+	}
+
+	inline unsigned int Group::getOctreeMaxParticlesPerCell() const
+	{
+		return octreeMaxParticlesPerCell;
+	}
+
+	inline float Group::getOctreeCellSizeFactor() const
+	{
+		return octreeCellSizeFactor;
+	}
+
+	inline void Group::enableIncrementalOctree(bool incremental)
+	{
+		incrementalOctreeEnabled = incremental;
+	}
+
+	inline bool Group::isIncrementalOctreeEnabled() const
+	{
+		return incrementalOctreeEnabled;
+	}
+
+	inline float Group::getOctreeRebuildThreshold() const
+	{
+		return octreeRebuildThreshold;
+	}
+
 	inline void Group::addParticles(unsigned int nb,const Vector3D& position,const Vector3D& velocity)
 	{
 		addParticles(nb,position,velocity,SPK_NULL_REF,SPK_NULL_REF);
 	}
 
-	inline Ref<System> Group::getSystem() const
+	inline System* Group::getSystem() const
 	{
 		return system;
 	}
@@ -881,6 +1940,47 @@ namespace SPK
 	{
 		return renderer.renderBuffer;
 	}
+
+	inline Vector3D* Group::getVectorArray(VectorArray array) const
+	{
+		switch(array)
+		{
+		case VECTOR_ARRAY_POSITIONS : return particleData.positions;
+		case VECTOR_ARRAY_VELOCITIES : return particleData.velocities;
+		default : return particleData.oldPositions;
+		}
+	}
+
+	inline void Group::readVectors(VectorArray array) const
+	{
+		if (particleData.splitStorage && !particleData.splitArrays[array].viewValid)
+			gatherVectors(array);
+	}
+
+	inline void Group::checkVectors(VectorArray array) const
+	{
+		SPK_ASSERT(!particleData.splitStorage || particleData.splitArrays[array].viewValid,
+			"Group::checkVectors(VectorArray) - The array of vectors is read while the split arrays were modified since it was gathered");
+	}
+
+	inline void Group::writeVectors(VectorArray array,size_t index)
+	{
+		if (particleData.splitStorage && particleData.trackVectorWrites)
+		{
+			SplitArray& splitArray = particleData.splitArrays[array];
+			if (!splitArray.viewValid)
+				gatherVectors(array);
+			if (splitArray.dirtyStart == splitArray.dirtyEnd)
+			{
+				splitArray.dirtyStart = index;
+				splitArray.dirtyEnd = index + 1;
+			}
+			else if (index < splitArray.dirtyStart)
+				splitArray.dirtyStart = index;
+			else if (index >= splitArray.dirtyEnd)
+				splitArray.dirtyEnd = index + 1;
+		}
+	}
 }
 
 #endif
@@ -36,6 +36,20 @@ namespace SPK
 	public :
 		virtual ~Interpolator() {}
 
+		/**
+		* @brief Tells whether this interpolator can interpolate a range of particles
+		* An interpolator supporting ranges can be fused within the tile based update of a group.
+		* @return true if the interpolator supports ranges, false if not
+		*/
+		bool supportsRange() const;
+
+		/**
+		* @brief Tells whether this interpolator can interpolate disjoint ranges of particles concurrently
+		* A parallel safe interpolator supports ranges, does not modify any shared state and does not use SPK_RANDOM within interpolateRange.
+		* @return true if the interpolator is parallel safe, false if not
+		*/
+		bool isParallelSafe() const;
+
 	public :
 		spark_description(Interpolator, SPKObject)
 		(
@@ -46,8 +60,10 @@ namespace SPK
 		/**
 		* @brief Constructor of interpolator
 		* @param NEEDS_DATASET : true if the interpolator needs additional data, false otherwise
+		* @param SUPPORTS_RANGE : true if the interpolator implements interpolateRange(T*,Group&,DataSet*,size_t,size_t), false otherwise
+		* @param PARALLEL_SAFE : true if interpolateRange(T*,Group&,DataSet*,size_t,size_t) can be called concurrently on disjoint ranges, false otherwise
 		*/
-		Interpolator(bool NEEDS_DATASET);
+		Interpolator(bool NEEDS_DATASET,bool SUPPORTS_RANGE = false,bool PARALLEL_SAFE = false);
 
 		/**
 		* @brief A helper method that linearly interpolates a value
@@ -61,6 +77,9 @@ namespace SPK
 		
 	private :
 
+		const bool SUPPORTS_RANGE;
+		const bool PARALLEL_SAFE;
+
 		/**
 		* @brief Interpolates the given data of the particles of a group
 		* 
@@ -74,6 +93,17 @@ namespace SPK
 		*/
 		virtual void interpolate(T* data,Group& group,DataSet* dataSet) const = 0;
 
+		/**
+		* @brief Interpolates the given data of the particles of a group within [start,end[
+		* This method is only called by the group if SUPPORTS_RANGE was set to true.
+		* @param data : the array of data to interpolate
+		* @param group : the group from which to interpolate the data
+		* @param dataSet : the associated dataset of the pair interpolator/group. Will be NULL if NEEDS_DATASET is false
+		* @param start : the index of the first particle to interpolate
+		* @param end : the index following the last particle to interpolate
+		*/
+		virtual void interpolateRange(T*,Group&,DataSet*,size_t,size_t) const {}
+
 		/**
 		* @brief Initializes the given data for the given particle
 		* This is a pure virtual method that must be overriden in inherited interpolators.<br>
@@ -82,17 +112,42 @@ namespace SPK
 		* @param dataset : the associated dataset of the pair interpolator/group. Will be NULL if NEEDS_DATASET is false 
 		*/
 		virtual void init(T& data,Particle& particle,DataSet* dataSet) const = 0;
+
+		/**
+		* @brief Initializes the given data for the particles of a group within [start,end[
+		* This is called for bursts of born particles. The default implementation calls init(T&,Particle&,DataSet*) for each particle.
+		* @param data : the array of data to initialize
+		* @param group : the group holding the particles
+		* @param dataSet : the associated dataset of the pair interpolator/group. Will be NULL if NEEDS_DATASET is false
+		* @param start : the index of the first particle to initialize
+		* @param end : the index following the last particle to initialize
+		*/
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 	};
 
 	typedef Interpolator<Color> ColorInterpolator; /**< @brief Abstract interpolator of colors */
 	typedef Interpolator<float> FloatInterpolator; /**< @brief Abstract interpolator of floats */
 
 	template<typename T>
-	inline Interpolator<T>::Interpolator(bool NEEDS_DATASET) :
+	inline Interpolator<T>::Interpolator(bool NEEDS_DATASET,bool SUPPORTS_RANGE,bool PARALLEL_SAFE) :
 		SPKObject(),
-		DataHandler(NEEDS_DATASET)
+		DataHandler(NEEDS_DATASET),
+		SUPPORTS_RANGE(SUPPORTS_RANGE),
+		PARALLEL_SAFE(SUPPORTS_RANGE && PARALLEL_SAFE)
 	{}
 
+	template<typename T>
+	inline bool Interpolator<T>::supportsRange() const
+	{
+		return SUPPORTS_RANGE;
+	}
+
+	template<typename T>
+	inline bool Interpolator<T>::isParallelSafe() const
+	{
+		return PARALLEL_SAFE;
+	}
+
 	template<typename T>
 	inline void Interpolator<T>::interpolateParam(T& result,const T& start,const T& end,float ratio) const
 	{
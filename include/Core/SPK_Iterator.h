@@ -37,6 +37,15 @@ namespace SPK
 		*/
 		Iterator(T& t);
 
+		/**
+		* @brief Constructor of iterator over a range of the collection
+		* The iterator points at start and reaches its end at end (excluded) or at the end of the collection
+		* @param t : the collection over which to iterate
+		* @param start : the index of the first element of the range
+		* @param end : the index following the last element of the range
+		*/
+		Iterator(T& t,size_t start,size_t end);
+
 		/**
 		* @brief Gets the particle on which points by the iterator
 		* @return the particle on which points by the iterator
@@ -70,6 +79,7 @@ namespace SPK
 	private :
 
 		mutable Particle particle;
+		size_t endIndex;
 	};
 
 	/** @brief A generic class to iterate over a constant collection of particles */
@@ -85,6 +95,15 @@ namespace SPK
 		*/
 		ConstIterator(const T& t);
 
+		/**
+		* @brief Constructor of iterator over a range of the collection
+		* The iterator points at start and reaches its end at end (excluded) or at the end of the collection
+		* @param t : the collection over which to iterate
+		* @param start : the index of the first element of the range
+		* @param end : the index following the last element of the range
+		*/
+		ConstIterator(const T& t,size_t start,size_t end);
+
 		/**
 		* @brief Gets the particle on which points by the iterator
 		* @return the particle on which points by the iterator
@@ -118,10 +137,68 @@ namespace SPK
 	private :
 
 		const Particle particle;
+		size_t endIndex;
 	};
 
-	typedef Iterator<Group> GroupIterator;				/**< @brief Iterator of a Group */
-	typedef ConstIterator<Group> ConstGroupIterator;	/**< @brief Constant Iterator of a Group */
+	/**
+	* @brief A generic class to iterate over a constant collection of particles in their sorting order
+	*
+	* If the collection holds a sorted order of its particles (see Group::enableIndexSorting(bool)), particles are iterated in that order.
+	* Otherwise they are iterated in the order of the collection.<br>
+	* This iterator is meant to be used by renderers.
+	*/
+	template<typename T>
+	class ConstSortedIterator
+	{
+	public :
+
+		/**
+		* @brief Constructor of sorted iterator
+		* The iterator points at the first particle of the sorting order
+		* @param t : the collection over which to iterate
+		*/
+		ConstSortedIterator(const T& t);
+
+		/**
+		* @brief Gets the particle on which points by the iterator
+		* @return the particle on which points by the iterator
+		*/
+		const Particle& operator*() const;
+
+		/**
+		* @brief Allows access to the interface of the particle on which points by the iterator
+		* @return the particle on which points by the iterator
+		*/
+		const Particle* operator->() const;
+
+		/**
+		* @brief pre-increments the position of the iterator
+		* @return the incremented iterator
+		*/
+		ConstSortedIterator& operator++();
+
+		/**
+		* @brief post-increments the position of the iterator
+		* @return the iterator before its incrementation
+		*/
+		ConstSortedIterator operator++(int);
+
+		/**
+		* @brief Checks whether the iterator has reached the end of the collection
+		* @return true if the iterator has reached the end of the collection, false if not
+		*/
+		bool end() const;
+
+	private :
+
+		const Particle particle;
+		const unsigned int* order;
+		size_t position;
+	};
+
+	typedef Iterator<Group> GroupIterator;							/**< @brief Iterator of a Group */
+	typedef ConstIterator<Group> ConstGroupIterator;				/**< @brief Constant Iterator of a Group */
+	typedef ConstSortedIterator<Group> ConstSortedGroupIterator;	/**< @brief Constant Iterator of a Group following the sorting order of its particles */
 
 	template<typename T>
 	inline bool operator!=(const Iterator<T>& it0,const Iterator<T>& it1) { return it0->getIndex() != it1->getIndex(); }
@@ -134,11 +211,20 @@ namespace SPK
 
 	template<>
 	inline Iterator<Group>::Iterator(Group& group) :
-		particle(group,0)
+		particle(group,0),
+		endIndex(static_cast<size_t>(-1))
 	{
 		SPK_ASSERT(group.isInitialized(),"Iterator::Iterator(Group&) - An iterator from an uninitialized group cannot be retrieved");
 	}
 
+	template<>
+	inline Iterator<Group>::Iterator(Group& group,size_t start,size_t end) :
+		particle(group,start),
+		endIndex(end)
+	{
+		SPK_ASSERT(group.isInitialized(),"Iterator::Iterator(Group&,size_t,size_t) - An iterator from an uninitialized group cannot be retrieved");
+	}
+
 	template<>
 	inline Particle& Iterator<Group>::operator*() const
 	{ 
@@ -168,16 +254,25 @@ namespace SPK
 	template<>
 	inline bool Iterator<Group>::end() const
 	{ 
-		return particle.index >= particle.group.getNbParticles();
+		return particle.index >= endIndex || particle.index >= particle.group.getNbParticles();
 	}
 
 	template<>
 	inline ConstIterator<Group>::ConstIterator(const Group& group) :
-		particle(const_cast<Group&>(group),0)
+		particle(const_cast<Group&>(group),0),
+		endIndex(static_cast<size_t>(-1))
 	{
 		SPK_ASSERT(group.isInitialized(),"ConstIterator::ConstIterator(Group&) - An const iterator from a uninitialized group cannot be retrieved");	
 	}
 
+	template<>
+	inline ConstIterator<Group>::ConstIterator(const Group& group,size_t start,size_t end) :
+		particle(const_cast<Group&>(group),start),
+		endIndex(end)
+	{
+		SPK_ASSERT(group.isInitialized(),"ConstIterator::ConstIterator(Group&,size_t,size_t) - An const iterator from a uninitialized group cannot be retrieved");
+	}
+
 	template<>
 	inline const Particle& ConstIterator<Group>::operator*() const
 	{ 
@@ -207,7 +302,52 @@ namespace SPK
 	template<>
 	inline bool ConstIterator<Group>::end() const
 	{ 
-		return particle.index >= particle.group.getNbParticles();
+		return particle.index >= endIndex || particle.index >= particle.group.getNbParticles();
+	}
+
+	template<>
+	inline ConstSortedIterator<Group>::ConstSortedIterator(const Group& group) :
+		particle(const_cast<Group&>(group),0),
+		order(group.getSortedIndices()),
+		position(0)
+	{
+		SPK_ASSERT(group.isInitialized(),"ConstSortedIterator::ConstSortedIterator(Group&) - An const iterator from a uninitialized group cannot be retrieved");
+		if (order != NULL)
+			particle.index = order[0];
+	}
+
+	template<>
+	inline const Particle& ConstSortedIterator<Group>::operator*() const
+	{
+		return particle;
+	}
+
+	template<>
+	inline const Particle* ConstSortedIterator<Group>::operator->() const
+	{
+		return &particle;
+	}
+
+	template<>
+	inline ConstSortedIterator<Group>& ConstSortedIterator<Group>::operator++()
+	{
+		++position;
+		particle.index = order != NULL && position < particle.group.getNbParticles() ? order[position] : position;
+		return *this;
+	}
+
+	template<>
+	inline ConstSortedIterator<Group> ConstSortedIterator<Group>::operator++(int)
+	{
+		ConstSortedIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	template<>
+	inline bool ConstSortedIterator<Group>::end() const
+	{
+		return position >= particle.group.getNbParticles();
 	}
 }
 
@@ -22,6 +22,8 @@
 #ifndef H_SPK_MODIFIER
 #define H_SPK_MODIFIER
 
+#include <vector>
+
 namespace SPK
 {
 	class Particle;
@@ -67,6 +69,20 @@ namespace SPK
 		*/
 		bool isLocalToSystem() const;
 
+		/**
+		* @brief Sets whether this modifier is skipped when its system is prewarmed
+		* This allows to leave out modifiers that are costly and whose effect is not visible once the system appears (see System::prewarm(float,float)).<br>
+		* The regular update of the system always applies the active modifiers.
+		* @param skipped : true to skip this modifier during the prewarm, false to apply it
+		*/
+		void setSkippedInPrewarm(bool skipped);
+
+		/**
+		* @brief Tells whether this modifier is skipped when its system is prewarmed
+		* @return true if it is skipped during the prewarm, false if it is applied
+		*/
+		bool isSkippedInPrewarm() const;
+
 		/**
 		* @brief Gets the priority
 		* The priority defines the order in which modifiers are applied (the lower, the sooner)
@@ -74,37 +90,91 @@ namespace SPK
 		*/
 		unsigned int getPriority() const;
 
+		/**
+		* @brief Tells whether this modifier can be applied on a range of particles
+		* A modifier supporting ranges only depends on the particle it modifies and can therefore be fused within the tile based update of a group.
+		* @return true if the modifier supports ranges, false if not
+		*/
+		bool supportsRange() const;
+
+		/**
+		* @brief Tells whether this modifier can be applied concurrently on disjoint ranges of particles
+		* A parallel safe modifier supports ranges, does not modify any shared state and does not use SPK_RANDOM within modifyRange.
+		* It can therefore be applied by several threads during the parallel update of a group.
+		* @return true if the modifier is parallel safe, false if not
+		*/
+		bool isParallelSafe() const;
+
+		/**
+		* @brief Gets the groups this modifier adds particles to
+		* When the groups of a system are updated concurrently, the target groups are updated after the group of the modifier
+		* and on the same thread (see System::enableParallelUpdate(bool)).<br>
+		* Modifiers adding particles to other groups must therefore override this method.
+		* @param targets : the vector to which the target groups are appended
+		*/
+		virtual void getTargetGroups(std::vector<Group*>& targets) const {}
+
 	public :
 		spark_description(Modifier, Transformable)
 		(
 			spk_attribute(bool, active, setActive, isActive);
 			spk_attribute(bool, local, setLocalToSystem, isLocalToSystem);
+			spk_attribute(bool, skippedInPrewarm, setSkippedInPrewarm, isSkippedInPrewarm);
 		);
 
 	protected :
 
-		Modifier(unsigned int PRIORITY,bool NEEDS_DATASET,bool CALL_INIT,bool NEEDS_OCTREE);
+		Modifier(unsigned int PRIORITY,bool NEEDS_DATASET,bool CALL_INIT,bool NEEDS_OCTREE,bool SUPPORTS_RANGE = false,bool PARALLEL_SAFE = false);
 
 	private :
 
 		const unsigned int PRIORITY;
 		const bool CALL_INIT;
 		const bool NEEDS_OCTREE;
+		const bool SUPPORTS_RANGE;
+		const bool PARALLEL_SAFE;
 		
 		bool active;
 		bool local;
+		bool skippedInPrewarm;
 
 		virtual void init(Particle& particle,DataSet* dataSet) const {};
+
+		/**
+		* @brief Initializes the particles of the group within [start,end[
+		* This is called for bursts of born particles if CALL_INIT was set to true.
+		* The default implementation calls init(Particle&,DataSet*) for each particle.
+		* @param group : the group of particles
+		* @param dataSet : the associated dataset of the pair modifier/group. Will be NULL if NEEDS_DATASET is false
+		* @param start : the index of the first particle to initialize
+		* @param end : the index following the last particle to initialize
+		*/
+		virtual void initRange(Group& group,DataSet* dataSet,size_t start,size_t end) const;
+
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const = 0;
+
+		/**
+		* @brief Modifies the particles of the group within [start,end[
+		* This method is only called by the group if SUPPORTS_RANGE was set to true.
+		* @param group : the group of particles
+		* @param dataSet : the associated dataset of the pair modifier/group. Will be NULL if NEEDS_DATASET is false
+		* @param deltaTime : the time step
+		* @param start : the index of the first particle to modify
+		* @param end : the index following the last particle to modify
+		*/
+		virtual void modifyRange(Group&,DataSet*,float,size_t,size_t) const {};
 	};
 
-	inline Modifier::Modifier(unsigned int PRIORITY,bool NEEDS_DATASET,bool CALL_INIT,bool NEEDS_OCTREE) :
+	inline Modifier::Modifier(unsigned int PRIORITY,bool NEEDS_DATASET,bool CALL_INIT,bool NEEDS_OCTREE,bool SUPPORTS_RANGE,bool PARALLEL_SAFE) :
 		DataHandler(NEEDS_DATASET),
 		PRIORITY(PRIORITY),
 		CALL_INIT(CALL_INIT),
 		NEEDS_OCTREE(NEEDS_OCTREE),
+		SUPPORTS_RANGE(SUPPORTS_RANGE),
+		PARALLEL_SAFE(SUPPORTS_RANGE && PARALLEL_SAFE),
 		active(true),
-		local(false)
+		local(false),
+		skippedInPrewarm(false)
 	{}
 
 	inline void Modifier::setActive(bool active)
@@ -127,10 +197,30 @@ namespace SPK
 		return local;
 	}
 
+	inline void Modifier::setSkippedInPrewarm(bool skipped)
+	{
+		skippedInPrewarm = skipped;
+	}
+
+	inline bool Modifier::isSkippedInPrewarm() const
+	{
+		return skippedInPrewarm;
+	}
+
 	inline unsigned int Modifier::getPriority() const
 	{
 		return PRIORITY;
 	}
+
+	inline bool Modifier::supportsRange() const
+	{
+		return SUPPORTS_RANGE;
+	}
+
+	inline bool Modifier::isParallelSafe() const
+	{
+		return PARALLEL_SAFE;
+	}
 }
 
 #endif
@@ -0,0 +1,451 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_NEIGHBORSTRUCTURE
+#define H_SPK_NEIGHBORSTRUCTURE
+
+#include <vector>
+
+namespace SPK
+{
+	class Group;
+
+#ifdef SPK_DOXYGEN_ONLY // For documentation purpose only
+
+	/** Constants defining the structure used by a group to find the neighbors of its particles */
+	enum NeighborStructureType
+	{
+		NEIGHBOR_STRUCTURE_OCTREE,	/**< An octree whose cells are split as particles are added (see Octree) */
+		NEIGHBOR_STRUCTURE_GRID,	/**< A flat uniform grid built by a counting sort (see SpatialGrid) */
+	};
+
+#endif
+
+	#define SPK_ENUM_NEIGHBOR_STRUCTURE_TYPE(XX)	\
+		XX(NEIGHBOR_STRUCTURE_OCTREE,)				\
+		XX(NEIGHBOR_STRUCTURE_GRID,)
+
+	SPK_DECLARE_ENUM(NeighborStructureType,SPK_ENUM_NEIGHBOR_STRUCTURE_TYPE)
+
+	/**
+	* @brief An interface visiting the neighbors found by the queries of a NeighborStructure
+	*
+	* Modifiers working on the neighbors of particles (flocking, fluids...) implement this interface
+	* instead of traversing the cells of the structure themselves.
+	*/
+	class NeighborVisitor
+	{
+	public :
+
+		virtual ~NeighborVisitor() {}
+
+		/**
+		* @brief Visits a neighbor
+		* @param queryIndex : the index of the particle or of the point the query is performed for
+		* @param neighborIndex : the index of the neighboring particle
+		* @param sqrDist : the square distance between the particle or the point and the neighbor
+		*/
+		virtual void visit(size_t queryIndex,size_t neighborIndex,float sqrDist) = 0;
+	};
+
+	/**
+	* @brief A structure partitioning the space of a group in cells to find the neighbors of its particles
+	*
+	* At each update, every particle of the group is put into cells.<br>
+	* The neighbors of a particle are then looked for only in its neighboring cells instead of in the whole group.<br>
+	* <br>
+	* A neighbor structure is automatically generated within a group if at least one of its modifiers needs it (by setting its NEEDS_OCTREE constant to true at init).<br>
+	* The type of the structure is chosen per group (see Group::setNeighborStructureType(NeighborStructureType)).
+	* Modifiers only use the interface of this class and therefore work whatever the type of the structure.<br>
+	* <br>
+	* The contract of the interface is :
+	* <ul>
+	* <li>a particle lies in at least one of its neighboring cells</li>
+	* <li>two particles whose spheres (of radius Particle::getRadius()) intersect have at least one neighboring cell in common</li>
+	* <li>particles are ordered by index within a given cell</li>
+	* </ul>
+	* The structure is built in parallel if the parallel update of the group is enabled (see Group::enableParallelUpdate(bool)).
+	* Its content does not depend on the number of threads.<br>
+	* <br>
+	* On top of the cells, the structure answers queries whatever its type :
+	* <ul>
+	* <li>the pairs of particles closer than a distance (see queryPairs(float,NeighborVisitor&))</li>
+	* <li>the k nearest particles of each particle (see queryNearest(size_t,NeighborVisitor&))</li>
+	* <li>the particles closer than a distance or the k nearest particles of arbitrary points, either visited or written to buffers</li>
+	* </ul>
+	* The queries use buffers of the structure and must therefore not be performed concurrently on a same structure.
+	* They are valid as long as the particles have not moved since the last update of the structure (typically within Modifier::modify(Group&,DataSet*,float)).
+	*/
+	class SPK_PREFIX NeighborStructure
+	{
+	friend class Group;
+
+	public :
+
+		// A fast and simple self reallocating array (faster than generic std::vectors)
+		template<typename T>
+		class Array
+		{
+		public :
+
+			~Array<T>() { SPK_DELETE_ARRAY(values); }
+
+			size_t size() const					{ return currentNb; }
+			size_t capacity() const				{ return maxNb; }
+			bool empty() const					{ return currentNb == 0; }
+			T& operator[](size_t i)				{ return values[i]; }
+			const T& operator[](size_t i) const	{ return values[i]; }
+
+			void push(T t)
+			{
+				if (currentNb == maxNb)
+				{
+					// Reallocates
+					maxNb <<= 1;
+					T* tmp = SPK_NEW_ARRAY(T,maxNb);
+					for (size_t i = 0; i < currentNb; ++i)
+						tmp[i] = values[i];
+					SPK_DELETE_ARRAY(values);
+					values = tmp;
+				}
+
+				values[currentNb++] = t;
+			}
+
+			void clear() { currentNb = 0; }
+
+			void insert(size_t index,T t)
+			{
+				push(t);
+				for (size_t i = currentNb - 1; i > index; --i)
+					values[i] = values[i - 1];
+				values[index] = t;
+			}
+
+			void erase(size_t index)
+			{
+				--currentNb;
+				for (size_t i = index; i < currentNb; ++i)
+					values[i] = values[i + 1];
+			}
+
+			void resize(size_t nb)
+			{
+				if (nb > maxNb)
+				{
+					// Reallocates
+					maxNb = nb;
+					T* tmp = SPK_NEW_ARRAY(T,maxNb);
+					for (size_t i = 0; i < currentNb; ++i)
+						tmp[i] = values[i];
+					SPK_DELETE_ARRAY(values);
+					values = tmp;
+				}
+
+				currentNb = nb;
+			}
+
+		/*private*/public : // tmp workaround because I wasnt able to allows Cell to be friend of Array (compiler bug ?) but thats unsafe
+
+			size_t currentNb;
+			size_t maxNb;
+			T* values;
+
+			Array<T>(size_t maxNb = 1) :
+				currentNb(0),
+				maxNb(maxNb)
+			{
+				values = SPK_NEW_ARRAY(T,maxNb);
+			}
+
+			Array<T>(const Array<T>& t) :
+				currentNb(t.currentNb),
+				maxNb(t.maxNb)
+			{
+				values = SPK_NEW_ARRAY(T,maxNb);
+				for (size_t i = 0; i < currentNb; ++i)
+					values[i] = t.values[i];
+			} // Not called
+
+			// Not safe but optimized and hidden
+			Array& operator=(const Array& t)
+			{
+				currentNb = t.currentNb;
+				if (maxNb < currentNb) // Reallocates only if necessary
+				{
+					maxNb = t.maxNb;
+					SPK_DELETE_ARRAY(values);
+					values = SPK_NEW_ARRAY(T,maxNb);
+				}
+				for (size_t i = 0; i < currentNb; ++i)
+					values[i] = t.values[i];
+				return *this;
+			}
+		};
+
+		/**
+		* @brief Gets the type of this structure
+		* @return the type of this structure
+		*/
+		NeighborStructureType getType() const { return type; }
+
+		/**
+		* @brief Gets the array of active cells
+		* Active cells are cells of the structure that contains at least one particle
+		* @return active cells of the structure
+		*/
+		virtual const Array<size_t>& getActiveCells() const = 0;
+
+		/**
+		* @brief Gets the neighboring cells of a given particle
+		* The neighbors of a particle are the particles lying within its neighboring cells (see the class description).<br>
+		* The array passed is cleared and then filled with the indices of the neighboring cells.
+		* It is meant to be reused from one particle to another so that no allocation is performed.
+		* @param particleIndex : the index of the particle
+		* @param cells : the array receiving the indices of the neighboring cells
+		*/
+		virtual void getNeighborCells(size_t particleIndex,Array<size_t>& cells) const = 0;
+
+		/**
+		* @brief Gets the number of particles within a given cell
+		* @param cellIndex : the index of the cell
+		* @return the number of particles within the cell
+		*/
+		virtual size_t getNbParticlesInCell(size_t cellIndex) const = 0;
+
+		/**
+		* @brief Gets the indices of the particles within a given cell
+		* The indices are ordered by increasing index.
+		* @param cellIndex : the index of the cell
+		* @return the getNbParticlesInCell(size_t) indices of the particles within the cell
+		*/
+		virtual const size_t* getParticlesInCell(size_t cellIndex) const = 0;
+
+		/**
+		* @brief Gets the minimum position of the axis aligned bounding box of the structure
+		* @return the minimum position of the AABB
+		*/
+		const Vector3D& getAABBMin() const { return AABBMin; }
+
+		/**
+		* @brief Gets the maximum position of the axis aligned bounding box of the structure
+		* @return the maximum position of the AABB
+		*/
+		const Vector3D& getAABBMax() const { return AABBMax; }
+
+		/**
+		* @brief Gets the cells that may hold particles whose position is within a box
+		* Only the non empty cells are returned. Particles lying out of the structure are held by the cells on its border.<br>
+		* The array passed is cleared and then filled with the indices of the cells.
+		* @param boxMin : the minimum position of the box
+		* @param boxMax : the maximum position of the box
+		* @param cells : the array receiving the indices of the cells
+		*/
+		virtual void getCellsInBox(const Vector3D& boxMin,const Vector3D& boxMax,Array<size_t>& cells) const = 0;
+
+		/**
+		* @brief Visits each pair of particles closer than a given distance
+		* Each pair is visited once with the greatest index as the query index.
+		* @param radius : the distance between the particles
+		* @param visitor : the visitor of the pairs
+		*/
+		void queryPairs(float radius,NeighborVisitor& visitor) const;
+
+		/**
+		* @brief Visits the k nearest particles of each particle
+		* The particle itself is excluded. The neighbors of a particle are visited by increasing distance.<br>
+		* Note that two particles may be visited twice as the relation is not symmetric.
+		* @param k : the number of neighbors per particle
+		* @param visitor : the visitor of the neighbors
+		*/
+		void queryNearest(size_t k,NeighborVisitor& visitor) const;
+
+		/**
+		* @brief Visits the particles closer than a given distance of several points
+		* The query index passed to the visitor is the index of the point.
+		* @param points : the points
+		* @param nbPoints : the number of points
+		* @param radius : the distance from the points
+		* @param visitor : the visitor of the neighbors
+		*/
+		void queryRadius(const Vector3D* points,size_t nbPoints,float radius,NeighborVisitor& visitor) const;
+
+		/**
+		* @brief Gets the particles closer than a given distance of several points
+		* The indices of the neighbors of the point i are written in neighbors at [starts[i],starts[i + 1][.
+		* @param points : the points
+		* @param nbPoints : the number of points
+		* @param radius : the distance from the points
+		* @param neighbors : the vector receiving the indices of the neighbors
+		* @param starts : the vector receiving the start of the neighbors of each point (nbPoints + 1 values)
+		*/
+		void queryRadius(const Vector3D* points,size_t nbPoints,float radius,std::vector<size_t>& neighbors,std::vector<size_t>& starts) const;
+
+		/**
+		* @brief Gets the particles closer than a given distance of a point
+		* @param point : the point
+		* @param radius : the distance from the point
+		* @param neighbors : the vector receiving the indices of the neighbors
+		* @return the number of neighbors
+		*/
+		size_t queryRadius(const Vector3D& point,float radius,std::vector<size_t>& neighbors) const;
+
+		/**
+		* @brief Visits the k nearest particles of several points
+		* The query index passed to the visitor is the index of the point. The neighbors of a point are visited by increasing distance.
+		* @param points : the points
+		* @param nbPoints : the number of points
+		* @param k : the number of neighbors per point
+		* @param visitor : the visitor of the neighbors
+		*/
+		void queryNearest(const Vector3D* points,size_t nbPoints,size_t k,NeighborVisitor& visitor) const;
+
+		/**
+		* @brief Gets the k nearest particles of several points
+		* The indices of the neighbors of the point i are written by increasing distance in neighbors at [starts[i],starts[i + 1][.
+		* There are less than k neighbors per point only if the structure indexes less than k particles
+		* (the particles born since the last update of the structure are not indexed) or if the point is not finite.
+		* @param points : the points
+		* @param nbPoints : the number of points
+		* @param k : the number of neighbors per point
+		* @param neighbors : the vector receiving the indices of the neighbors
+		* @param starts : the vector receiving the start of the neighbors of each point (nbPoints + 1 values)
+		*/
+		void queryNearest(const Vector3D* points,size_t nbPoints,size_t k,std::vector<size_t>& neighbors,std::vector<size_t>& starts) const;
+
+		/**
+		* @brief Gets the k nearest particles of a point
+		* @param point : the point
+		* @param k : the number of neighbors
+		* @param neighbors : the vector receiving the indices of the neighbors by increasing distance
+		* @return the number of neighbors
+		*/
+		size_t queryNearest(const Vector3D& point,size_t k,std::vector<size_t>& neighbors) const;
+
+	protected :
+
+		static const size_t PARALLEL_GRAIN_SIZE = 4096; // The number of particles of a chunk
+
+		// A pass of the update working on a range of chunks of particles.
+		// Passes are executed chunk by chunk whether they are parallel or not so that the results do not depend on the threads
+		template<typename T>
+		class Pass : public RangeTask
+		{
+		public :
+
+			typedef void (T::*Function)(size_t,size_t);
+
+			Pass(T& structure,Function function) : structure(structure),function(function) {}
+			virtual void execute(size_t startChunk,size_t endChunk) { (structure.*function)(startChunk,endChunk); }
+
+		private :
+
+			T& structure;
+			Function function;
+		};
+
+		Group& group;
+
+		Vector3D AABBMin;
+		Vector3D AABBMax;
+
+		// Neighbor structure life time is managed by Group
+		NeighborStructure(Group& group,NeighborStructureType type);
+		virtual ~NeighborStructure() {}
+
+		template<typename T>
+		static void executePass(T& structure,typename Pass<T>::Function function,size_t nbChunks,TaskScheduler* taskScheduler);
+
+		// The particles of the chunk i are in [getChunkStart(i),getChunkStart(i + 1)[
+		size_t getNbChunks() const;
+		size_t getChunkStart(size_t chunk) const;
+
+		// Computes the AABB of the particles, the radius of the biggest one and the sum of their radii
+		void computeBounds(float& maxRadius,float& radiusSum,TaskScheduler* taskScheduler);
+
+	private :
+
+		struct Bounds
+		{
+			Vector3D AABBMin;
+			Vector3D AABBMax;
+			float maxRadius;
+			float radiusSum;
+		};
+
+		// A particle found by a query
+		struct Neighbor
+		{
+			size_t index;
+			float sqrDist;
+
+			bool operator<(const Neighbor& neighbor) const
+			{
+				return sqrDist < neighbor.sqrDist || (sqrDist == neighbor.sqrDist && index < neighbor.index);
+			}
+		};
+
+		static const float MIN_QUERY_RADIUS;
+
+		const NeighborStructureType type;
+
+		std::vector<Bounds> chunkBounds;
+
+		// Buffers of the queries
+		mutable std::vector<size_t> queryMarks; // Last query having found each particle, so that particles lying in several cells are found once
+		mutable size_t queryStamp;
+		mutable Array<size_t> queryCells;
+		mutable std::vector<Neighbor> queryNeighbors;
+
+		NeighborStructure(const NeighborStructure& structure); // never used
+		NeighborStructure& operator=(const NeighborStructure& structure); // never used
+
+		// Used by Group only. The task scheduler is NULL if the structure is not built in parallel
+		virtual void update(TaskScheduler* taskScheduler) = 0;
+
+		void computeChunkBounds(size_t startChunk,size_t endChunk);
+
+		// Fills queryNeighbors with the particles of index in [0,endIndex[ closer than radius, except the excluded one
+		void gatherNeighbors(const Vector3D& point,float radius,size_t endIndex,size_t excludedIndex) const;
+
+		// Fills queryNeighbors with the k nearest particles by increasing distance, except the excluded one
+		void gatherNearest(const Vector3D& point,size_t k,size_t excludedIndex) const;
+	};
+
+	inline NeighborStructure::NeighborStructure(Group& group,NeighborStructureType type) :
+		group(group),
+		type(type),
+		queryStamp(0),
+		queryCells(8)
+	{}
+
+	template<typename T>
+	void NeighborStructure::executePass(T& structure,typename Pass<T>::Function function,size_t nbChunks,TaskScheduler* taskScheduler)
+	{
+		Pass<T> pass(structure,function);
+		if (taskScheduler != NULL && nbChunks > 1)
+			taskScheduler->parallelFor(pass,0,nbChunks,1);
+		else
+			pass.execute(0,nbChunks);
+	}
+}
+
+#endif
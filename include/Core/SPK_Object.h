@@ -24,6 +24,9 @@
 
 #include <string>
 #include <map>
+#ifdef SPK_ATOMIC_REFERENCES
+#include <atomic>
+#endif
 
 namespace SPK
 {
@@ -132,7 +135,11 @@ namespace SPK
 
 		std::string name;
 
+#ifdef SPK_ATOMIC_REFERENCES
+		std::atomic<unsigned int> nbReferences; // References may be taken and released from several threads at once (see SPK_Config.h)
+#else
 		unsigned int nbReferences;
+#endif
 
 		const SharePolicy SHARE_POLICY;
 		bool shared;
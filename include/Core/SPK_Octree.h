@@ -36,91 +36,25 @@ namespace SPK
 	* Octrees allows optimization of algorithms that run in O(n) by reducing their complexity to O(nlog(n)).<br>
 	* Typically algorithms where each particle is affected by every other particles in the group (particle vs particle collision, flocking, nbody simulations...).<br>
 	* <br>
-	* A Octree is automatically generated within a group if at least one of its modifiers needs it (by setting its NEEDS_OCTREE constant to true at init).<br>
-	* If no more modifiers need an octree and an octree exists within the group, it is deleted.
+	* A Octree is automatically generated within a group if at least one of its modifiers needs it (by setting its NEEDS_OCTREE constant to true at init)
+	* and if the octree is the neighbor structure of the group (which is the default, see Group::setNeighborStructureType(NeighborStructureType)).<br>
+	* If no more modifiers need an octree and an octree exists within the group, it is deleted.<br>
+	* <br>
+	* The depth of the octree, the number of particles per cell and the size of the cells are set per group
+	* (see Group::setOctreeMaxLevel(unsigned int), Group::setOctreeMaxParticlesPerCell(unsigned int) and Group::setOctreeCellSizeFactor(float)).<br>
+	* <br>
+	* By default, the octree is rebuilt completely at each update.
+	* When the incremental update is enabled (see Group::enableIncrementalOctree(bool)), the cells of the previous update are kept
+	* and only the particles whose range of cells changed are removed from their cells and added back.
+	* The octree is still rebuilt when the bounds of the group moved away from the ones of the last rebuild (see Group::setOctreeRebuildThreshold(float)).<br>
+	* Meanwhile the bounds of the octree are the ones of the last rebuild and particles that moved out of them lie in the cells on its border.
 	*/
-	class SPK_PREFIX Octree
+	class SPK_PREFIX Octree : public NeighborStructure
 	{
 	friend class Group;
 
 	public :
 
-        class Cell;
-
-        // A fast and simple self reallocating array (faster than generic std::vectors)
-		template<typename T>
-		class Array
-		{
-		friend class Octree;
-		friend class Cell;
-
-		public :
-
-			~Array<T>() { SPK_DELETE_ARRAY(values); }
-
-			size_t size() const					{ return currentNb; }
-			size_t capacity() const				{ return maxNb; }
-			bool empty() const					{ return currentNb == 0; }
-			T& operator[](size_t i)				{ return values[i]; }
-			const T& operator[](size_t i) const	{ return values[i]; }
-
-			void push(T t)
-			{
-				if (currentNb == maxNb)
-				{
-					// Reallocates
-					maxNb <<= 1;
-					T* tmp = SPK_NEW_ARRAY(T,maxNb);
-					for (size_t i = 0; i < currentNb; ++i)
-						tmp[i] = values[i];
-					SPK_DELETE_ARRAY(values);
-					values = tmp;
-				}
-
-				values[currentNb++] = t;
-			}
-
-			void clear() { currentNb = 0; }
-
-		/*private*/public : // tmp workaround because I wasnt able to allows Cell to be friend of Array (compiler bug ?) but thats unsafe
-
-			size_t currentNb;
-			size_t maxNb;
-			T* values;
-
-			Array<T>(size_t maxNb = 1) :
-				currentNb(0),
-				maxNb(maxNb)
-			{
-				values = SPK_NEW_ARRAY(T,maxNb);
-			}
-
-			Array<T>(const Array<T>& t) :
-				currentNb(t.currentNb),
-				maxNb(t.maxNb)
-			{
-				values = SPK_NEW_ARRAY(T,maxNb);
-				for (size_t i = 0; i < currentNb; ++i)
-					values[i] = t.values[i];
-			} // Not called
-
-			// Not safe but optimized and hidden
-			Array& operator=(const Array& t)
-			{
-				currentNb = t.currentNb;
-				if (maxNb < currentNb) // Reallocates only if necessary
-				{
-					maxNb = t.maxNb;
-					SPK_DELETE_ARRAY(values);
-					values = SPK_NEW_ARRAY(T,maxNb);
-				}
-				for (size_t i = 0; i < currentNb; ++i)
-					values[i] = t.values[i];
-				return *this;
-			}
-		};
-
-
 		class Cell
 		{
 		friend class Octree;
@@ -154,7 +88,7 @@ namespace SPK
 				offsetY(offsetY),
 				offsetZ(offsetZ),
 				hasChildren(false),
-				particles(MAX_PARTICLES_NB_PER_CELL)
+				particles(DEFAULT_MAX_PARTICLES_NB_PER_CELL)
 			{}
 
 			// Not safe but optimized and hidden
@@ -164,7 +98,7 @@ namespace SPK
 				offsetY(cell.offsetY),
 				offsetZ(cell.offsetZ),
 				hasChildren(false),
-				particles(MAX_PARTICLES_NB_PER_CELL)
+				particles(DEFAULT_MAX_PARTICLES_NB_PER_CELL)
 			{} // Not called
 
 			// Not safe but optimized and hidden
@@ -186,7 +120,7 @@ namespace SPK
 		* Active cells are cells of the octree that contains at least one particle
 		* @return active cells of the octree
 		*/
-		const Array<size_t>& getActiveCells() const							{ return activeCells; }
+		virtual const Array<size_t>& getActiveCells() const					{ return activeCells; }
 
 		/**
 		* @brief Gets the neighboring cells of a given particle
@@ -198,6 +132,11 @@ namespace SPK
 		*/
 		const Array<size_t>& getNeighborCells(size_t particleIndex) const	{ return particleCells[particleIndex]; }
 
+		virtual void getNeighborCells(size_t particleIndex,Array<size_t>& neighborCells) const	{ neighborCells = particleCells[particleIndex]; }
+		virtual size_t getNbParticlesInCell(size_t cellIndex) const						{ return cells[cellIndex].particles.size(); }
+		virtual const size_t* getParticlesInCell(size_t cellIndex) const				{ return cells[cellIndex].particles.values; }
+		virtual void getCellsInBox(const Vector3D& boxMin,const Vector3D& boxMax,Array<size_t>& cells) const;
+
 		/**
 		* @brief Gets a given cell by index
 		* @param index : the index of the cell
@@ -205,19 +144,20 @@ namespace SPK
 		*/
 		const Cell& getCell(size_t index) const								{ return cells[index]; }
 
-		/**
-		* @brief Gets the minimum position of the axis aligned bounding box of the octree
-		* @return the minimum position of the AABB
-		*/
-		const Vector3D& getAABBMin() const { return AABBMin; }
+		/** @brief The default maximum level of the octree */
+		static const size_t DEFAULT_MAX_LEVEL_INDEX;
 
-		/**
-		* @brief Gets the maximum position of the axis aligned bounding box of the octree
-		* @return the maximum position of the AABB
-		*/
-		const Vector3D& getAABBMax() const { return AABBMax; }
+		/** @brief The maximum level of the octree that can be set (a too high number will be highly memory consuming) */
+		static const size_t MAX_LEVEL_INDEX_LIMIT;
+
+		/** @brief The default number of particles above which a cell is split */
+		static const size_t DEFAULT_MAX_PARTICLES_NB_PER_CELL;
 
-		// TODO Allows to tweak the octree param
+		/** @brief The default minimum size of the cells relative to the mean radius of the particles */
+		static const float DEFAULT_CELL_SIZE_FACTOR;
+
+		/** @brief The default displacement of the bounds of the group triggering a rebuild of an incremental octree */
+		static const float DEFAULT_REBUILD_THRESHOLD;
 
 	private :
 
@@ -231,15 +171,15 @@ namespace SPK
 				value[1] = static_cast<int>(v.y);
 				value[2] = static_cast<int>(v.z);
 			}
+
+			bool operator!=(const Triplet& t) const
+			{
+				return value[0] != t.value[0] || value[1] != t.value[1] || value[2] != t.value[2];
+			}
 		};
 
-		static const size_t MAX_LEVEL_INDEX;
-		static const size_t MAX_PARTICLES_NB_PER_CELL;
-		static const float OPTIMAL_CELL_SIZE_FACTOR;
 		static const float MIN_CELL_SIZE;
 
-		Group& group;
-
 		Array<Cell> cells; // Pool of cells
 		size_t nbCells;
 
@@ -251,8 +191,25 @@ namespace SPK
 		Triplet* minPos;
 		Triplet* maxPos;
 
-		Vector3D AABBMin;
-		Vector3D AABBMax;
+		Vector3D ratio; // Number of cells of the deepest level per unit
+		size_t maxLevel;
+
+		// Parameters of the group at the last rebuild
+		size_t maxLevelIndex;
+		size_t maxParticlesPerCell;
+		float cellSizeFactor;
+
+		// Incremental update
+		Triplet* previousMinPos;
+		Triplet* previousMaxPos;
+		size_t nbBinnedParticles; // Number of particles in the cells (0 forces a rebuild)
+		Vector3D rebuildAABBMin; // Bounds of the particles at the last rebuild
+		Vector3D rebuildAABBMax;
+		Vector3D cellsAABBMin; // Bounds of the octree at the last rebuild
+		Vector3D cellsAABBMax;
+		Array<size_t> rebinnedParticles; // Particles whose cells changed during the incremental update
+		bool* rebinned;
+		bool tracksRebinnedParticles;
 
 		// Octree life time is managed by Group
 		Octree(const Ref<Group>& group);
@@ -261,11 +218,23 @@ namespace SPK
 		Octree(const Octree& octree); // never used
 		Octree& operator=(const Octree& octree); // never used
 
-		void update();  // Used by Group only
+		virtual void update(TaskScheduler* taskScheduler);  // Used by Group only
+
+		bool needsRebuild() const;
+		void rebuild(float meanRadius,TaskScheduler* taskScheduler);
+		void updateIncrementally(TaskScheduler* taskScheduler);
+
+		void computeParticleRanges(size_t startChunk,size_t endChunk);
+		void computeParticleCells(size_t startChunk,size_t endChunk);
+		void computeCellsOf(size_t particleIndex);
 
 		size_t initNextCell(size_t level,size_t offsetX,size_t offsetY,size_t offsetZ);
-		void addToCell(size_t cellIndex,size_t particleIndex,size_t maxLevel);
-		void addToChildrenCells(size_t parentIndex,size_t particleIndex,size_t maxLevel);
+		void addToCell(size_t cellIndex,size_t particleIndex);
+		void addToChildrenCells(size_t parentIndex,size_t particleIndex);
+		void removeFromCells(size_t particleIndex);
+		void markRebinned(size_t particleIndex);
+		void addCellsOf(size_t cellIndex,const Triplet& min,const Triplet& max,Array<size_t>& neighborCells) const;
+		void getChildrenRange(const Cell& parent,const Triplet& min,const Triplet& max,int* minIndex,int* maxIndex) const;
 	};
 }
 
@@ -43,6 +43,8 @@ namespace SPK
 	friend class Iterator;
 	template<typename T>
 	friend class ConstIterator;
+	template<typename T>
+	friend class ConstSortedIterator;
 
 	public :
 
@@ -230,16 +232,19 @@ namespace SPK
 
 	inline Vector3D& Particle::position()
 	{
+		group.writeVectors(Group::VECTOR_ARRAY_POSITIONS,index);
 		return group.particleData.positions[index];
 	}
 
 	inline Vector3D& Particle::velocity()
 	{
+		group.writeVectors(Group::VECTOR_ARRAY_VELOCITIES,index);
 		return group.particleData.velocities[index];
 	}
 
 	inline Vector3D& Particle::oldPosition()
 	{
+		group.writeVectors(Group::VECTOR_ARRAY_OLD_POSITIONS,index);
 		return group.particleData.oldPositions[index];
 	}
 
@@ -276,16 +281,19 @@ namespace SPK
 
 	inline const Vector3D& Particle::position() const
 	{
+		group.readVectors(Group::VECTOR_ARRAY_POSITIONS);
 		return group.particleData.positions[index];
 	}
 
 	inline const Vector3D& Particle::velocity() const
 	{
+		group.readVectors(Group::VECTOR_ARRAY_VELOCITIES);
 		return group.particleData.velocities[index];
 	}
 
 	inline const Vector3D& Particle::oldPosition() const
 	{
+		group.readVectors(Group::VECTOR_ARRAY_OLD_POSITIONS);
 		return group.particleData.oldPositions[index];
 	}
 
@@ -347,6 +355,17 @@ namespace SPK
 		group.particleData.energies[index] = 0.0f;
 		group.particleData.ages[index] = group.particleData.lifeTimes[index];
 	}
+
+	// Defined here as the definitions of Group and Particle are needed
+	template<typename T>
+	void Interpolator<T>::initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const
+	{
+		for (size_t i = start; i < end; ++i)
+		{
+			Particle particle(group.getParticle(i));
+			init(data[i],particle,dataSet);
+		}
+	}
 }
 
 #endif
@@ -123,7 +123,7 @@ namespace SPK
 
 	private :
 
-		// TODO In order to be thread safe, nbReferences must be volatile and increment/decrement must be atomic
+		// nbReferences is only atomic if SPK_ATOMIC_REFERENCES is defined (see SPK_Config.h), references must not be taken concurrently otherwise
 		void increment() { if (ptr != NULL) ++(ptr->nbReferences); }
 		void decrement() { if (ptr != NULL && --(ptr->nbReferences) == 0) SPK_DELETE(ptr); }
 
@@ -136,7 +136,23 @@ namespace SPK
 		virtual  RenderBuffer* attachRenderBuffer(const Group& group) const;
 
 		virtual  void init(const Particle& particle,DataSet* dataSet) const {};
-		virtual  void update(const Group& group,DataSet* dataSet) const {};
+
+		/**
+		* @brief Initializes the particles of the group within [start,end[
+		* This is called for bursts of born particles. The default implementation calls init(const Particle&,DataSet*) for each particle.
+		* @param group : the group of particles
+		* @param dataSet : the associated dataset of the pair renderer/group. Will be NULL if NEEDS_DATASET is false
+		* @param start : the index of the first particle to initialize
+		* @param end : the index following the last particle to initialize
+		*/
+		virtual void initRange(const Group& group,DataSet* dataSet,size_t start,size_t end) const;
+		/**
+		* @brief Updates the data of the renderer for the particles of the group
+		* This is called at most once per update of the system. The time elapsed since the last call can be got with Group::getRendererDeltaTime().
+		* @param group : the group of particles
+		* @param dataSet : the associated dataset of the pair renderer/group. Will be NULL if NEEDS_DATASET is false
+		*/
+		virtual  void update(const Group&,DataSet*) const {};
 
 		virtual void render(const Group& group,const DataSet* dataSet,RenderBuffer* renderBuffer) const = 0;
 		virtual void computeAABB(Vector3D& AABBMin,Vector3D& AABBMax,const Group& group,const DataSet* dataSet) const = 0;
@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_SIMD
+#define H_SPK_SIMD
+
+namespace SPK
+{
+/**
+* @brief Kernels processing streams of floats used for the update of particles
+*
+* The kernels use SSE instructions when available (define SPK_NO_SIMD to disable them) and fall back to scalar code otherwise.<br>
+* All kernels work on the range [start,end[ of the arrays passed and give the same results than their scalar counterparts.
+* As ranges may start anywhere, the kernels use unaligned loads and stores. gather() and scatter() are scalar.
+*/
+namespace SIMD
+{
+/** @brief The number of floats in the SSE registers used by the kernels. Split arrays are padded to a multiple of it */
+const size_t WIDTH = 4;
+
+/** @brief The alignment in bytes of split arrays */
+const size_t ALIGNMENT = WIDTH * sizeof(float);
+
+/**
+* @brief Gets the number of floats to allocate to hold the given number of floats once padded
+* @param nb : the number of floats
+* @return nb rounded up to a multiple of WIDTH
+*/
+size_t getPaddedSize(size_t nb);
+
+/**
+* @brief Allocates an array of floats aligned to ALIGNMENT and padded to a multiple of WIDTH
+* @param nb : the number of floats of the array
+* @return the allocated array
+*/
+SPK_PREFIX float* allocate(size_t nb);
+
+/**
+* @brief Deallocates an array allocated with allocate(size_t)
+* @param array : the array to deallocate (may be NULL)
+*/
+SPK_PREFIX void deallocate(float* array);
+
+/** @brief ages[i] += deltaTime */
+SPK_PREFIX void updateAges(float* ages,size_t start,size_t end,float deltaTime);
+
+/** @brief energies[i] = 1.0f - ages[i] / lifeTimes[i] */
+SPK_PREFIX void computeEnergies(float* energies,const float* ages,const float* lifeTimes,size_t start,size_t end);
+
+/** @brief oldPositions[i] = positions[i] and positions[i] += velocities[i] * deltaTime */
+SPK_PREFIX void integrate(float* positions,float* oldPositions,const float* velocities,size_t start,size_t end,float deltaTime);
+
+/** @brief sqrDists[i] = square distance between (x[i],y[i],z[i]) and point */
+SPK_PREFIX void computeSqrDists(float* sqrDists,const float* x,const float* y,const float* z,size_t start,size_t end,const Vector3D& point);
+
+/**
+* @brief Finds the spheres of center (x[i],y[i],z[i]) intersecting a sphere
+* Spheres intersect if their square distance is lower than (radius + radii[i])^2 * sqrScale.
+* The indices of the intersecting spheres are written in increasing order to indices.
+* @return the number of indices written
+*/
+SPK_PREFIX size_t findIntersections(size_t* indices,const float* x,const float* y,const float* z,const float* radii,size_t start,size_t end,const Vector3D& point,float radius,float sqrScale);
+
+/** @brief Merges the minimum and maximum values of the range within min and max */
+SPK_PREFIX void computeMinMax(const float* values,size_t start,size_t end,float& min,float& max);
+
+/** @brief values[i] = random float within [min,max[ being the number (counter + i - start) of the stream of the given key (see RandomStream) */
+SPK_PREFIX void fillRandom(float* values,size_t start,size_t end,uint32 key,uint32 counter,float min,float max);
+
+/** @brief Copies split coordinates to an array of vectors */
+SPK_PREFIX void gather(Vector3D* vectors,const float* x,const float* y,const float* z,size_t start,size_t end);
+
+/** @brief Copies an array of vectors to split coordinates */
+SPK_PREFIX void scatter(const Vector3D* vectors,float* x,float* y,float* z,size_t start,size_t end);
+
+inline size_t getPaddedSize(size_t nb)
+{
+	return (nb + WIDTH - 1) / WIDTH * WIDTH;
+}
+}}
+
+#endif
@@ -0,0 +1,159 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_SPATIALGRID
+#define H_SPK_SPATIALGRID
+
+#include <vector>
+
+namespace SPK
+{
+	/**
+	* @brief A flat uniform grid partitioning the space of a group
+	*
+	* The grid is an alternative to the Octree (see Group::setNeighborStructureType(NeighborStructureType)).<br>
+	* Instead of splitting cells recursively, it is rebuilt at each update by a counting sort of the particles by cell in two linear passes :
+	* <ul>
+	* <li>the first pass computes the cell of each particle and counts the particles per cell</li>
+	* <li>the second pass places the indices of the particles in a single flat array ordered by cell</li>
+	* </ul>
+	* When built in parallel, the particles are sorted by cell with a radix sort whose passes are split in chunks of particles instead.
+	* Both sorts are stable so the cells hold the same particles in the same order.<br>
+	* No allocation is performed once the arrays have grown to the size of the group.<br>
+	* <br>
+	* A particle only lies in the cell of its center.
+	* Its neighboring cells are the cells intersected by its sphere enlarged by the radius of the biggest particle.
+	* The size of the cells is twice the diameter of the biggest particle so that there are at most 2x2x2 neighboring cells.<br>
+	* The cells are indexed by the Morton code of their coordinates (the bits of the coordinates are interleaved)
+	* so that cells close in space are close in memory.<br>
+	* <br>
+	* The grid suits groups of particles of similar sizes. Groups of particles of very different sizes are better handled by the octree.
+	*/
+	class SPK_PREFIX SpatialGrid : public NeighborStructure
+	{
+	friend class Group;
+
+	public :
+
+		virtual const Array<size_t>& getActiveCells() const { return activeCells; }
+		virtual void getNeighborCells(size_t particleIndex,Array<size_t>& cells) const;
+		virtual size_t getNbParticlesInCell(size_t cellIndex) const;
+		virtual const size_t* getParticlesInCell(size_t cellIndex) const;
+		virtual void getCellsInBox(const Vector3D& boxMin,const Vector3D& boxMax,Array<size_t>& cells) const;
+
+		/**
+		* @brief Gets the size of the cells of the grid
+		* @return the size of the cells
+		*/
+		float getCellSize() const { return cellSize; }
+
+		/**
+		* @brief Gets the number of cells of the grid along an axis
+		* @param axis : the axis (0 for x, 1 for y and 2 for z)
+		* @return the number of cells along the axis
+		*/
+		size_t getDimension(size_t axis) const { return dimensions[axis]; }
+
+	private :
+
+		// The coordinates of the cell of a particle
+		struct Coordinates
+		{
+			unsigned int value[3];
+			unsigned char lowerNeighbors; // Bit i is set if the cell before along the axis i is a neighboring cell
+			unsigned char upperNeighbors; // Bit i is set if the cell after along the axis i is a neighboring cell
+		};
+
+		static const size_t MAX_CELLS_PER_PARTICLE;
+		static const float MIN_CELL_SIZE;
+		static const size_t RADIX_NB_BITS; // The number of bits of the cell indices sorted by a pass of the radix sort
+
+		size_t nbParticles;
+
+		Coordinates* particleCoordinates;	// Cell coordinates of the particles
+		size_t* sortKeys[2];				// Cell indices of the particles (by particle index and then ordered by cell)
+		size_t* sortIndices[2];				// Indices of the particles ordered by cell
+		size_t* sortedParticles;			// Points to the sorted indices
+
+		// Start of the particles of each cell in sortedParticles (the particles of the cell i are in [cellStarts[i],cellStarts[i + 1][)
+		std::vector<size_t> cellStarts;
+
+		// Morton code of a coordinate along each axis. The index of a cell is the bitwise or of the codes of its coordinates
+		std::vector<size_t> mortonCodes[3];
+
+		Array<size_t> activeCells;
+
+		float cellSize;
+		size_t dimensions[3];
+		size_t nbCellBits;
+
+		float maxRadius;
+
+		// State of the parallel radix sort
+		size_t radixShift;
+		size_t sortBuffer;
+		std::vector<size_t> radixOffsets;		// Offsets of the digits per chunk
+		std::vector<size_t> chunkNbActiveCells;	// Index of the first active cell of each chunk
+
+		// Grid life time is managed by Group
+		SpatialGrid(const Ref<Group>& group);
+		~SpatialGrid();
+
+		SpatialGrid(const SpatialGrid& grid); // never used
+		SpatialGrid& operator=(const SpatialGrid& grid); // never used
+
+		virtual void update(TaskScheduler* taskScheduler); // Used by Group only
+
+		void computeDimensions();
+		void computeMortonCodes();
+
+		void computeCells(size_t startChunk,size_t endChunk);
+
+		void countingSort(size_t nbCells);
+		void radixSort(size_t nbCells,TaskScheduler* taskScheduler);
+
+		// Passes of the radix sort
+		void countDigits(size_t startChunk,size_t endChunk);
+		void placeDigits(size_t startChunk,size_t endChunk);
+		void computeCellStarts(size_t startChunk,size_t endChunk);
+		void countActiveCells(size_t startChunk,size_t endChunk);
+		void writeActiveCells(size_t startChunk,size_t endChunk);
+
+		size_t getCellIndex(const Coordinates& coordinates) const;
+	};
+
+	inline size_t SpatialGrid::getNbParticlesInCell(size_t cellIndex) const
+	{
+		return cellStarts[cellIndex + 1] - cellStarts[cellIndex];
+	}
+
+	inline const size_t* SpatialGrid::getParticlesInCell(size_t cellIndex) const
+	{
+		return sortedParticles + cellStarts[cellIndex];
+	}
+
+	inline size_t SpatialGrid::getCellIndex(const Coordinates& coordinates) const
+	{
+		return mortonCodes[0][coordinates.value[0]] | mortonCodes[1][coordinates.value[1]] | mortonCodes[2][coordinates.value[2]];
+	}
+}
+
+#endif
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_SPAWNQUEUE
+#define H_SPK_SPAWNQUEUE
+
+namespace SPK
+{
+	class Zone;
+	class Emitter;
+
+	/** @brief A request of particles to spawn within a group (see Group::enqueueParticles(unsigned int,const Vector3D&,const Vector3D&,Zone*,Emitter*,bool)) */
+	struct SpawnRequest
+	{
+		unsigned int nb;	/**< The number of particles to spawn */
+		Vector3D position;	/**< The position of the particles if there is no zone */
+		Vector3D velocity;	/**< The velocity of the particles if there is no emitter */
+		Zone* zone;			/**< The zone generating the positions of the particles or NULL */
+		Emitter* emitter;	/**< The emitter generating the velocities of the particles or NULL */
+		bool full;			/**< true to generate the positions within the whole zone, false to generate them at its borders */
+	};
+
+	/**
+	* @brief A bounded lock-free queue of spawn requests
+	*
+	* Any number of threads can push requests concurrently while a single thread pops them.<br>
+	* Requests are stored within a ring allocated once so that pushing a request neither locks nor allocates memory.
+	* A push simply fails when the ring is full.<br>
+	* <br>
+	* If SPK_NO_THREADS is defined (see SPK_Config.h), the queue must be used from a single thread.
+	*/
+	class SPK_PREFIX SpawnQueue
+	{
+	public :
+
+		/**
+		* @brief Constructor of spawn queue
+		* @param capacity : the maximum number of pending requests (rounded up to a power of 2). 0 means that every push fails
+		*/
+		SpawnQueue(size_t capacity = 0);
+
+		~SpawnQueue();
+
+		/**
+		* @brief Sets the maximum number of pending requests of this queue
+		* The ring is allocated again and the pending requests are lost. This method must not be called while requests are pushed.
+		* @param capacity : the maximum number of pending requests (rounded up to a power of 2). 0 means that every push fails
+		*/
+		void setCapacity(size_t capacity);
+
+		/**
+		* @brief Gets the maximum number of pending requests of this queue
+		* @return the maximum number of pending requests
+		*/
+		size_t getCapacity() const;
+
+		/**
+		* @brief Pushes a request at the end of the queue
+		* This method can be called concurrently from any thread.
+		* @param request : the request to push
+		* @return true if the request was pushed, false if the queue is full
+		*/
+		bool push(const SpawnRequest& request);
+
+		/**
+		* @brief Pops requests from the front of the queue
+		* This method must only be called by a single thread at a time.
+		* @param requests : the array in which to copy the popped requests
+		* @param nb : the maximum number of requests to pop
+		* @return the number of requests popped
+		*/
+		size_t pop(SpawnRequest* requests,size_t nb);
+
+	private :
+
+		struct Impl;
+		Impl* impl;
+
+		SpawnQueue(const SpawnQueue&); // Not used
+		SpawnQueue& operator=(const SpawnQueue&); // Not used
+	};
+}
+
+#endif
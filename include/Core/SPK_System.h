@@ -59,6 +59,7 @@ namespace SPK
 	*/
 	class SPK_PREFIX System : public Transformable
 	{
+	friend class SystemPool;
 
 	public :
 
@@ -164,10 +165,33 @@ namespace SPK
 		*/
 		virtual bool updateParticles(float deltaTime);
 
+		/**
+		* @brief Waits for the end of the asynchronous update of this system
+		* Once joined, the results of the update are rendered (see enableAsyncUpdate(bool)). Nothing happens if no update is running.
+		*/
+		void joinUpdate();
+
+		/**
+		* @brief Fast forwards the particles in the system
+		*
+		* This allows effects to look already running when they appear (ambient smoke, snow...).<br>
+		* Only the simulation is performed, by steps of the given time : the renderers are not updated, the distances from the camera are not computed
+		* and the particles are not sorted. They are updated once at the end, as well as the AABB.<br>
+		* The step mode, the level of detail and the frustum sleeping are not used.<br>
+		* <br>
+		* The modifiers skipped in prewarm are not applied (see Modifier::setSkippedInPrewarm(bool)).
+		*
+		* @param duration : the time to fast forward in seconds
+		* @param step : the time step of the simulation in seconds
+		* @return true if the System is still active (has active groups)
+		*/
+		bool prewarm(float duration,float step);
+
 		/**
 		* @brief Renders particles in the System
 		*
-		* Note that this method renders all groups in the System from first to last.
+		* Note that this method renders all groups in the System from first to last.<br>
+		* With the asynchronous update, the state of the last joined update is rendered.
 		*/
 		virtual void renderParticles() const;
 
@@ -205,6 +229,62 @@ namespace SPK
 		*/
 		const Vector3D& getAABBMax() const;
 
+		/////////////////////
+		// Parallel update //
+		/////////////////////
+
+		/**
+		* @brief Enables or disables the concurrent update of the groups of this System
+		*
+		* When enabled and a TaskScheduler is set in the SPKContext, the groups of the system are updated concurrently on the threads of the scheduler.<br>
+		* The groups depending on each other are gathered in chains. A group adding particles to another one (see Modifier::getTargetGroups(std::vector<Group*>&)
+		* and Action::getTargetGroups(std::vector<Group*>&)) or sharing an emitter, a modifier or an action with it belongs to the same chain.
+		* The chains are updated concurrently, each one on a single thread, and the groups of a chain are updated in topological order :
+		* a group is updated after the groups adding particles to it (in the order of the system otherwise, or if they depend on each other).<br>
+		* Particles spawned by another group are therefore born within the same update. The order does not depend on the scheduler so the results
+		* are the same with or without threads, but they may differ from the ones of the serial update when a group adds particles to a group placed before it.<br>
+		* The configuration of a group must not be changed by the update of another group (from a custom action or modifier for instance) when enabled.<br>
+		* <br>
+		* Groups updated concurrently do not split their own update in ranges (see Group::enableParallelUpdate(bool)), only a single chain does.<br>
+		* The concurrent update is disabled by default.
+		*
+		* @param parallel : true to enable the concurrent update of the groups, false to disable it
+		*/
+		void enableParallelUpdate(bool parallel);
+
+		/**
+		* @brief Tells whether the concurrent update of the groups is enabled
+		* @return true if the concurrent update is enabled, false if it is disabled
+		*/
+		bool isParallelUpdateEnabled() const;
+
+		/**
+		* @brief Enables or disables the asynchronous update of this System
+		*
+		* When enabled, updateParticles(float) waits for the previous update (see joinUpdate()),
+		* starts the update on the scheduler of the context (see SPKContext::setTaskScheduler(TaskScheduler*)) and returns.
+		* The update runs in the background while the system is rendered, so that the simulation of a frame overlaps with the rendering of the previous one.<br>
+		* <br>
+		* Each group holds a render state made of its particles (positions, colors, parameters...) and of the data of its renderer.
+		* It is swapped in O(1) with the ones of the group once the update is joined and rendered while the group is updated again.
+		* The group then writes its particles in another block of memory, copying each tile from the render state right before updating it.
+		* When the update runs in the background, rendering is therefore one update behind the simulation.<br>
+		* Renderers keeping additional data per particle must support its copy (see Data::copyData(const Data&,size_t)).<br>
+		* <br>
+		* While an update is running, the system must not be modified nor read except for rendering.
+		* joinUpdate() must be called before. If there is no scheduler, the update is performed by updateParticles(float) on the calling thread.<br>
+		* The asynchronous update is disabled by default.
+		*
+		* @param async : true to enable the asynchronous update, false to disable it
+		*/
+		void enableAsyncUpdate(bool async);
+
+		/**
+		* @brief Tells whether the asynchronous update is enabled
+		* @return true if the asynchronous update is enabled, false if it is disabled
+		*/
+		bool isAsyncUpdateEnabled() const;
+
 		/////////////////////
 		// Camera position //
 		/////////////////////
@@ -226,6 +306,176 @@ namespace SPK
 		*/
 		const Vector3D& getCameraPosition();
 
+		/**
+		* @brief Gets the square distance between the camera position and the bounds of this system
+		* @return the square distance to the camera or 0 if the camera is within the bounds
+		*/
+		float getSqrDistanceToCamera() const;
+
+		////////////////////
+		// Level of detail //
+		////////////////////
+
+		/**
+		* @brief Adds a level of detail band to this System
+		*
+		* Level of detail bands reduce the update rate of the System function of its distance from the camera (see setCameraPosition(const Vector3D&)).<br>
+		* The band used is the one with the farthest distance lower than or equal to the distance of the System.
+		* The distance of the System is the distance between the camera and its AABB if the AABB computation is enabled, or its position otherwise.<br>
+		* <br>
+		* Within a band, the System is updated every updateInterval frames with the delta times accumulated since its last update.
+		* The update of the renderers and the sorting of the particles can be skipped as well for distant systems.<br>
+		* When the System is closer than all the bands or has no band, it is updated every frame.
+		*
+		* @param distance : the distance from which the band is used
+		* @param updateInterval : the System is updated every updateInterval frames within the band
+		* @param rendererUpdate : true to update the renderers within the band, false to skip their update
+		* @param sorting : true to sort the particles within the band, false to skip the sorting
+		*/
+		void addLODBand(float distance,unsigned int updateInterval,bool rendererUpdate = true,bool sorting = true);
+
+		/**
+		* @brief Removes a level of detail band from this System
+		* @param index : the index of the band to remove
+		*/
+		void removeLODBand(unsigned int index);
+
+		/** @brief Removes all the level of detail bands of this System */
+		void clearLODBands();
+
+		/**
+		* @brief Gets the number of level of detail bands of this System
+		* @return the number of level of detail bands
+		*/
+		unsigned int getNbLODBands() const;
+
+	public :
+		void createLODBand();
+		void setLODBandDistance(unsigned int index,float distance);
+		float getLODBandDistance(unsigned int index) const;
+		void setLODBandUpdateInterval(unsigned int index,unsigned int updateInterval);
+		unsigned int getLODBandUpdateInterval(unsigned int index) const;
+		void enableLODBandRendererUpdate(unsigned int index,bool rendererUpdate);
+		bool isLODBandRendererUpdateEnabled(unsigned int index) const;
+		void enableLODBandSorting(unsigned int index,bool sorting);
+		bool isLODBandSortingEnabled(unsigned int index) const;
+
+		//////////////////////
+		// Frustum sleeping //
+		//////////////////////
+
+		/**
+		* @brief Sets the view frustum used to put this System to sleep when it is not visible
+		*
+		* Each plane is given by 4 floats (a,b,c,d) so that a point (x,y,z) is on the inner side of the plane when ax + by + cz + d >= 0
+		* (the planes extracted from a view projection matrix with the Gribb/Hartmann method can be passed directly).
+		* The planes must be in the same space than the camera position.<br>
+		* <br>
+		* When the AABB of the System (or its position if the AABB computation is disabled or the System is empty) is outside the frustum,
+		* the System sleeps : its update only accumulates the time.<br>
+		* When it becomes visible again, it catches up with the time slept by coarse steps (see setCatchUpStep(float)) without updating its renderers nor sorting its particles.
+		* The number of catch up steps per update is bounded (see setMaxCatchUpSteps(unsigned int)), the rest of the time is caught up at the next updates.<br>
+		* <br>
+		* Note that the AABB of a sleeping System is not updated, so it only wakes up when the frustum moves towards it.<br>
+		* The frustum culling is disabled by default. Passing 0 planes disables it.
+		*
+		* @param planes : an array of 4 * nbPlanes floats holding the planes of the frustum
+		* @param nbPlanes : the number of planes of the frustum
+		*/
+		void setFrustum(const float* planes,size_t nbPlanes);
+
+		/**
+		* @brief Tells whether this System was visible at its last update
+		* @return true if the System was within the frustum (or if there is no frustum), false otherwise
+		*/
+		bool isVisible() const;
+
+		/**
+		* @brief Gets the time slept by this System that is not caught up yet
+		* @return the time to catch up in seconds
+		*/
+		float getSleepTime() const;
+
+		/**
+		* @brief Sets the time step used to catch up with the time slept
+		* @param catchUpStep : the catch up step in seconds (0.1 by default)
+		*/
+		void setCatchUpStep(float catchUpStep);
+
+		/**
+		* @brief Gets the time step used to catch up with the time slept
+		* @return the catch up step in seconds
+		*/
+		float getCatchUpStep() const;
+
+		/**
+		* @brief Sets the maximum number of catch up steps per update
+		* @param maxCatchUpSteps : the maximum number of catch up steps per update (4 by default)
+		*/
+		void setMaxCatchUpSteps(unsigned int maxCatchUpSteps);
+
+		/**
+		* @brief Gets the maximum number of catch up steps per update
+		* @return the maximum number of catch up steps per update
+		*/
+		unsigned int getMaxCatchUpSteps() const;
+
+		/**
+		* @brief Sets the maximum time slept to catch up
+		*
+		* The time slept beyond this value is lost, which does not matter once the particles alive when the System fell asleep are dead.
+		*
+		* @param maxSleepTime : the maximum time slept in seconds or 0 for no maximum (10 by default)
+		*/
+		void setMaxSleepTime(float maxSleepTime);
+
+		/**
+		* @brief Gets the maximum time slept to catch up
+		* @return the maximum time slept in seconds or 0 if there is no maximum
+		*/
+		float getMaxSleepTime() const;
+
+		////////////
+		// Random //
+		////////////
+
+		/**
+		* @brief Sets the seed of this system
+		*
+		* Each group of the system has its own random stream seeded from the seed of the system and the index of the group.
+		* Setting the seed of a system restarts the streams of its groups so that the effect can be reproduced.<br>
+		* By default, the seed of a system is drawn from the global random stream of the context.
+		*
+		* @param seed : the seed of this system
+		*/
+		void setSeed(unsigned int seed);
+
+		/**
+		* @brief Gets the seed of this system
+		* @return the seed of this system
+		*/
+		unsigned int getSeed() const;
+
+		//////////////
+		// Priority //
+		//////////////
+
+		/**
+		* @brief Sets the priority of this system
+		*
+		* When a budget is enforced on several systems (see BudgetManager), the particles of systems with lower priorities are dropped first.<br>
+		* Within a same priority, the groups of the systems the furthest from the camera are dropped first.
+		*
+		* @param priority : the priority of this system (0 by default)
+		*/
+		void setPriority(int priority);
+
+		/**
+		* @brief Gets the priority of this system
+		* @return the priority of this system
+		*/
+		int getPriority() const;
+
 		///////////////
 		// Step Mode //
 		///////////////
@@ -313,6 +563,20 @@ namespace SPK
 		spark_description(System, Transformable)
 		(
 			spk_attribute(bool, computeAABB, enableAABBComputation, isAABBComputationEnabled);
+			spk_attribute(bool, parallelUpdate, enableParallelUpdate, isParallelUpdateEnabled);
+			spk_attribute(bool, asyncUpdate, enableAsyncUpdate, isAsyncUpdateEnabled);
+			spk_structure(lodBands, createLODBand, removeLODBand, clearLODBands, getNbLODBands)
+			(
+				spk_field(float, distance, setLODBandDistance, getLODBandDistance);
+				spk_field(unsigned int, updateInterval, setLODBandUpdateInterval, getLODBandUpdateInterval);
+				spk_field(bool, rendererUpdate, enableLODBandRendererUpdate, isLODBandRendererUpdateEnabled);
+				spk_field(bool, sorting, enableLODBandSorting, isLODBandSortingEnabled);
+			);
+			spk_attribute(float, catchUpStep, setCatchUpStep, getCatchUpStep);
+			spk_attribute(unsigned int, maxCatchUpSteps, setMaxCatchUpSteps, getMaxCatchUpSteps);
+			spk_attribute(float, maxSleepTime, setMaxSleepTime, getMaxSleepTime);
+			spk_attribute(unsigned int, seed, setSeed, getSeed);
+			spk_attribute(int, priority, setPriority, getPriority);
 			spk_array(Ref<Group>, groups, addGroup, removeGroup, removeAllGroups, getGroup, getNbGroups);
 			spk_array(Ref<Controller>, controllers, addController, removeController, removeAllControllers, getController, getNbControllers);
 		);
@@ -350,7 +614,110 @@ namespace SPK
 		Vector3D AABBMin;
 		Vector3D AABBMax;
 
+		bool parallelUpdateEnabled;
+
+		// Chains of dependent groups updated concurrently (see sortGroupsByDependencies())
+		std::vector<Group*> targetGroups;
+		std::vector<std::pair<size_t,size_t> > groupDependencies; // Pairs of indices of a group and of a group it adds particles to
+		std::vector<std::pair<const SPKObject*,size_t> > groupObjects; // Objects modified by the update of the groups and index of their group
+		std::vector<size_t> groupChains; // Index of the first group of the chain of each group
+		std::vector<size_t> nbGroupProducers; // Number of groups adding particles to each group not updated yet
+		std::vector<size_t> groupOrder; // Indices of the groups chain after chain
+		std::vector<size_t> chainEnds; // End of each chain within groupOrder
+		std::vector<unsigned char> aliveGroups; // Written concurrently, hence not a vector of bool
+
+		void sortGroupsByDependencies();
+
+		// Asynchronous update
+		class AsyncUpdateTask : public RangeTask
+		{
+		public :
+
+			AsyncUpdateTask(System& system);
+			virtual void execute(size_t start,size_t end);
+
+			float deltaTime;
+
+		private :
+
+			System& system;
+		};
+
+		bool asyncUpdateEnabled;
+		AsyncUpdateTask asyncUpdateTask;
+		TaskScheduler* asyncTaskScheduler; // The scheduler running the update, NULL if no update is running
+
+		bool launchUpdate(float deltaTime);
+
+		// Level of detail
+		struct LODBand
+		{
+			float distance;
+			unsigned int updateInterval;
+			bool rendererUpdateEnabled;
+			bool sortingEnabled;
+		};
+
+		std::vector<LODBand> lodBands;
+		unsigned int nbSkippedFrames;
+		float skippedTime; // Time accumulated while the updates are skipped
+
+		// Frustum sleeping
+		std::vector<float> frustumPlanes;
+		bool visible;
+		float sleepTime; // Time slept not caught up yet
+		float catchUpStep;
+		unsigned int maxCatchUpSteps;
+		float maxSleepTime;
+
+		unsigned int seed;
+		int priority;
+
+		// Seeds the random stream of the group at the given index from the seed of the system
+		void seedGroup(size_t index);
+
+		// Updates a range of chains of groups, the groups of each chain one after the other
+		class GroupUpdateTask : public RangeTask
+		{
+		public :
+
+			GroupUpdateTask(System& system,float deltaTime,bool concurrent);
+			virtual void execute(size_t start,size_t end);
+
+		private :
+
+			System& system;
+			float deltaTime;
+			bool concurrent;
+		};
+
+		// Sorts and computes the AABB of a range of groups
+		class GroupFinalizeTask : public RangeTask
+		{
+		public :
+
+			GroupFinalizeTask(const std::vector<Ref<Group> >& groups,bool sort,bool computeAABB);
+			virtual void execute(size_t start,size_t end);
+
+		private :
+
+			const std::vector<Ref<Group> >& groups;
+			bool sort;
+			bool computeAABB;
+		};
+
+		bool synchronousUpdate(float deltaTime);
 		bool innerUpdate(float deltaTime);
+		void finalizeUpdate(bool sorting);
+		void enableGroupsRenderSide(bool rendererUpdate,bool distanceUpdate,bool lastStep = true);
+		const LODBand* getCurrentLODBand() const;
+		void getBounds(Vector3D& min,Vector3D& max) const;
+		bool isInFrustum() const;
+		void catchUp();
+		TaskScheduler* getGroupsTaskScheduler() const;
+
+		// Restores the state of a copy of the prototype without allocating any memory so that it can be played again
+		void restart(const System& prototype);
 
 		static void setGroupSystem(const Ref<Group>& group,System* system,bool remove = true);
 	};
@@ -418,6 +785,21 @@ namespace SPK
 		return AABBMax;
 	}
 
+	inline void System::enableParallelUpdate(bool parallel)
+	{
+		parallelUpdateEnabled = parallel;
+	}
+
+	inline bool System::isParallelUpdateEnabled() const
+	{
+		return parallelUpdateEnabled;
+	}
+
+	inline bool System::isAsyncUpdateEnabled() const
+	{
+		return asyncUpdateEnabled;
+	}
+
 	inline void System::setCameraPosition(const Vector3D& cameraPosition)
 	{
 		this->cameraPosition = cameraPosition;
@@ -428,6 +810,109 @@ namespace SPK
 		return cameraPosition;
 	}
 
+	inline unsigned int System::getNbLODBands() const
+	{
+		return static_cast<unsigned int>(lodBands.size());
+	}
+
+	inline void System::setLODBandDistance(unsigned int index,float distance)
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::setLODBandDistance(unsigned int,float) - Index of LOD band is out of bounds : " << index);
+		lodBands[index].distance = distance;
+	}
+
+	inline float System::getLODBandDistance(unsigned int index) const
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::getLODBandDistance(unsigned int) - Index of LOD band is out of bounds : " << index);
+		return lodBands[index].distance;
+	}
+
+	inline void System::setLODBandUpdateInterval(unsigned int index,unsigned int updateInterval)
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::setLODBandUpdateInterval(unsigned int,unsigned int) - Index of LOD band is out of bounds : " << index);
+		lodBands[index].updateInterval = updateInterval;
+	}
+
+	inline unsigned int System::getLODBandUpdateInterval(unsigned int index) const
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::getLODBandUpdateInterval(unsigned int) - Index of LOD band is out of bounds : " << index);
+		return lodBands[index].updateInterval;
+	}
+
+	inline void System::enableLODBandRendererUpdate(unsigned int index,bool rendererUpdate)
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::enableLODBandRendererUpdate(unsigned int,bool) - Index of LOD band is out of bounds : " << index);
+		lodBands[index].rendererUpdateEnabled = rendererUpdate;
+	}
+
+	inline bool System::isLODBandRendererUpdateEnabled(unsigned int index) const
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::isLODBandRendererUpdateEnabled(unsigned int) - Index of LOD band is out of bounds : " << index);
+		return lodBands[index].rendererUpdateEnabled;
+	}
+
+	inline void System::enableLODBandSorting(unsigned int index,bool sorting)
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::enableLODBandSorting(unsigned int,bool) - Index of LOD band is out of bounds : " << index);
+		lodBands[index].sortingEnabled = sorting;
+	}
+
+	inline bool System::isLODBandSortingEnabled(unsigned int index) const
+	{
+		SPK_ASSERT(index < getNbLODBands(),"System::isLODBandSortingEnabled(unsigned int) - Index of LOD band is out of bounds : " << index);
+		return lodBands[index].sortingEnabled;
+	}
+
+	inline bool System::isVisible() const
+	{
+		return visible;
+	}
+
+	inline float System::getSleepTime() const
+	{
+		return sleepTime;
+	}
+
+	inline float System::getCatchUpStep() const
+	{
+		return catchUpStep;
+	}
+
+	inline void System::setMaxCatchUpSteps(unsigned int maxCatchUpSteps)
+	{
+		this->maxCatchUpSteps = maxCatchUpSteps;
+	}
+
+	inline unsigned int System::getMaxCatchUpSteps() const
+	{
+		return maxCatchUpSteps;
+	}
+
+	inline void System::setMaxSleepTime(float maxSleepTime)
+	{
+		this->maxSleepTime = maxSleepTime;
+	}
+
+	inline float System::getMaxSleepTime() const
+	{
+		return maxSleepTime;
+	}
+
+	inline unsigned int System::getSeed() const
+	{
+		return seed;
+	}
+
+	inline void System::setPriority(int priority)
+	{
+		this->priority = priority;
+	}
+
+	inline int System::getPriority() const
+	{
+		return priority;
+	}
+
 	inline void System::setClampStep(bool enableClampStep,float clamp)
 	{
 		clampStepEnabled = enableClampStep;
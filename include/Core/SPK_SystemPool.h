@@ -0,0 +1,178 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_SYSTEMPOOL
+#define H_SPK_SYSTEMPOOL
+
+#include <vector>
+
+namespace SPK
+{
+	/**
+	* @brief A pool of instances of a prototype system
+	*
+	* Deep copying a system each time an effect is spawned clones its whole graph of objects.
+	* A pool creates the instances of the prototype once and recycles them instead :<br>
+	* <ul>
+	* <li>The interpolators and the renderers of the prototype are shared by all the instances as they only hold configuration</li>
+	* <li>The groups, emitters, zones and modifiers are owned by each instance as they hold the particles and the transforms of the instance</li>
+	* </ul>
+	* Once all the instances are created (see reserve(size_t)), acquiring and releasing an instance does not allocate any memory.<br>
+	* <br>
+	* The shared objects must not be modified through an instance, unless the change is meant for all of them.
+	*/
+	class SPK_PREFIX SystemPool
+	{
+	public :
+
+		/**
+		* @brief Constructor of system pool
+		* @param prototype : the system the instances are copied from
+		* @param capacity : the number of instances created beforehand
+		*/
+		SystemPool(const Ref<System>& prototype,size_t capacity = 0);
+
+		/**
+		* @brief Gets the prototype of this pool
+		* @return the system the instances are copied from
+		*/
+		const Ref<System>& getPrototype() const;
+
+		/**
+		* @brief Creates instances so that the pool holds at least the given number of instances
+		* @param capacity : the number of instances
+		*/
+		void reserve(size_t capacity);
+
+		/**
+		* @brief Sets the maximum number of instances of this pool
+		*
+		* When all the instances are active and the maximum is reached, acquire() returns NULL.<br>
+		* 0 means there is no maximum (default) and the pool grows when needed.
+		*
+		* @param maxInstances : the maximum number of instances or 0 for no maximum
+		*/
+		void setMaxInstances(size_t maxInstances);
+
+		/**
+		* @brief Gets the maximum number of instances of this pool
+		* @return the maximum number of instances or 0 if there is no maximum
+		*/
+		size_t getMaxInstances() const;
+
+		/**
+		* @brief Gets the number of instances of this pool (active or not)
+		* @return the number of instances
+		*/
+		size_t getNbInstances() const;
+
+		/**
+		* @brief Gets the number of active instances of this pool
+		* @return the number of active instances
+		*/
+		size_t getNbActiveInstances() const;
+
+		/**
+		* @brief Gets an active instance
+		* @param index : the index of the active instance
+		* @return the active instance
+		*/
+		const Ref<System>& getActiveInstance(size_t index) const;
+
+		/**
+		* @brief Acquires an instance
+		*
+		* The instance is restarted : it has no particle, the tanks of its emitters are reset and its random stream is reseeded.<br>
+		* Its transform is the one of its last use, it is up to the caller to set it.<br>
+		* If no instance is available, a new one is copied from the prototype unless the maximum number of instances is reached.
+		*
+		* @return the instance or NULL if the maximum number of instances is reached
+		*/
+		Ref<System> acquire();
+
+		/**
+		* @brief Releases an active instance so that it can be acquired again
+		* @param instance : the instance to release
+		* @return true if the instance was released, false if it is not an active instance of this pool
+		*/
+		bool release(const Ref<System>& instance);
+
+		/** @brief Releases all the active instances */
+		void releaseAll();
+
+		/**
+		* @brief Updates all the active instances
+		* The instances whose update returns false (no more particles and no more emitters alive) are released.
+		* @param deltaTime : the time step
+		*/
+		void updateInstances(float deltaTime);
+
+		/** @brief Renders all the active instances */
+		void renderInstances() const;
+
+	private :
+
+		Ref<System> prototype;
+		size_t maxInstances;
+
+		std::vector<Ref<System> > instances; // The active instances are stored first
+		size_t nbActiveInstances;
+
+		Ref<System> createInstance() const;
+		void releaseInstance(size_t index);
+
+		SystemPool(const SystemPool&); // Not used
+		SystemPool& operator=(const SystemPool&); // Not used
+	};
+
+	inline const Ref<System>& SystemPool::getPrototype() const
+	{
+		return prototype;
+	}
+
+	inline void SystemPool::setMaxInstances(size_t maxInstances)
+	{
+		this->maxInstances = maxInstances;
+	}
+
+	inline size_t SystemPool::getMaxInstances() const
+	{
+		return maxInstances;
+	}
+
+	inline size_t SystemPool::getNbInstances() const
+	{
+		return instances.size();
+	}
+
+	inline size_t SystemPool::getNbActiveInstances() const
+	{
+		return nbActiveInstances;
+	}
+
+	inline const Ref<System>& SystemPool::getActiveInstance(size_t index) const
+	{
+		SPK_ASSERT(index < nbActiveInstances,"SystemPool::getActiveInstance(size_t) - Index of instance is out of bounds : " << index);
+		return instances[index];
+	}
+}
+
+#endif
@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_THREADPOOL
+#define H_SPK_THREADPOOL
+
+namespace SPK
+{
+	/**
+	* @brief A task working on a range of indices that can be split across the threads of a ThreadPool
+	*
+	* execute(size_t,size_t) may be called concurrently on disjoint ranges and must therefore only access data of its range.
+	*/
+	class RangeTask
+	{
+	public :
+
+		virtual ~RangeTask() {}
+
+		/**
+		* @brief Executes the task on [start,end[
+		* @param start : the first index of the range
+		* @param end : the index following the last index of the range
+		*/
+		virtual void execute(size_t start,size_t end) = 0;
+	};
+
+	/**
+	* @brief The interface of the schedulers executing the tasks of SPARK on several threads
+	*
+	* The scheduler used by SPARK is set with SPKContext::setTaskScheduler(TaskScheduler*).
+	* By default, there is none and everything runs on the calling thread.<br>
+	* ThreadPool is the scheduler of SPARK. Implementing this interface allows to run the tasks of SPARK on the job system of an engine instead.<br>
+	* <br>
+	* A scheduler must support parallel executions started from within a task (nested parallelism) and from several threads at once.
+	* Its threads must have their own random stream (see SPKContext::setCurrentRandomStream(RandomStream*)).
+	*/
+	class SPK_PREFIX TaskScheduler
+	{
+	public :
+
+		virtual ~TaskScheduler() {}
+
+		/**
+		* @brief Gets the number of threads of this scheduler in addition to the calling thread
+		* SPARK only splits its tasks if this number is not 0.
+		* @return the number of worker threads
+		*/
+		virtual size_t getNbWorkers() const = 0;
+
+		/**
+		* @brief Executes a task on [start,end[ using the threads of this scheduler
+		*
+		* The range must be split in sub ranges beginning at <i>start + k * grainSize</i>, whatever the number of threads.
+		* The task may also be executed on several consecutive sub ranges at once.<br>
+		* This method returns once the whole range is executed.
+		*
+		* @param task : the task to execute
+		* @param start : the first index of the range
+		* @param end : the index following the last index of the range
+		* @param grainSize : the size of the sub ranges
+		*/
+		virtual void parallelFor(RangeTask& task,size_t start,size_t end,size_t grainSize) = 0;
+
+		/**
+		* @brief Starts the execution of a task on [start,end[ without waiting for it
+		*
+		* The range is split the same way than with parallelFor(RangeTask&,size_t,size_t,size_t).
+		* wait(RangeTask&) must be called with the same task before it is destroyed or launched again.<br>
+		* <br>
+		* By default, the task is executed before this method returns.
+		*
+		* @param task : the task to execute
+		* @param start : the first index of the range
+		* @param end : the index following the last index of the range
+		* @param grainSize : the size of the sub ranges
+		*/
+		virtual void launch(RangeTask& task,size_t start,size_t end,size_t grainSize);
+
+		/**
+		* @brief Waits for the end of the execution of a task started with launch(RangeTask&,size_t,size_t,size_t)
+		* @param task : the launched task
+		*/
+		virtual void wait(RangeTask& task);
+	};
+
+	inline void TaskScheduler::launch(RangeTask& task,size_t start,size_t end,size_t grainSize)
+	{
+		parallelFor(task,start,end,grainSize);
+	}
+
+	inline void TaskScheduler::wait(RangeTask&) {}
+
+	/**
+	* @brief A pool of worker threads scheduling tasks by work stealing
+	*
+	* Each thread has its own queue of sub ranges. A thread executing a range splits it in halves and pushes the second half in its queue,
+	* from which idle threads steal it. Threads waiting for the end of a parallel execution steal and execute sub ranges in the meantime,
+	* so that parallel executions can be nested (a system updated by a task splitting its groups in sub ranges for instance).<br>
+	* <br>
+	* Worker threads rely on the C++11 thread library. If SPK_NO_THREADS is defined (see SPK_Config.h), a pool has no worker
+	* and tasks are executed on the calling thread.
+	*/
+	class SPK_PREFIX ThreadPool : public TaskScheduler
+	{
+	public :
+
+		/**
+		* @brief Constructor of thread pool
+		* @param nbWorkers : the number of worker threads. The thread calling parallelFor(RangeTask&,size_t,size_t,size_t) takes part in the work as well
+		*/
+		ThreadPool(size_t nbWorkers = getNbHardwareThreads() - 1);
+
+		virtual ~ThreadPool();
+
+		virtual size_t getNbWorkers() const;
+
+		/**
+		* @brief Gets the number of threads the hardware can run concurrently
+		* @return the number of hardware threads (at least 1)
+		*/
+		static size_t getNbHardwareThreads();
+
+		/**
+		* @brief Executes a task on [start,end[ using the worker threads and the calling thread
+		*
+		* The range is split in sub ranges beginning at <i>start + k * grainSize</i>, whatever the number of threads.<br>
+		* This method may be called from a worker thread (within a task) or from several threads at once.
+		* The calling thread executes sub ranges until the whole range is executed.
+		*
+		* @param task : the task to execute
+		* @param start : the first index of the range
+		* @param end : the index following the last index of the range
+		* @param grainSize : the size of the sub ranges
+		*/
+		virtual void parallelFor(RangeTask& task,size_t start,size_t end,size_t grainSize);
+
+		/**
+		* @brief Starts the execution of a task on [start,end[ by the worker threads without waiting for it
+		*
+		* The calling thread only takes part in the work once it calls wait(RangeTask&).
+		* If the pool has no worker, the task is executed before this method returns.
+		*
+		* @param task : the task to execute
+		* @param start : the first index of the range
+		* @param end : the index following the last index of the range
+		* @param grainSize : the size of the sub ranges
+		*/
+		virtual void launch(RangeTask& task,size_t start,size_t end,size_t grainSize);
+
+		virtual void wait(RangeTask& task);
+
+	private :
+
+		struct Impl;
+		Impl* impl;
+
+		ThreadPool(const ThreadPool&); // Not used
+		ThreadPool& operator=(const ThreadPool&); // Not used
+	};
+}
+
+#endif
@@ -52,6 +52,7 @@ namespace SPK
 	class SPK_PREFIX Transform
 	{
 	friend class Transformable;
+	friend class Group;
 
 	public :
 
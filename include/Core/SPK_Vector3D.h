@@ -936,6 +936,16 @@ namespace SPK
 			generateRandom(v0.y,v1.y),
 			generateRandom(v0.z,v1.z));
 	}
+
+	template<>
+	inline Vector3D RandomStream::generate(const Vector3D& v0,const Vector3D& v1)
+	{
+		// The coordinates are generated in order (arguments evaluation order is unspecified)
+		float x = generate(v0.x,v1.x);
+		float y = generate(v0.y,v1.y);
+		float z = generate(v0.z,v1.z);
+		return Vector3D(x,y,z);
+	}
 }
 
 #endif
@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef H_SPK_WORLD
+#define H_SPK_WORLD
+
+#include <vector>
+
+namespace SPK
+{
+	/**
+	* @brief A container of systems updated together in parallel
+	*
+	* A world updates all its systems with a single call per frame :<br>
+	* <ul>
+	* <li>update(float) starts the update of the systems on the scheduler of the context (see SPKContext::setTaskScheduler(TaskScheduler*)) and returns</li>
+	* <li>join() waits for the end of the update. It must be called before the systems are rendered or modified</li>
+	* </ul>
+	* Each system is updated by its own task. Within a system, the groups with the parallel update enabled are split in sub tasks
+	* (see Group::enableParallelUpdate(bool)) and the groups of the systems with the concurrent update enabled are updated by sub tasks
+	* (see System::enableParallelUpdate(bool)). The threads of a ThreadPool steal the sub tasks of each other so that a large group does not leave them idle.<br>
+	* <br>
+	* If there is no scheduler, the systems are updated one after the other on the calling thread by update(float).<br>
+	* <br>
+	* The systems of a world must not share any group and must not interact with each other while updated.
+	* Other objects (zones, modifiers...) can be shared as long as their update does not modify them (an emitter with a finite tank must not be shared for instance).
+	* The update of a system does not take nor release references to them, so their reference counts are not modified concurrently.<br>
+	* References to shared objects must not be taken or released while the world is updated, unless SPK_ATOMIC_REFERENCES is defined (see SPK_Config.h).
+	*/
+	class SPK_PREFIX World
+	{
+	public :
+
+		/** @brief Constructor of world */
+		World();
+
+		/**
+		* @brief Destructor of world
+		* Waits for the end of the update if any.
+		*/
+		~World();
+
+		/**
+		* @brief Adds a system to this world
+		* @param system : the system to add
+		*/
+		void addSystem(const Ref<System>& system);
+
+		/**
+		* @brief Removes a system from this world
+		* @param system : the system to remove
+		*/
+		void removeSystem(const Ref<System>& system);
+
+		/** @brief Removes all the systems from this world */
+		void removeAllSystems();
+
+		/**
+		* @brief Gets the number of systems of this world
+		* @return the number of systems
+		*/
+		size_t getNbSystems() const;
+
+		/**
+		* @brief Gets a system of this world
+		* @param index : the index of the system
+		* @return the system
+		*/
+		const Ref<System>& getSystem(size_t index) const;
+
+		/**
+		* @brief Tells whether a system was still alive after the last update
+		* @param index : the index of the system
+		* @return the value returned by System::updateParticles(float) at the last update
+		*/
+		bool isSystemAlive(size_t index) const;
+
+		/**
+		* @brief Starts the update of all the systems
+		* The update must be joined with join() before the next update and before the systems are rendered.
+		* @param deltaTime : the time step
+		*/
+		void update(float deltaTime);
+
+		/** @brief Waits for the end of the update started by update(float) */
+		void join();
+
+		/**
+		* @brief Tells whether an update is running
+		* @return true if the update was started and not joined yet
+		*/
+		bool isUpdating() const;
+
+		/** @brief Renders all the systems */
+		void render() const;
+
+	private :
+
+		// Updates a range of systems
+		class SystemUpdateTask : public RangeTask
+		{
+		public :
+
+			SystemUpdateTask(World& world);
+			virtual void execute(size_t start,size_t end);
+
+		private :
+
+			World& world;
+		};
+
+		std::vector<Ref<System> > systems;
+		std::vector<char> aliveSystems; // Not a vector of bool so that tasks can write concurrently
+
+		SystemUpdateTask updateTask;
+		TaskScheduler* taskScheduler; // The scheduler running the update, NULL if none
+		float deltaTime;
+		bool updating;
+
+		World(const World&); // Not used
+		World& operator=(const World&); // Not used
+	};
+
+	inline size_t World::getNbSystems() const
+	{
+		return systems.size();
+	}
+
+	inline const Ref<System>& World::getSystem(size_t index) const
+	{
+		SPK_ASSERT(index < systems.size(),"World::getSystem(size_t) - Index of system is out of bounds : " << index);
+		return systems[index];
+	}
+
+	inline bool World::isSystemAlive(size_t index) const
+	{
+		SPK_ASSERT(index < systems.size(),"World::isSystemAlive(size_t) - Index of system is out of bounds : " << index);
+		return aliveSystems[index] != 0;
+	}
+
+	inline bool World::isUpdating() const
+	{
+		return updating;
+	}
+}
+
+#endif
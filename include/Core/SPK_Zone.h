@@ -25,6 +25,7 @@
 namespace SPK
 {
 	class Particle;
+	class Group;
 
 #ifdef SPK_DOXYGEN_ONLY // For documentation purpose only
 
@@ -77,6 +78,18 @@ namespace SPK
 		///////////////
 
 		virtual void generatePosition(Vector3D& v,bool full,float radius = 0.0f) const = 0;
+
+		/**
+		* @brief Generates the positions of the particles of a group within [start,end[
+		* Each particle is generated with its own radius.
+		* The default implementation calls generatePosition(Vector3D&,bool,float) for each particle.
+		* @param group : the group of particles
+		* @param start : the index of the first particle
+		* @param end : the index following the last particle
+		* @param full : true to generate positions within the whole zone, false to generate them only at its borders
+		*/
+		virtual void generatePositions(Group& group,size_t start,size_t end,bool full) const;
+
 		virtual bool contains(const Vector3D& v,float radius = 0.0f) const = 0;
 		virtual bool intersects(const Vector3D& v0,const Vector3D& v1,float radius = 0.0f,Vector3D* normal = NULL) const = 0;
 		virtual Vector3D computeNormal(const Vector3D& v) const = 0;
@@ -110,6 +110,8 @@ namespace SPK
 		* @param ZONE_TEST_FLAG : the test flag specifying which zone tests are valid for this zonedModifier
 		* @param zoneTest : the zone test by default
 		* @param zone : the zone
+		* @param SUPPORTS_RANGE : see Modifier
+		* @param PARALLEL_SAFE : see Modifier
 		*/
 		ZonedModifier(
 			unsigned int PRIORITY,
@@ -118,7 +120,9 @@ namespace SPK
 			bool NEEDS_OCTREE,
 			int ZONE_TEST_FLAG,
 			ZoneTest zoneTest,
-			const Ref<Zone>& zone = SPK_NULL_REF);
+			const Ref<Zone>& zone = SPK_NULL_REF,
+			bool SUPPORTS_RANGE = false,
+			bool PARALLEL_SAFE = false);
 
 		ZonedModifier(const ZonedModifier& zonedModifier);
 
@@ -41,6 +41,7 @@ namespace SPK
 		void clearActions();
 
 		virtual void apply(Particle& particle) const;
+		virtual void getTargetGroups(std::vector<Group*>& targets) const;
 
 		virtual Ref<SPKObject> findByName(const std::string& name);
 
@@ -134,6 +134,7 @@ namespace SPK
 		void resetPool();
 
 		virtual void apply(Particle& particle) const;
+		virtual void getTargetGroups(std::vector<Group*>& targets) const;
 		virtual Ref<SPKObject> findByName(const std::string& name);
 
 	public :
@@ -152,7 +153,14 @@ namespace SPK
 		Ref<Emitter> baseEmitter;
 		Ref<Group> targetGroup;
 
-		mutable std::deque<Ref<Emitter> > emitterPool;
+		// An emitter of the pool with the spawn cycle of the target group when it was last used
+		struct PooledEmitter
+		{
+			Ref<Emitter> emitter;
+			unsigned int spawnCycle;
+		};
+
+		mutable std::deque<PooledEmitter> emitterPool;
 		
 		SpawnParticlesAction(
 			unsigned int minNb = 1,
@@ -163,7 +171,7 @@ namespace SPK
 		SpawnParticlesAction(const SpawnParticlesAction& action);
 
 		bool checkValidity() const;
-		const Ref<Emitter>& getNextAvailableEmitter() const;
+		Emitter* getNextAvailableEmitter() const;
 	};
 
 	inline void SpawnParticlesAction::setNb(unsigned int nb)
@@ -115,6 +115,7 @@ namespace SPK
 		NormalEmitter(const NormalEmitter& emitter);
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
 	};
 
 	inline Ref<NormalEmitter> NormalEmitter::create(
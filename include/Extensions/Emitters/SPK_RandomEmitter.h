@@ -62,6 +62,7 @@ namespace SPK
 		RandomEmitter(const RandomEmitter& emitter);
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
 	};
 
 	inline RandomEmitter::RandomEmitter(const Ref<Zone>& zone,bool full,int tank,float flow,float forceMin,float forceMax) :
@@ -158,6 +158,7 @@ namespace SPK
 		SphericEmitter(const SphericEmitter& emitter);
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
 
 		void computeMatrix();
 	};
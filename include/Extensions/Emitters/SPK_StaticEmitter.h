@@ -58,6 +58,7 @@ namespace SPK
 		StaticEmitter(const StaticEmitter& emitter);
 
 		virtual  void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
 	};
 
 	inline StaticEmitter::StaticEmitter(const Ref<Zone>& zone,bool full,int tank,float flow) :
@@ -75,6 +76,12 @@ namespace SPK
 	{
 		particle.velocity().set(0.0f,0.0f,0.0f); // no initial velocity
 	}
+
+	inline void StaticEmitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			particleIt->velocity().set(0.0f,0.0f,0.0f); // no initial velocity (so no speed is generated)
+	}
 }
 
 #endif
@@ -98,6 +98,7 @@ namespace SPK
 		StraightEmitter(const StraightEmitter& emitter);
 
 		virtual void generateVelocity(Particle& particle,float speed) const;
+		virtual void generateVelocities(Group& group,size_t start,size_t end) const;
 	};
 
 	inline Ref<StraightEmitter> StraightEmitter::create(
@@ -51,11 +51,12 @@ namespace SPK
 
 		virtual  void interpolate(T* data,Group& group,DataSet* dataSet) const {}
 		virtual  void init(T& data,Particle& particle,DataSet* dataSet) const;
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 	};
 
 	template<typename T>
 	DefaultInitializer<T>::DefaultInitializer(Tv value) :
-		Interpolator<T>(false),
+		Interpolator<T>(false,true,true),
 		defaultValue(value)
 	{}
 
@@ -89,6 +90,12 @@ namespace SPK
 		data = defaultValue;
 	}
 
+	template<typename T>
+	inline void DefaultInitializer<T>::initRange(T* data,Group&,DataSet*,size_t start,size_t end) const
+	{
+		std::fill(data + start,data + end,defaultValue);
+	}
+
 	// Typedefs
 	typedef DefaultInitializer<Color> ColorDefaultInitializer;
 	typedef DefaultInitializer<float> FloatDefaultInitializer;
@@ -281,7 +281,9 @@ namespace SPK
 		virtual void createData(DataSet& dataSet,const Group& group) const;
 
 		virtual void interpolate(T* data, Group& group, DataSet* dataSet) const;
+		virtual void interpolateRange(T* data, Group& group, DataSet* dataSet, size_t start, size_t end) const;
 		virtual void init(T& data, Particle& particle, DataSet* dataSet) const;
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 
 		void sortGraph(unsigned int start);
 		void swapEntries(unsigned int id1, unsigned int id2);
@@ -316,7 +318,7 @@ namespace SPK
 
 	template<typename T>
 	GraphInterpolator<T>::GraphInterpolator() :
-		Interpolator<T>(true),
+		Interpolator<T>(true,true,true),
 		type(INTERPOLATOR_LIFETIME),
 		param(PARAM_SCALE),
 		scaleXVariation(0.0f),
@@ -654,13 +656,19 @@ namespace SPK
 	template<typename T>
 	void GraphInterpolator<T>::interpolate(T* data, Group& group, DataSet* dataSet) const
 	{
-		SPK_ASSERT(!graph.empty(),"GraphInterpolator<T>::interpolate(T*,Group&,DataSet*) const - The graph of the interpolator is empty. Cannot interpolate");
+		interpolateRange(data,group,dataSet,0,group.getNbParticles());
+	}
+
+	template<typename T>
+	void GraphInterpolator<T>::interpolateRange(T* data, Group& group, DataSet* dataSet, size_t start, size_t end) const
+	{
+		SPK_ASSERT(!graph.empty(),"GraphInterpolator<T>::interpolateRange(T*,Group&,DataSet*,size_t,size_t) const - The graph of the interpolator is empty. Cannot interpolate");
 
 		FloatArrayData& offsetXData = SPK_GET_DATA(FloatArrayData,dataSet,OFFSET_X_DATA_INDEX);
 		FloatArrayData& scaleXData = SPK_GET_DATA(FloatArrayData,dataSet,SCALE_X_DATA_INDEX);
 		FloatArrayData& ratioYData = SPK_GET_DATA(FloatArrayData,dataSet,RATIO_Y_DATA_INDEX);
 
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 		{
 			size_t index = particleIt->getIndex();
 			interpolateParticle(data[index],*particleIt,offsetXData[index],scaleXData[index],ratioYData[index]);
@@ -682,6 +690,25 @@ namespace SPK
 		ratioYData[index] = SPK_RANDOM(0.0f,1.0f);
 		interpolateParticle(data,particle,offsetXData[index],scaleXData[index],ratioYData[index]);
 	}
+
+	template<typename T>
+	void GraphInterpolator<T>::initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const
+	{
+		SPK_ASSERT(!graph.empty(),"GraphInterpolator<T>::initRange(T*,Group&,DataSet*,size_t,size_t) const - The graph of the interpolator is empty. Cannot interpolate");
+
+		float* offsetXData = SPK_GET_DATA(FloatArrayData,dataSet,OFFSET_X_DATA_INDEX).getData();
+		float* scaleXData = SPK_GET_DATA(FloatArrayData,dataSet,SCALE_X_DATA_INDEX).getData();
+		float* ratioYData = SPK_GET_DATA(FloatArrayData,dataSet,RATIO_Y_DATA_INDEX).getData();
+
+		for (ConstGroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+		{
+			size_t index = particleIt->getIndex();
+			offsetXData[index] = SPK_RANDOM(-offsetXVariation,offsetXVariation);
+			scaleXData[index] = 1.0f + SPK_RANDOM(-scaleXVariation,scaleXVariation);
+			ratioYData[index] = SPK_RANDOM(0.0f,1.0f);
+			interpolateParticle(data[index],*particleIt,offsetXData[index],scaleXData[index],ratioYData[index]);
+		}
+	}
 }
 
 #endif
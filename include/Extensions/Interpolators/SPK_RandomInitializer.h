@@ -53,6 +53,7 @@ namespace SPK
 
 		virtual void interpolate(T* data,Group& group,DataSet* dataSet) const {}
 		virtual void init(T& data,Particle& particle,DataSet* dataSet) const;
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 	};
 
 	typedef RandomInitializer<Color> ColorRandomInitializer;
@@ -63,7 +64,7 @@ namespace SPK
 
 	template<typename T>
 	RandomInitializer<T>::RandomInitializer(Tv minValue,Tv maxValue) :
-		Interpolator<T>(false),
+		Interpolator<T>(false,true,true),
 		minValue(minValue),
 		maxValue(maxValue)
 	{}
@@ -105,6 +106,12 @@ namespace SPK
 	{
 		data = SPK_RANDOM(minValue,maxValue);
 	}
+
+	template<typename T>
+	inline void RandomInitializer<T>::initRange(T* data,Group& group,DataSet*,size_t start,size_t end) const
+	{
+		group.getRandomStream().fill(data + start,end - start,minValue,maxValue); // Filled in bulk for floats
+	}
 }
 
 #endif
@@ -68,7 +68,9 @@ namespace SPK
 		virtual void createData(DataSet& dataSet,const Group& group) const;
 
 		virtual void interpolate(T* data,Group& group,DataSet* dataSet) const;
+		virtual void interpolateRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 		virtual void init(T& data,Particle& particle,DataSet* dataSet) const;
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 	};
 
 	typedef RandomInterpolator<Color> ColorRandomInterpolator;
@@ -85,7 +87,7 @@ namespace SPK
 
 	template<typename T>
 	RandomInterpolator<T>::RandomInterpolator(const T& minBirthValue,const T& maxBirthValue,const T& minDeathValue,const T& maxDeathValue) :
-		Interpolator<T>(true),
+		Interpolator<T>(true,true,true),
 		minBirthValue(minBirthValue),
 		maxBirthValue(maxBirthValue),
 		minDeathValue(minDeathValue),
@@ -154,11 +156,17 @@ namespace SPK
 
 	template<typename T>
 	void RandomInterpolator<T>::interpolate(T* data,Group& group,DataSet* dataSet) const
+	{
+		interpolateRange(data,group,dataSet,0,group.getNbParticles());
+	}
+
+	template<typename T>
+	void RandomInterpolator<T>::interpolateRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const
 	{
 		const ArrayData<T>& birthValuesData = SPK_GET_DATA(ArrayData<T>,dataSet,BIRTH_VALUE_DATA_INDEX);
 		const ArrayData<T>& deathValuesData = SPK_GET_DATA(ArrayData<T>,dataSet,DEATH_VALUE_DATA_INDEX);
 
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 		{
 			size_t index = particleIt->getIndex();
 			interpolateParam(data[index],deathValuesData[index],birthValuesData[index],particleIt->getEnergy());
@@ -172,6 +180,19 @@ namespace SPK
 		data = SPK_GET_DATA(ArrayData<T>,dataSet,BIRTH_VALUE_DATA_INDEX)[index] = SPK_RANDOM(minBirthValue,maxBirthValue);
 		SPK_GET_DATA(ArrayData<T>,dataSet,DEATH_VALUE_DATA_INDEX)[index] = SPK_RANDOM(minDeathValue,maxDeathValue);
 	}
+
+	template<typename T>
+	void RandomInterpolator<T>::initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const
+	{
+		T* birthValues = SPK_GET_DATA(ArrayData<T>,dataSet,BIRTH_VALUE_DATA_INDEX).getData();
+		T* deathValues = SPK_GET_DATA(ArrayData<T>,dataSet,DEATH_VALUE_DATA_INDEX).getData();
+		RandomStream& randomStream = group.getRandomStream();
+		for (size_t i = start; i < end; ++i)
+		{
+			data[i] = birthValues[i] = randomStream.generate(minBirthValue,maxBirthValue);
+			deathValues[i] = randomStream.generate(minDeathValue,maxDeathValue);
+		}
+	}
 }
 
 #endif
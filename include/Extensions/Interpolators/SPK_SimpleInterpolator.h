@@ -52,7 +52,9 @@ namespace SPK
 		SimpleInterpolator<T>(const SimpleInterpolator<T>& interpolator);
 
 		virtual void interpolate(T* data,Group& group,DataSet* dataSet) const;
+		virtual void interpolateRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 		virtual  void init(T& data,Particle& particle,DataSet* dataSet) const;
+		virtual void initRange(T* data,Group& group,DataSet* dataSet,size_t start,size_t end) const;
 	};
 
 	typedef SimpleInterpolator<Color> ColorSimpleInterpolator;
@@ -63,7 +65,7 @@ namespace SPK
 
 	template<typename T>
 	SimpleInterpolator<T>::SimpleInterpolator(Tv birthValue,Tv deathValue) :
-		Interpolator<T>(false),
+		Interpolator<T>(false,true,true),
 		birthValue(birthValue),
 		deathValue(deathValue)
 	{}
@@ -106,10 +108,22 @@ namespace SPK
 		data = birthValue;
 	}
 
+	template<typename T>
+	inline void SimpleInterpolator<T>::initRange(T* data,Group&,DataSet*,size_t start,size_t end) const
+	{
+		std::fill(data + start,data + end,birthValue);
+	}
+
 	template<typename T>
 	void SimpleInterpolator<T>::interpolate(T* data,Group& group,DataSet* dataSet) const
 	{
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		interpolateRange(data,group,dataSet,0,group.getNbParticles());
+	}
+
+	template<typename T>
+	void SimpleInterpolator<T>::interpolateRange(T* data,Group& group,DataSet*,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 			interpolateParam(data[particleIt->getIndex()],deathValue,birthValue,particleIt->getEnergy());
 	}
 }
@@ -53,6 +53,7 @@ namespace SPK
 		Gravity(const Gravity& gravity);
 
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	class SPK_PREFIX Friction : public Modifier
@@ -78,10 +79,11 @@ namespace SPK
 		Friction(const Friction& friction);
 
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Gravity::Gravity(const Vector3D& value) :
-		Modifier(MODIFIER_PRIORITY_FORCE,false,false,false)
+		Modifier(MODIFIER_PRIORITY_FORCE,false,false,false,true,true)
 	{
 		setValue(value);	
 	}
@@ -119,7 +121,7 @@ namespace SPK
 	}
 
 	inline Friction::Friction(float value) :
-		Modifier(MODIFIER_PRIORITY_FRICTION,false,false,false),
+		Modifier(MODIFIER_PRIORITY_FRICTION,false,false,false,true,true),
 		value(value)
 	{}
 
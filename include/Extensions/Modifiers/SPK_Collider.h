@@ -43,9 +43,22 @@ namespace SPK
 	* Note that collision particle vs particles requires intensive processing.
 	* Moreover the algorithm has a complexity that badly scales which means processing times increase fastly as particles count increase.<br>
 	* Tries to limitate the number of particles to perform collision on. More than 1000 particles can require a lot of processing time even of recent hardware.<br>
+	* The neighbors of a particle are found with the neighbor structure of the group (see Group::setNeighborStructureType(NeighborStructureType)).
+	* The grid is generally faster than the default octree when the particles have similar sizes.<br>
 	* <br>
 	* The accuracy of the collisions is better with small update steps.
-	* Therefore try to keep the update time small by for instance multiplying the number of updates per frame.
+	* Therefore try to keep the update time small by for instance multiplying the number of updates per frame.<br>
+	* <br>
+	* By default, collisions are resolved one after the other and each collision sees the velocities modified by the previous ones.
+	* The parallel resolution (see enableParallelCollisions(bool)) resolves them in two phases instead :
+	* <ul>
+	* <li>each particle gathers the positions and radii of its neighbors, tests them 4 by 4 with SIMD instructions
+	* and averages the velocity changes of its collisions computed from the state of the particles at the beginning of the step</li>
+	* <li>the velocity changes are then applied to all the particles</li>
+	* </ul>
+	* Averaging keeps dense piles of particles stable but intersections take more steps to be resolved than with the default resolution.<br>
+	* The first phase only writes the data of the particle processed and is split across the threads of the task scheduler
+	* if the parallel update of the group is enabled (see Group::enableParallelUpdate(bool)). Its results do not depend on the number of threads.
 	*/
 	class SPK_PREFIX Collider : public Modifier
 	{
@@ -81,31 +94,112 @@ namespace SPK
 		*/
 		float getElasticity() const;
 
+		/**
+		* @brief Enables or disables the parallel resolution of the collisions
+		*
+		* See the class description for more information. The parallel resolution is disabled by default.<br>
+		* The data it needs for each particle is only allocated while it is enabled.
+		*
+		* @param parallel : true to resolve the collisions in parallel, false to resolve them one after the other
+		*/
+		void enableParallelCollisions(bool parallel);
+
+		/**
+		* @brief Tells whether the collisions are resolved in parallel
+		* @return true if the collisions are resolved in parallel, false if not
+		*/
+		bool isParallelCollisionsEnabled() const;
+
 	public :
 		spark_description(Collider, Modifier)
 		(
 			spk_attribute(float, elasticity, setElasticity, getElasticity);
+			spk_attribute(bool, parallelCollisions, enableParallelCollisions, isParallelCollisionsEnabled);
 		);
 
 	private :
 
+		static const size_t PARALLEL_GRAIN_SIZE = 1024; // The number of particles of a chunk processed by a thread at once
+
+		// Data indices. The data is only created when the parallel resolution is enabled
+		static const size_t NB_DATA = 4;
+		static const size_t VELOCITY_CHANGE_INDEX = 0;
+		static const size_t FLAGS_INDEX = 1;
+		static const size_t SPHERES_INDEX = 2; // Position and scale of the particles packed as 4 floats
+		static const size_t BUFFERS_INDEX = 3;
+
+		// Flags of the particles set by the parallel resolution
+		static const unsigned char FLAG_COLLIDED = 1 << 0;
+		static const unsigned char FLAG_RESET_POSITION = 1 << 1;
+
+		// Buffers of the narrow phase of a chunk of particles
+		struct Buffers
+		{
+			NeighborStructure::Array<size_t> neighborCells;
+			std::vector<size_t> neighbors;
+			std::vector<float> x;
+			std::vector<float> y;
+			std::vector<float> z;
+			std::vector<float> radii;
+			std::vector<size_t> hits;
+		};
+
+		// The buffers of the chunks, kept from an update to the next. They hold no data per particle
+		class BufferData : public Data
+		{
+		public :
+
+			std::vector<Buffers> buffers;
+
+		private :
+
+			virtual void swap(size_t,size_t) {}
+			virtual void compact(const size_t*,size_t,size_t) {}
+			virtual bool resize(size_t,size_t) { return true; }
+		};
+
+		// Computes the collisions of a range of chunks of particles for the parallel resolution
+		class CollisionTask : public RangeTask
+		{
+		public :
+
+			CollisionTask(const Collider& collider,const Group& group,const NeighborStructure& neighborStructure,DataSet* dataSet);
+			virtual void execute(size_t start,size_t end);
+
+		private :
+
+			const Collider& collider;
+			const Group& group;
+			const NeighborStructure& neighborStructure;
+			DataSet* dataSet;
+		};
+
 		float elasticity;
+		bool parallelCollisionsEnabled;
 
 		Collider(float elasticity = 1.0f);
 		Collider(const Collider& collider);
 
+		virtual void createData(DataSet& dataSet,const Group& group) const;
+		virtual void checkData(DataSet& dataSet,const Group& group) const;
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+
+		void createParallelData(DataSet& dataSet,const Group& group) const;
+		void modifyParallel(Group& group,DataSet* dataSet) const;
+		void computeCollisions(const Group& group,const NeighborStructure& neighborStructure,DataSet* dataSet,size_t start,size_t end,Buffers& buffers) const;
 	};
 
 	inline Collider::Collider(float elasticity) :
-		Modifier(MODIFIER_PRIORITY_COLLISION,false,false,true)
+		Modifier(MODIFIER_PRIORITY_COLLISION,true,false,true),
+		parallelCollisionsEnabled(false)
 	{
 		setElasticity(elasticity);
 	}
 
 	inline Collider::Collider(const Collider& collider) :
 		Modifier(collider),
-		elasticity(collider.elasticity)
+		elasticity(collider.elasticity),
+		parallelCollisionsEnabled(collider.parallelCollisionsEnabled)
 	{}
 
 	inline Ref<Collider> Collider::create(float elasticity)
@@ -117,6 +211,16 @@ namespace SPK
 	{
 		return elasticity;
 	}
+
+	inline void Collider::enableParallelCollisions(bool parallel)
+	{
+		parallelCollisionsEnabled = parallel;
+	}
+
+	inline bool Collider::isParallelCollisionsEnabled() const
+	{
+		return parallelCollisionsEnabled;
+	}
 }
 
 #endif
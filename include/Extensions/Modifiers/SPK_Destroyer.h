@@ -49,6 +49,7 @@ namespace SPK
 
 		virtual void init(Particle& particle,DataSet* dataSet) const;
 		virtual  void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual  void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<Destroyer> Destroyer::create(const Ref<Zone>& zone,ZoneTest zoneTest)
@@ -57,7 +58,7 @@ namespace SPK
 	}
 
 	inline Destroyer::Destroyer(const Ref<Zone>& zone,ZoneTest zoneTest) :
-		ZonedModifier(MODIFIER_PRIORITY_COLLISION,false,true,false,ZONE_TEST_FLAG_ALL & ~ZONE_TEST_FLAG_ALWAYS,zoneTest,zone)
+		ZonedModifier(MODIFIER_PRIORITY_COLLISION,false,true,false,ZONE_TEST_FLAG_ALL & ~ZONE_TEST_FLAG_ALWAYS,zoneTest,zone,true)
 	{}
 
 	inline Destroyer::Destroyer(const Destroyer& destroyer) :
@@ -72,7 +73,12 @@ namespace SPK
 
 	inline void Destroyer::modify(Group& group,DataSet* dataSet,float deltaTime) const
 	{
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	inline void Destroyer::modifyRange(Group& group,DataSet*,float,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 			if (checkZone(*particleIt))
 				particleIt->kill();
 	}
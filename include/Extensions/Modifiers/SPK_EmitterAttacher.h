@@ -22,6 +22,8 @@
 #ifndef H_SPK_EMITTERATTACHER
 #define H_SPK_EMITTERATTACHER
 
+#include <deque>
+
 namespace SPK
 {
 	class Emitter;
@@ -49,6 +51,8 @@ namespace SPK
 		bool isEmitterOrientationEnabled() const;
 		bool isEmitterRotationEnabled() const;
 
+		virtual void getTargetGroups(std::vector<Group*>& targets) const;
+
 	public :
 		spark_description(EmitterAttacher, Modifier)
 		(
@@ -83,14 +87,24 @@ namespace SPK
 
 		private :
 
+			// An emitter replaced by setEmitter, kept until the requests it enqueued in the target group are done
+			struct ReleasedEmitter
+			{
+				Ref<Emitter> emitter;
+				unsigned int spawnCycle; // The spawn cycle of the target group when the emitter was replaced
+			};
+
 			Ref<Emitter>* data;
 			size_t dataSize;
 
 			Group* group;
 
+			std::deque<ReleasedEmitter> releasedEmitters;
+
 			~EmitterData();
 
 			virtual void swap(size_t index0,size_t index1);
+			virtual bool resize(size_t capacity,size_t nbParticles);
 		};
 
 		Ref<Emitter> baseEmitter;
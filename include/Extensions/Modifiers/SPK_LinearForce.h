@@ -321,6 +321,7 @@ namespace SPK
 		float getDiscreteFactor(const Particle& particle) const;
 		
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<LinearForce> LinearForce::create(const Vector3D& value,const Ref<Zone>& zone,ZoneTest zoneTest)
@@ -94,6 +94,7 @@ namespace SPK
 
 		virtual void init(Particle& particle,DataSet* dataSet) const;
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<Obstacle> Obstacle::create(const Ref<Zone>& zone,float bouncingRatio,float friction,ZoneTest zoneTest)
@@ -133,6 +133,7 @@ namespace SPK
 		PointMass(const PointMass& pointMass);
 
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<PointMass> PointMass::create(const Vector3D& pos,float mass,float offset)
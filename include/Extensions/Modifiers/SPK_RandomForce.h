@@ -151,13 +151,13 @@ namespace SPK
 			float minPeriod = 1.0f,
 			float maxPeriod = 1.0f);
 
-		void advanceTime(const Particle& particle,DataSet* dataSet,float deltaTime,float& time) const;
 		void initParticle(const Particle& particle,DataSet* dataSet) const;
 
 		virtual void createData(DataSet& dataSet,const Group& group) const;
 
 		virtual void init(Particle& particle,DataSet* dataSet) const;
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<RandomForce> RandomForce::create(const Vector3D& minVector,const Vector3D& maxVector,float minPeriod,float maxPeriod)
@@ -56,10 +56,13 @@ namespace SPK
 		Rotator(const Rotator& rotator);
 
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
+
+		void rotate(Group& group,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Rotator::Rotator() :
-		Modifier(MODIFIER_PRIORITY_POSITION,false,false,false)
+		Modifier(MODIFIER_PRIORITY_POSITION,false,false,false,true)
 	{}
 
 	inline Rotator::Rotator(const Rotator& rotator) :
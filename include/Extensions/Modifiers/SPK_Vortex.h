@@ -240,6 +240,7 @@ namespace SPK
 		Vortex(const Vortex& vortex);
 
 		virtual void modify(Group& group,DataSet* dataSet,float deltaTime) const;
+		virtual void modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const;
 	};
 
 	inline Ref<Vortex> Vortex::create(const Vector3D& position,const Vector3D& direction,float rotationSpeed,float attractionSpeed)
@@ -31,6 +31,7 @@ namespace SPK
 		static Ref<Point> create(const Vector3D& position = Vector3D());
 
 		virtual void generatePosition(Vector3D& v,bool full,float radius = 0.0f) const;
+		virtual void generatePositions(Group& group,size_t start,size_t end,bool full) const;
 		virtual bool contains(const Vector3D& v,float radius = 0.0f) const;
 		virtual bool intersects(const Vector3D& v0,const Vector3D& v1,float radius = 0.0f,Vector3D* normal = NULL) const;
 		virtual Vector3D computeNormal(const Vector3D& v) const;
@@ -64,6 +65,13 @@ namespace SPK
 		v = getTransformedPosition();
 	}
 
+	inline void Point::generatePositions(Group& group,size_t start,size_t end,bool) const
+	{
+		const Vector3D& position = getTransformedPosition();
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			particleIt->position() = position;
+	}
+
 	inline bool Point::contains(const Vector3D& v,float radius) const
 	{
 		return false;
@@ -115,6 +115,7 @@ namespace SPK
 		///////////////
 
 		virtual void generatePosition(Vector3D& v,bool full,float radius = 0.0f) const;
+		virtual void generatePositions(Group& group,size_t start,size_t end,bool full) const;
 		virtual bool contains(const Vector3D& v,float radius = 0.0f) const;
 		virtual bool intersects(const Vector3D& v0,const Vector3D& v1,float radius = 0.0f,Vector3D* normal = NULL) const;
 		virtual Vector3D computeNormal(const Vector3D& v) const;
@@ -25,6 +25,9 @@
 #include "Core/SPK_DEF.h"
 #include "Core/SPK_Logger.h"
 #include "Core/SPK_Vector3D.h"
+#include "Core/SPK_SIMD.h"
+#include "Core/SPK_ThreadPool.h"
+#include "Core/SPK_SpawnQueue.h"
 #include "Core/SPK_Color.h"
 #include "Core/SPK_Meta.h"
 #include "Core/SPK_Types.h"
@@ -58,10 +61,15 @@
 #include "Core/SPK_Renderer.h"
 #include "Core/SPK_Action.h"
 #include "Core/SPK_System.h"
+#include "Core/SPK_SystemPool.h"
+#include "Core/SPK_BudgetManager.h"
+#include "Core/SPK_World.h"
+#include "Core/SPK_NeighborStructure.h"
 #include "Core/SPK_Group.h"
 #include "Core/SPK_Particle.h"
 #include "Core/SPK_Iterator.h"
 #include "Core/SPK_Octree.h"
+#include "Core/SPK_SpatialGrid.h"
 #include "Core/SPK_Factory.h"
 #include "Core/IO/SPK_IO_Loader.h"
 #include "Core/IO/SPK_IO_Saver.h"
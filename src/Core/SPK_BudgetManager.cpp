@@ -0,0 +1,206 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm> // for std::sort
+#include <ctime>
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#include <chrono>
+#define SPK_WALL_CLOCK
+#endif
+
+#include <SPARK_Core.h>
+
+namespace SPK
+{
+namespace
+{
+	const float MIN_EMISSION_SCALE = 0.1f;
+	const float EMISSION_SCALE_RECOVERY = 0.05f; // Increase of the scale per update once the update fits in the time budget
+
+	// Gets the time in seconds (wall clock time when available so that parallel updates are measured correctly)
+	double getTime()
+	{
+#ifdef SPK_WALL_CLOCK
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+		return static_cast<double>(clock()) / CLOCKS_PER_SEC;
+#endif
+	}
+}
+
+	BudgetManager::BudgetManager(size_t maxParticles,float maxUpdateTime) :
+		maxParticles(maxParticles),
+		maxUpdateTime(0.0f),
+		emissionScale(1.0f),
+		lastUpdateTime(0.0f)
+	{
+		setMaxUpdateTime(maxUpdateTime);
+	}
+
+	bool BudgetManager::RankedGroup::operator<(const RankedGroup& rankedGroup) const
+	{
+		if (systemPriority != rankedGroup.systemPriority)
+			return systemPriority > rankedGroup.systemPriority;
+		if (groupPriority != rankedGroup.groupPriority)
+			return groupPriority > rankedGroup.groupPriority;
+		return sqrDist < rankedGroup.sqrDist;
+	}
+
+	void BudgetManager::addSystem(const Ref<System>& system)
+	{
+		SPK_ASSERT(system,"BudgetManager::addSystem(const Ref<System>&) - The system must not be NULL");
+		if (std::find(systems.begin(),systems.end(),system) != systems.end())
+		{
+			SPK_LOG_WARNING("BudgetManager::addSystem(const Ref<System>&) - The system is already managed by the budget manager");
+			return;
+		}
+		systems.push_back(system);
+	}
+
+	void BudgetManager::removeSystem(const Ref<System>& system)
+	{
+		std::vector<Ref<System> >::iterator it = std::find(systems.begin(),systems.end(),system);
+		if (it == systems.end())
+		{
+			SPK_LOG_WARNING("BudgetManager::removeSystem(const Ref<System>&) - The system is not managed by the budget manager");
+			return;
+		}
+		resetBudget(*it);
+		systems.erase(it);
+	}
+
+	void BudgetManager::removeAllSystems()
+	{
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+			resetBudget(*it);
+		systems.clear();
+	}
+
+	void BudgetManager::setMaxUpdateTime(float maxUpdateTime)
+	{
+		if (maxUpdateTime < 0.0f)
+		{
+			SPK_LOG_WARNING("BudgetManager::setMaxUpdateTime(float) - The maximum update time cannot be negative, 0 is used");
+			maxUpdateTime = 0.0f;
+		}
+
+		this->maxUpdateTime = maxUpdateTime;
+		if (maxUpdateTime == 0.0f)
+			emissionScale = 1.0f;
+	}
+
+	size_t BudgetManager::getNbParticles() const
+	{
+		size_t nbParticles = 0;
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+			nbParticles += (*it)->getNbParticles();
+		return nbParticles;
+	}
+
+	void BudgetManager::updateSystems(float deltaTime)
+	{
+		distributeBudget(deltaTime);
+
+		double start = getTime();
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+			(*it)->updateParticles(deltaTime);
+		lastUpdateTime = static_cast<float>(getTime() - start);
+
+		// The scale follows the ratio between the budget and the time spent and recovers slowly to avoid oscillations
+		if (maxUpdateTime > 0.0f)
+		{
+			if (lastUpdateTime > maxUpdateTime)
+				emissionScale = std::max(MIN_EMISSION_SCALE,emissionScale * maxUpdateTime / lastUpdateTime);
+			else
+				emissionScale = std::min(1.0f,emissionScale + EMISSION_SCALE_RECOVERY);
+		}
+	}
+
+	void BudgetManager::renderSystems() const
+	{
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+			(*it)->renderParticles();
+	}
+
+	void BudgetManager::distributeBudget(float deltaTime)
+	{
+		rankedGroups.clear();
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+		{
+			float sqrDist = (*it)->getSqrDistanceToCamera();
+			for (size_t i = 0; i < (*it)->getNbGroups(); ++i)
+			{
+				RankedGroup rankedGroup;
+				rankedGroup.group = (*it)->getGroup(i).get();
+				rankedGroup.nbGranted = 0;
+				rankedGroup.systemPriority = (*it)->getPriority();
+				rankedGroup.groupPriority = rankedGroup.group->getPriority();
+				rankedGroup.sqrDist = sqrDist;
+				rankedGroups.push_back(rankedGroup);
+			}
+		}
+
+		// A stable sort keeps the order of the systems and groups for equal ranks so that the distribution does not flicker
+		std::stable_sort(rankedGroups.begin(),rankedGroups.end());
+
+		if (maxParticles == 0)
+		{
+			for (std::vector<RankedGroup>::const_iterator it = rankedGroups.begin(); it != rankedGroups.end(); ++it)
+			{
+				it->group->setEmissionScale(emissionScale);
+				it->group->setParticleBudget(Group::NO_BUDGET);
+			}
+			return;
+		}
+
+		size_t remaining = static_cast<size_t>(maxParticles * emissionScale);
+
+		// First pass : the particles alive are granted in ranking order
+		for (std::vector<RankedGroup>::iterator it = rankedGroups.begin(); it != rankedGroups.end(); ++it)
+		{
+			it->nbGranted = std::min(it->group->getNbParticles(),remaining);
+			remaining -= it->nbGranted;
+		}
+
+		// Second pass : the births left are reserved in ranking order so that the budgets sum to the maximum at most
+		for (std::vector<RankedGroup>::const_iterator it = rankedGroups.begin(); it != rankedGroups.end(); ++it)
+		{
+			it->group->setEmissionScale(emissionScale);
+
+			size_t nbBirths = std::min(it->group->getNbRequestedBirths(deltaTime),remaining);
+			if (!it->group->isElasticCapacityEnabled())
+				nbBirths = std::min(nbBirths,it->group->getCapacity() > it->nbGranted ? it->group->getCapacity() - it->nbGranted : 0);
+			remaining -= nbBirths;
+
+			it->group->setParticleBudget(it->nbGranted + nbBirths);
+		}
+	}
+
+	void BudgetManager::resetBudget(const Ref<System>& system)
+	{
+		for (size_t i = 0; i < system->getNbGroups(); ++i)
+		{
+			const Ref<Group>& group = system->getGroup(i);
+			group->setEmissionScale(1.0f);
+			group->setParticleBudget(Group::NO_BUDGET);
+		}
+	}
+}
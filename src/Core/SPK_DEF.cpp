@@ -27,6 +27,16 @@
 
 namespace SPK
 {
+#ifdef SPK_INLINE_RANDOM_STREAM
+	SPK_THREAD_LOCAL RandomStream* SPKContext::currentRandomStream = NULL;
+#else
+namespace
+{
+	// The stream used by SPK_RANDOM on each thread (NULL for the global stream of the context)
+	SPK_THREAD_LOCAL RandomStream* currentRandomStream = NULL;
+}
+#endif
+
 	SPK_DEFINE_ENUM(Param, SPK_ENUM_PARAM)
 	SPK_DEFINE_ENUM(Factor, SPK_ENUM_FACTOR)
 	SPK_DEFINE_ENUM(InterpolationType, SPK_ENUM_INTERPOLATION_TYPE)
@@ -40,7 +50,8 @@ namespace SPK
 
 	// This allows SPARK initialization at application start up
 	SPKContext::SPKContext() :
-		defaultZone()
+		defaultZone(),
+		taskScheduler(NULL)
 	{
 		// Ensure MemoryTracer is created before the context, because it will be used in the destructor
 #ifdef SPK_TRACE_MEMORY
@@ -48,10 +59,7 @@ namespace SPK
 #endif
 
 		// Inits the random seed
-		randomSeed = static_cast<unsigned int>(std::time(NULL));
-		// little tweak to ensure the randomSeed is uniformly distributed along all the range
-		for (size_t i = 0; i < 2; ++i)
-			randomSeed = generateRandom(static_cast<unsigned int>(1),std::numeric_limits<unsigned int>::max());
+		randomStream.setSeed(static_cast<uint32>(std::time(NULL)));
 	}
 
 	// This allows SPARK finalization at application exit
@@ -66,6 +74,26 @@ namespace SPK
 		defaultZone.reset();
 	}
 
+#ifndef SPK_INLINE_RANDOM_STREAM
+	RandomStream& SPKContext::getRandomStream()
+	{
+		return currentRandomStream != NULL ? *currentRandomStream : randomStream;
+	}
+#endif
+
+	RandomStream* SPKContext::setCurrentRandomStream(RandomStream* stream)
+	{
+		RandomStream* previousStream = currentRandomStream;
+		currentRandomStream = stream;
+		return previousStream;
+	}
+
+	void RandomStream::fill(float* values,size_t nb,float min,float max)
+	{
+		SIMD::fillRandom(values,0,nb,key,counter,min,max);
+		counter += static_cast<uint32>(nb);
+	}
+
 	const Ref<Zone>& SPKContext::getDefaultZone()
 	{
 		if (!defaultZone)
@@ -19,6 +19,8 @@
 // 3. This notice may not be removed or altered from any source distribution.	//
 //////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm> // for std::swap
+
 #include <SPARK_Core.h>
 
 namespace SPK
@@ -49,4 +51,33 @@ namespace SPK
 			setData(i,NULL);
 		initialized = false;
 	}
+
+	void DataSet::copy(const DataSet& dataSet,size_t nbParticles)
+	{
+		for (size_t i = 0; i < nbData && i < dataSet.nbData; ++i)
+			if (dataArray[i] != NULL && dataSet.dataArray[i] != NULL)
+			{
+				if (dataArray[i]->copyData(*dataSet.dataArray[i],nbParticles))
+					dataArray[i]->flag = dataSet.dataArray[i]->flag;
+				else
+					initialized = false;
+			}
+	}
+
+	void DataSet::swapData(DataSet& dataSet)
+	{
+		std::swap(dataArray,dataSet.dataArray);
+		std::swap(nbData,dataSet.nbData);
+		std::swap(initialized,dataSet.initialized);
+	}
+
+	bool DataSet::resize(size_t capacity,size_t nbParticles)
+	{
+		// All data are resized even if one fails as the whole set is created again in that case
+		bool resized = true;
+		for (size_t i = 0; i < nbData; ++i)
+			if (dataArray[i] != NULL && !dataArray[i]->resize(capacity,nbParticles))
+				resized = false;
+		return resized;
+	}
 }
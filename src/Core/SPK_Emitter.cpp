@@ -100,10 +100,21 @@ namespace SPK
 			zone->updateTransform(this);
 	}
 
-	void Emitter::emit(Particle& particle) const
+	void Emitter::emitRange(Group& group,size_t start,size_t end) const
 	{
-		zone->generatePosition(particle.position(),full,particle.getRadius());
-		generateVelocity(particle,SPK_RANDOM(forceMin,forceMax) / particle.getParam(PARAM_MASS));
+		zone->generatePositions(group,start,end,full);
+		generateVelocities(group,start,end);
+	}
+
+	void Emitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			generateVelocity(*particleIt,generateSpeed(*particleIt));
+	}
+
+	float Emitter::generateSpeed(const Particle& particle) const
+	{
+		return SPK_RANDOM(forceMin,forceMax) / particle.getParam(PARAM_MASS);
 	}
 
 	Ref<SPKObject> Emitter::findByName(const std::string& name)
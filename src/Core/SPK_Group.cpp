@@ -19,7 +19,7 @@
 // 3. This notice may not be removed or altered from any source distribution.	//
 //////////////////////////////////////////////////////////////////////////////////
 
-#include <algorithm> // for std::swap and std::sort
+#include <algorithm> // for std::swap, std::sort and std::nth_element
 #include <limits> // for max float value
 
 #include <SPARK_Core.h>
@@ -35,6 +35,8 @@ namespace SPK
 		0.0f,	// PARAM_ROTATION_SPEED
 	};
 
+	const float Group::DEFAULT_GROWTH_FACTOR = 2.0f;
+
 	Group::Group(const Ref<System>& system,size_t capacity) :
 		Transformable(SHARE_POLICY_FALSE),
 		system(system.get()),
@@ -45,14 +47,51 @@ namespace SPK
 		still(false),
 		distanceComputationEnabled(false),
 		sortingEnabled(false),
+		indexSortingEnabled(false),
+		elasticCapacityEnabled(false),
+		growthFactor(DEFAULT_GROWTH_FACTOR),
+		maxCapacity(0),
+		shrinkDelay(1.0f),
+		shrinkTime(0.0f),
+		minCapacity(capacity),
+		fusedUpdateEnabled(false),
+		tileSize(DEFAULT_TILE_SIZE),
+		parallelUpdateEnabled(false),
+		deferredRenderSideEnabled(true),
+		rendererUpdateEnabled(true),
+		distanceUpdateEnabled(true),
+		rendererDeltaTime(0.0f),
+		prewarming(false),
+		concurrentUpdate(false),
+		fusedInterpolators(false),
+		nbFusedModifiers(0),
+		fusedDistances(false),
 		AABBMin(),
 		AABBMax(),
 		graphicalRadius(1.0f),
 		physicalRadius(1.0f),
-		nbBufferedParticles(0),
 		birthAction(),
 		deathAction(),
-		octree(NULL)
+		neighborStructure(NULL),
+		neighborStructureType(NEIGHBOR_STRUCTURE_OCTREE),
+		octreeMaxLevel(Octree::DEFAULT_MAX_LEVEL_INDEX),
+		octreeMaxParticlesPerCell(Octree::DEFAULT_MAX_PARTICLES_NB_PER_CELL),
+		octreeCellSizeFactor(Octree::DEFAULT_CELL_SIZE_FACTOR),
+		incrementalOctreeEnabled(false),
+		octreeRebuildThreshold(Octree::DEFAULT_REBUILD_THRESHOLD),
+		randomStream(SPKContext::get().getRandomStream().generateUint()),
+		updateSeed(0),
+		priority(0),
+		emissionScale(1.0f),
+		particleBudget(NO_BUDGET),
+		instancingEnabled(false),
+		nbInstances(0),
+		nbBufferedParticles(0),
+		spawnQueue(0),
+		nbSpawnRequests(0),
+		spawnRequestIndex(0),
+		nbSpawnCycles(0),
+		renderState(NULL)
 	{
 		reallocate(capacity);
 	}
@@ -67,14 +106,54 @@ namespace SPK
 		still(group.still),
 		distanceComputationEnabled(group.distanceComputationEnabled),
 		sortingEnabled(group.sortingEnabled),
+		indexSortingEnabled(group.indexSortingEnabled),
+		elasticCapacityEnabled(group.elasticCapacityEnabled),
+		growthFactor(group.growthFactor),
+		maxCapacity(group.maxCapacity),
+		shrinkDelay(group.shrinkDelay),
+		shrinkTime(0.0f),
+		minCapacity(group.minCapacity),
+		fusedUpdateEnabled(group.fusedUpdateEnabled),
+		tileSize(group.tileSize),
+		parallelUpdateEnabled(group.parallelUpdateEnabled),
+		deferredRenderSideEnabled(group.deferredRenderSideEnabled),
+		rendererUpdateEnabled(true),
+		distanceUpdateEnabled(true),
+		rendererDeltaTime(0.0f),
+		prewarming(false),
+		concurrentUpdate(false),
+		fusedInterpolators(false),
+		nbFusedModifiers(0),
+		fusedDistances(false),
 		AABBMin(group.AABBMin),
 		AABBMax(group.AABBMax),
 		graphicalRadius(group.graphicalRadius),
 		physicalRadius(group.physicalRadius),
+		neighborStructure(NULL),
+		neighborStructureType(group.neighborStructureType),
+		octreeMaxLevel(group.octreeMaxLevel),
+		octreeMaxParticlesPerCell(group.octreeMaxParticlesPerCell),
+		octreeCellSizeFactor(group.octreeCellSizeFactor),
+		incrementalOctreeEnabled(group.incrementalOctreeEnabled),
+		octreeRebuildThreshold(group.octreeRebuildThreshold),
+		randomStream(SPKContext::get().getRandomStream().generateUint()),
+		updateSeed(0),
+		priority(group.priority),
+		emissionScale(1.0f),
+		particleBudget(NO_BUDGET),
+		instancingEnabled(group.instancingEnabled), // The instances are not copied
+		nbInstances(0),
 		nbBufferedParticles(0),
-		octree(NULL)
+		spawnQueue(0),
+		nbSpawnRequests(0),
+		spawnRequestIndex(0),
+		nbSpawnCycles(0),
+		renderState(NULL)
 	{
+		setSpawnQueueCapacity(group.getSpawnQueueCapacity());
+		particleData.splitStorage = group.particleData.splitStorage;
 		reallocate(group.getCapacity());
+		minCapacity = group.minCapacity;
 
 		renderer.obj = group.copyChild(group.renderer.obj);
 		renderer.dataSet = attachDataSet(renderer.obj.get());
@@ -99,21 +178,12 @@ namespace SPK
 
 	Group::~Group()
 	{
+		releaseRenderState();
 		destroyAllAdditionnalData();
 
-		SPK_DELETE_ARRAY(particleData.positions);
-		SPK_DELETE_ARRAY(particleData.velocities);
-		SPK_DELETE_ARRAY(particleData.oldPositions);
-		SPK_DELETE_ARRAY(particleData.ages);
-		SPK_DELETE_ARRAY(particleData.lifeTimes);
-		SPK_DELETE_ARRAY(particleData.energies);
-		SPK_DELETE_ARRAY(particleData.sqrDists);
-		SPK_DELETE_ARRAY(particleData.colors);
-
-		for (size_t i = 0; i < NB_PARAMETERS; ++i)
-			SPK_DELETE_ARRAY(particleData.parameters[i]);
+		SIMD::deallocate(reinterpret_cast<float*>(particleData.slab)); // All the columns of particles are held by the slab
 
-		SPK_DELETE(octree);
+		SPK_DELETE(neighborStructure);
 
 		emptyBufferedParticles();
 	}
@@ -146,73 +216,184 @@ namespace SPK
 		}
 	}
 
+	namespace
+	{
+		// Makes the stream of a group the current stream of SPK_RANDOM on the calling thread while in scope
+		class RandomStreamScope
+		{
+		public :
+
+			RandomStreamScope(RandomStream& stream) : previousStream(SPKContext::get().setCurrentRandomStream(&stream)) {}
+			~RandomStreamScope() { SPKContext::get().setCurrentRandomStream(previousStream); }
+
+		private :
+
+			RandomStream* previousStream;
+		};
+	}
+
+	TaskScheduler* Group::getTaskScheduler() const
+	{
+		// Nested parallel loops would run serially on the threads already busy with other groups
+		TaskScheduler* taskScheduler = SPKContext::get().getTaskScheduler();
+		if (!parallelUpdateEnabled || concurrentUpdate || taskScheduler == NULL || taskScheduler->getNbWorkers() == 0)
+			return NULL;
+		return taskScheduler;
+	}
+
 	bool Group::updateParticles(float deltaTime)
 	{
 		// Prepares the additionnal data
 		prepareAdditionnalData();
 
-		size_t nbAutoBorn = 0;
-		size_t nbManualBorn = nbBufferedParticles;
+		updateRanges(deltaTime);
+		return completeUpdate(deltaTime);
+	}
 
-		// Checks the number of born particles
-		bool hasAliveEmitters = false;
-		activeEmitters.clear();
+	void Group::updateRanges(float deltaTime)
+	{
+		RandomStreamScope randomStreamScope(randomStream);
+		updateSeed = randomStream.generateUint();
 
-		for (std::vector<Ref<Emitter> >::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
-			if ((*it)->isActive())
+		fusedInterpolators = false;
+		nbFusedModifiers = 0;
+		fusedDistances = false;
+
+		TaskScheduler* taskScheduler = getTaskScheduler();
+		bool parallel = taskScheduler != NULL; // Only parallel safe stages can then run on other threads
+
+		if (fusedUpdateEnabled || parallel)
+		{
+			// Interpolators are fused only if they all support ranges (and are parallel safe if updated on other threads)
+			fusedInterpolators = !colorInterpolator.obj || canUpdateRange(*colorInterpolator.obj,parallel);
+			for (size_t i = 0; i < nbEnabledParameters; ++i)
+				fusedInterpolators &= canUpdateRange(*paramInterpolators[enabledParamIndices[i]].obj,parallel);
+
+			// Modifiers are fused until the first one not supporting ranges (the neighbor structure is built before any modifier is applied)
+			if (fusedInterpolators && neighborStructure == NULL)
+				while (nbFusedModifiers < activeModifiers.size() && canUpdateRange(*activeModifiers[nbFusedModifiers].obj,parallel))
+					++nbFusedModifiers;
+
+			// Distances can be computed within tiles only if positions are final
+			fusedDistances = distanceComputationEnabled && distanceUpdateEnabled && fusedInterpolators && neighborStructure == NULL && nbFusedModifiers == activeModifiers.size();
+
+			// With split storage, tiles gather their vectors for the stages accessing particles and copy them back afterwards
+			bool tilesAccessVectors = nbFusedModifiers > 0 || (fusedInterpolators && (colorInterpolator.obj || nbEnabledParameters > 0));
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
 			{
-				int nb = (*it)->updateTankFromTime(deltaTime);
-				if (nb > 0)
-				{
-					activeEmitters.push_back(WeakEmitterPair(*it,nb));
-					nbAutoBorn += nb;
-				}
+				scatterVectors(static_cast<VectorArray>(i));
+				if (tilesAccessVectors)
+					particleData.splitArrays[i].viewValid = true;
+			}
+			particleData.trackVectorWrites = !tilesAccessVectors;
 
-				hasAliveEmitters |= ((*it)->getCurrentTank() != 0); // An emitter with some particles in its tank is still potentially alive
+			// With the asynchronous update, each tile is copied from the render state before being updated (the split arrays are not rendered so they can be scattered before)
+			const ParticleData* renderColumns = separateRenderState();
+
+			// Updates the particles range by range (ranges are made of whole tiles so that the results do not depend on the threads)
+			UpdateTask task(*this,deltaTime,fusedInterpolators,nbFusedModifiers,fusedDistances,renderColumns);
+			if (parallel)
+			{
+				size_t grainSize = PARALLEL_GRAIN_SIZE;
+				if (fusedUpdateEnabled)
+					grainSize = std::max(static_cast<size_t>(1),PARALLEL_GRAIN_SIZE / tileSize) * tileSize;
+				taskScheduler->parallelFor(task,0,particleData.nbParticles,grainSize);
 			}
+			else
+				task.execute(0,particleData.nbParticles);
 
-		size_t emitterIndex = 0;
-		size_t nbBorn = nbAutoBorn + nbManualBorn;
+			particleData.trackVectorWrites = true;
+			if (!still && !tilesAccessVectors)
+			{
+				invalidateVectors(VECTOR_ARRAY_POSITIONS);
+				invalidateVectors(VECTOR_ARRAY_OLD_POSITIONS);
+			}
+		}
+		else
+		{
+			// With the asynchronous update, the particles are copied from the render state before being updated
+			const ParticleData* renderColumns = separateRenderState();
+			if (renderColumns != NULL)
+				copyColumns(*renderColumns,0,particleData.nbParticles);
 
-		// Updates the age of the particles function of the delta time
-		for (size_t i = 0; i < particleData.nbParticles; ++i)
-			particleData.ages[i] += deltaTime;
+			// Updates the age of the particles function of the delta time
+			SIMD::updateAges(particleData.ages,0,particleData.nbParticles,deltaTime);
 
-		// Computes the energy of the particles (if they are not immortal)
-		if (!immortal)
-			for (size_t i = 0; i < particleData.nbParticles; ++i)
-				particleData.energies[i] = 1.0f - particleData.ages[i] / particleData.lifeTimes[i];
+			// Computes the energy of the particles (if they are not immortal)
+			if (!immortal)
+				SIMD::computeEnergies(particleData.energies,particleData.ages,particleData.lifeTimes,0,particleData.nbParticles);
 
-		// Updates the position of particles function of their velocity
-		if (!still)
-			for (size_t i = 0; i < particleData.nbParticles; ++i)
+			// Updates the position of particles function of their velocity
+			if (!still)
 			{
-				particleData.oldPositions[i] = particleData.positions[i];
-				particleData.positions[i] += particleData.velocities[i] * deltaTime;
+				scatterVectors(VECTOR_ARRAY_POSITIONS);
+				scatterVectors(VECTOR_ARRAY_VELOCITIES);
+				integrateParticles(0,particleData.nbParticles,deltaTime);
+				invalidateVectors(VECTOR_ARRAY_POSITIONS);
+				invalidateVectors(VECTOR_ARRAY_OLD_POSITIONS);
 			}
+		}
+
+		restoreRendererData();
+	}
+
+	bool Group::completeUpdate(float deltaTime)
+	{
+		RandomStreamScope randomStreamScope(randomStream);
+		drainSpawnQueue();
+
+		size_t nbAutoBorn = 0;
+		size_t nbManualBorn = nbBufferedParticles;
+
+		// Checks the number of born particles (with instancing, the emitters of the group are only templates)
+		bool hasAliveEmitters = false;
+		activeEmitters.clear();
+
+		float emissionTime = deltaTime * emissionScale;
+		if (!instancingEnabled)
+			hasAliveEmitters = updateEmitters(emitters,emissionTime,NO_INSTANCE,nbAutoBorn);
+		else
+			for (size_t i = 0; i < instances.size(); ++i)
+				if (instances[i].alive)
+					hasAliveEmitters |= updateEmitters(instances[i].emitters,emissionTime,i,nbAutoBorn);
+
+		size_t emitterIndex = 0;
+		size_t nbBorn = nbAutoBorn + nbManualBorn;
 
 		// Interpolates the parameters
-		if (colorInterpolator.obj)
-			colorInterpolator.obj->interpolate(particleData.colors,*this,colorInterpolator.dataSet);
-		for (size_t i = 0; i < nbEnabledParameters; ++i)
+		if (!fusedInterpolators)
 		{
-			FloatInterpolatorDef& interpolator = paramInterpolators[enabledParamIndices[i]];
-			interpolator.obj->interpolate(particleData.parameters[enabledParamIndices[i]],*this,interpolator.dataSet);
+			if (colorInterpolator.obj)
+				colorInterpolator.obj->interpolate(particleData.colors,*this,colorInterpolator.dataSet);
+			for (size_t i = 0; i < nbEnabledParameters; ++i)
+			{
+				FloatInterpolatorDef& interpolator = paramInterpolators[enabledParamIndices[i]];
+				interpolator.obj->interpolate(particleData.parameters[enabledParamIndices[i]],*this,interpolator.dataSet);
+			}
 		}
 
-		// Updates the octree if one
-		if (octree != NULL)
-			octree->update();
+		// Updates the neighbor structure if one
+		if (neighborStructure != NULL)
+			neighborStructure->update(getTaskScheduler());
 
 		// Modifies the particles with specific active modifiers behavior
-		for (std::vector<WeakModifierDef>::const_iterator it = activeModifiers.begin(); it != activeModifiers.end(); ++it)
+		for (std::vector<WeakModifierDef>::const_iterator it = activeModifiers.begin() + nbFusedModifiers; it != activeModifiers.end(); ++it)
 			it->obj->modify(*this,it->dataSet,deltaTime);
 
 		// Updates the renderer data
-		if (renderer.obj)
+		rendererDeltaTime += deltaTime;
+		if (renderer.obj && rendererUpdateEnabled)
+		{
 			renderer.obj->update(*this,renderer.dataSet);
+			rendererDeltaTime = 0.0f;
+		}
+
+		// Drops the particles over budget
+		if (particleData.nbParticles > particleBudget)
+			dropParticles(particleData.nbParticles - particleBudget);
 
-		// Checks dead particles and reinits or swaps
+		// Checks dead particles and marks them for removal
+		deadParticles.clear();
 		for (size_t i = 0; i < particleData.nbParticles; ++i)
 			if (particleData.energies[i] <= 0.0f)
 			{
@@ -223,45 +404,235 @@ namespace SPK
 					deathAction->apply(particle);
 				}
 
-				bool replaceDeadParticle = false;
-				while (!replaceDeadParticle && nbBorn > 0)
-				{
-					if (initParticle(i,emitterIndex,nbManualBorn))
-						replaceDeadParticle = true;
-					--nbBorn;
-				}
+				deadParticles.push_back(i);
+			}
+
+		// Removes all the dead particles at once
+		if (!deadParticles.empty())
+			compactParticles();
+
+		// Emits new particles in a single burst (the births over budget are refused)
+		if (particleBudget != NO_BUDGET)
+			nbBorn = std::min(nbBorn,particleBudget > particleData.nbParticles ? particleBudget - particleData.nbParticles : 0);
+
+		if (elasticCapacityEnabled && particleData.nbParticles + nbBorn > particleData.maxParticles)
+			growCapacity(particleData.nbParticles + nbBorn);
+
+		size_t nbOldParticles = particleData.nbParticles;
+		initParticles(std::min(nbBorn,particleData.maxParticles - particleData.nbParticles),emitterIndex,nbManualBorn);
+
+		// Computes the distance of particles from the camera (only for new particles if already computed within tiles)
+		if (distanceComputationEnabled && distanceUpdateEnabled)
+			updateDistances(fusedDistances ? nbOldParticles : 0,particleData.nbParticles);
+
+		if (instancingEnabled)
+			updateInstances(deltaTime);
+
+		if (elasticCapacityEnabled)
+			shrinkCapacity(deltaTime);
+
+		emptyBufferedParticles();
+
+		return hasAliveEmitters || particleData.nbParticles > 0;
+	}
+
+	namespace
+	{
+		// Orders the indices of particles by increasing energy
+		class EnergyComparator
+		{
+		public :
+
+			EnergyComparator(const float* energies) : energies(energies) {}
+			bool operator()(unsigned int index0,unsigned int index1) const { return energies[index0] < energies[index1]; }
+
+		private :
+
+			const float* energies;
+		};
+	}
 
-				if (!replaceDeadParticle)
+	void Group::dropParticles(size_t nb)
+	{
+		// The particles with the lowest energy are killed (the sort buffer is only used as a scratch buffer here)
+		sortBuffer.resize(particleData.nbParticles);
+		for (size_t i = 0; i < particleData.nbParticles; ++i)
+			sortBuffer[i] = static_cast<unsigned int>(i);
+		std::nth_element(sortBuffer.begin(),sortBuffer.begin() + (nb - 1),sortBuffer.end(),EnergyComparator(particleData.energies));
+
+		for (size_t i = 0; i < nb; ++i)
+			particleData.energies[sortBuffer[i]] = 0.0f;
+	}
+
+	bool Group::updateEmitters(const std::vector<Ref<Emitter> >& emitters,float deltaTime,size_t instance,size_t& nbBorn)
+	{
+		bool hasAliveEmitters = false;
+		for (std::vector<Ref<Emitter> >::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
+			if ((*it)->isActive())
+			{
+				int nb = (*it)->updateTankFromTime(deltaTime);
+				if (nb > 0)
 				{
-					swapParticles(i,particleData.nbParticles - 1);
-					--particleData.nbParticles;
-					--i; // As we need to test the swapped particle
+					activeEmitters.push_back(WeakEmitterPair(*it,nb,instance));
+					nbBorn += nb;
 				}
+
+				hasAliveEmitters |= ((*it)->getCurrentTank() != 0); // An emitter with some particles in its tank is still potentially alive
+			}
+
+		return hasAliveEmitters;
+	}
+
+	size_t Group::getNbRequestedBirths(float deltaTime) const
+	{
+		size_t nbBorn = nbBufferedParticles;
+		float emissionTime = deltaTime * emissionScale;
+		if (!instancingEnabled)
+			nbBorn += getNbBornFromEmitters(emitters,emissionTime);
+		else
+			for (size_t i = 0; i < instances.size(); ++i)
+				if (instances[i].alive)
+					nbBorn += getNbBornFromEmitters(instances[i].emitters,emissionTime);
+		return nbBorn;
+	}
+
+	size_t Group::getNbBornFromEmitters(const std::vector<Ref<Emitter> >& emitters,float deltaTime)
+	{
+		size_t nbBorn = 0;
+		for (std::vector<Ref<Emitter> >::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
+			if ((*it)->isActive())
+				nbBorn += (*it)->getNbBornFromTime(deltaTime);
+		return nbBorn;
+	}
+
+	void Group::updateTile(size_t start,size_t end,float deltaTime,bool interpolate,size_t nbModifiers,bool computeDistances)
+	{
+		// Updates the age of the particles function of the delta time
+		SIMD::updateAges(particleData.ages,start,end,deltaTime);
+
+		// Computes the energy of the particles (if they are not immortal)
+		if (!immortal)
+			SIMD::computeEnergies(particleData.energies,particleData.ages,particleData.lifeTimes,start,end);
+
+		// Updates the position of particles function of their velocity
+		if (!still)
+			integrateParticles(start,end,deltaTime);
+
+		// Gathers the vectors of the tile if they are accessed by the following stages
+		bool accessVectors = particleData.splitStorage && (nbModifiers > 0 || (interpolate && (colorInterpolator.obj || nbEnabledParameters > 0)));
+		if (accessVectors)
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			{
+				const SplitArray& splitArray = particleData.splitArrays[i];
+				SIMD::gather(getVectorArray(static_cast<VectorArray>(i)),splitArray.coords[0],splitArray.coords[1],splitArray.coords[2],start,end);
 			}
 
-		// Emits new particles if some left
-		while (nbBorn > 0 && particleData.maxParticles - particleData.nbParticles > 0)
+		// Interpolates the parameters
+		if (interpolate)
 		{
-			if (!initParticle(particleData.nbParticles++,emitterIndex,nbManualBorn))
-				--particleData.nbParticles;
-			--nbBorn;
+			if (colorInterpolator.obj)
+				colorInterpolator.obj->interpolateRange(particleData.colors,*this,colorInterpolator.dataSet,start,end);
+			for (size_t i = 0; i < nbEnabledParameters; ++i)
+			{
+				FloatInterpolatorDef& interpolator = paramInterpolators[enabledParamIndices[i]];
+				interpolator.obj->interpolateRange(particleData.parameters[enabledParamIndices[i]],*this,interpolator.dataSet,start,end);
+			}
 		}
 
+		// Modifies the particles with the fused modifiers
+		for (size_t i = 0; i < nbModifiers; ++i)
+			activeModifiers[i].obj->modifyRange(*this,activeModifiers[i].dataSet,deltaTime,start,end);
+
+		// Copies back the vectors of the tile
+		if (accessVectors)
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			{
+				const SplitArray& splitArray = particleData.splitArrays[i];
+				SIMD::scatter(getVectorArray(static_cast<VectorArray>(i)),splitArray.coords[0],splitArray.coords[1],splitArray.coords[2],start,end);
+			}
+
 		// Computes the distance of particles from the camera
-		if (distanceComputationEnabled)
+		if (computeDistances)
+			updateDistances(start,end);
+	}
+
+	Group::UpdateTask::UpdateTask(Group& group,float deltaTime,bool interpolate,size_t nbModifiers,bool computeDistances,const ParticleData* renderColumns) :
+		group(group),
+		deltaTime(deltaTime),
+		interpolate(interpolate),
+		nbModifiers(nbModifiers),
+		computeDistances(computeDistances),
+		renderColumns(renderColumns)
+	{}
+
+	void Group::UpdateTask::execute(size_t start,size_t end)
+	{
+		size_t rangeSize = group.fusedUpdateEnabled ? group.tileSize : end - start;
+		for (size_t tileStart = start; tileStart < end; tileStart += rangeSize)
 		{
-			for (size_t i = 0; i < particleData.nbParticles; ++i)
-				particleData.sqrDists[i] = getSqrDist(particleData.positions[i],system->getCameraPosition());
+			size_t tileEnd = std::min(tileStart + rangeSize,end);
+			if (renderColumns != NULL)
+				group.copyColumns(*renderColumns,tileStart,tileEnd); // The tile is still in cache when it is updated
+			group.updateTile(tileStart,tileEnd,deltaTime,interpolate,nbModifiers,computeDistances);
 		}
+	}
 
-		emptyBufferedParticles();
+	void Group::integrateParticles(size_t start,size_t end,float deltaTime)
+	{
+		if (particleData.splitStorage)
+		{
+			SplitArray& positions = particleData.splitArrays[VECTOR_ARRAY_POSITIONS];
+			SplitArray& oldPositions = particleData.splitArrays[VECTOR_ARRAY_OLD_POSITIONS];
+			const SplitArray& velocities = particleData.splitArrays[VECTOR_ARRAY_VELOCITIES];
+			for (size_t i = 0; i < 3; ++i)
+				SIMD::integrate(positions.coords[i],oldPositions.coords[i],velocities.coords[i],start,end,deltaTime);
+		}
+		else // As a Vector3D is made of 3 floats, arrays of vectors are integrated as arrays of floats
+			SIMD::integrate(
+				reinterpret_cast<float*>(particleData.positions),
+				reinterpret_cast<float*>(particleData.oldPositions),
+				reinterpret_cast<const float*>(particleData.velocities),
+				start * 3,
+				end * 3,
+				deltaTime);
+	}
 
-		return hasAliveEmitters || particleData.nbParticles > 0;
+	void Group::updateDistances(size_t start,size_t end)
+	{
+		const Vector3D& cameraPosition = system->getCameraPosition();
+		if (particleData.splitStorage)
+		{
+			scatterVectors(VECTOR_ARRAY_POSITIONS);
+			const SplitArray& positions = particleData.splitArrays[VECTOR_ARRAY_POSITIONS];
+			SIMD::computeSqrDists(particleData.sqrDists,positions.coords[0],positions.coords[1],positions.coords[2],start,end,cameraPosition);
+		}
+		else
+			for (size_t i = start; i < end; ++i)
+				particleData.sqrDists[i] = getSqrDist(particleData.positions[i],cameraPosition);
 	}
 
 	void Group::renderParticles()
 	{
-		if (renderer.obj && renderer.obj->isActive())
+		if (renderState != NULL)
+		{
+			// With the asynchronous update, the render state is rendered with the renderer of the update it comes from
+			RendererDef& viewRenderer = renderView->renderer;
+			if (viewRenderer.obj && viewRenderer.obj->isActive())
+			{
+				DataSet* dataSet = NULL;
+				if (viewRenderer.obj->needsDataSet())
+				{
+					if (!renderState->rendererData.isInitialized())
+						return;
+					dataSet = &renderState->rendererData;
+				}
+
+				if (viewRenderer.renderBuffer == NULL)
+					viewRenderer.renderBuffer = viewRenderer.obj->attachRenderBuffer(*renderView);
+				viewRenderer.obj->render(*renderView,dataSet,viewRenderer.renderBuffer);
+			}
+		}
+		else if (renderer.obj && renderer.obj->isActive())
 		{
 			renderer.obj->prepareData(*this,renderer.dataSet);
 			if (renderer.renderBuffer == NULL)
@@ -274,30 +645,130 @@ namespace SPK
 	{
 		SPK_ASSERT(capacity != 0,"Group::reallocate(size_t) - Group capacity must not be 0");
 
-		if (isInitialized() && (!particleData.initialized || capacity != particleData.maxParticles))
+		minCapacity = capacity;
+
+		if (isInitialized() && particleData.initialized)
 		{
-			destroyAllAdditionnalData();
+			if (capacity != particleData.maxParticles)
+				resizeCapacity(capacity); // Data sets that could not be resized are created again at the next update
+		}
+		else
+		{
+			if (isInitialized())
+			{
+				destroyAllAdditionnalData();
+				reallocateSlab(capacity,0);
+				particleData.initialized = true;
+			}
+
+			particleData.maxParticles = capacity;
+		}
+	}
 
-			size_t copySize = particleData.nbParticles;
-			if (capacity < copySize)
-				copySize = capacity;
+	bool Group::resizeCapacity(size_t capacity)
+	{
+		size_t copySize = particleData.nbParticles;
+		if (capacity < copySize)
+			copySize = capacity;
+
+		reallocateSlab(capacity,copySize);
+		particleData.nbParticles = copySize;
+		particleData.maxParticles = capacity;
 
-			reallocateArray(particleData.positions,capacity,copySize);
-			reallocateArray(particleData.velocities,capacity,copySize);
-			reallocateArray(particleData.oldPositions,capacity,copySize);
-			reallocateArray(particleData.ages,capacity,copySize);
-			reallocateArray(particleData.lifeTimes,capacity,copySize);
-			reallocateArray(particleData.energies,capacity,copySize);
-			reallocateArray(particleData.sqrDists,capacity,copySize);
-			reallocateArray(particleData.colors,capacity,copySize);
+		destroyRenderBuffer(); // Render buffers are sized from the capacity
 
-			for (size_t i = 0; i < nbEnabledParameters; ++i)
-				reallocateArray(particleData.parameters[enabledParamIndices[i]],capacity,copySize);
+		bool resized = true;
+		for (std::list<DataSet>::iterator it = dataSets.begin(); it != dataSets.end(); ++it)
+			if (it->isInitialized() && !it->resize(capacity,copySize))
+			{
+				it->destroyAllData();
+				resized = false;
+			}
+
+		return resized;
+	}
+
+	void Group::growCapacity(size_t nbNeeded)
+	{
+		size_t capacity = static_cast<size_t>(particleData.maxParticles * growthFactor);
+		if (capacity < nbNeeded)
+			capacity = nbNeeded;
+		if (maxCapacity != 0 && capacity > maxCapacity)
+			capacity = maxCapacity;
+
+		if (capacity > particleData.maxParticles && !resizeCapacity(capacity))
+			prepareAdditionnalData(); // Creates again the data sets that could not be resized before particles are born
+	}
 
-			particleData.initialized = true;
+	void Group::shrinkCapacity(float deltaTime)
+	{
+		size_t capacity = static_cast<size_t>(particleData.nbParticles * growthFactor);
+		if (capacity < minCapacity)
+			capacity = minCapacity;
+
+		// The capacity only shrinks if the group stays below the shrink threshold so that it does not oscillate
+		if (capacity < particleData.maxParticles && particleData.nbParticles * growthFactor * growthFactor < particleData.maxParticles)
+		{
+			shrinkTime += deltaTime;
+			if (shrinkTime >= shrinkDelay)
+			{
+				shrinkTime = 0.0f;
+				if (!resizeCapacity(capacity))
+					prepareAdditionnalData(); // The data sets must be valid for the sorting that follows the update
+			}
 		}
+		else
+			shrinkTime = 0.0f;
+	}
 
-		particleData.maxParticles = capacity;
+	void Group::setGrowthFactor(float growthFactor)
+	{
+		if (growthFactor <= 1.0f)
+		{
+			growthFactor = DEFAULT_GROWTH_FACTOR;
+			SPK_LOG_WARNING("Group::setGrowthFactor(float) - The growth factor must be greater than 1 - " << DEFAULT_GROWTH_FACTOR << " is used");
+		}
+		this->growthFactor = growthFactor;
+	}
+
+	void Group::setTileSize(unsigned int tileSize)
+	{
+		if (tileSize == 0)
+		{
+			tileSize = DEFAULT_TILE_SIZE;
+			SPK_LOG_WARNING("Group::setTileSize(unsigned int) - The tile size cannot be set to 0 - " << DEFAULT_TILE_SIZE << " is used");
+		}
+		this->tileSize = tileSize;
+	}
+
+	void Group::enableSplitStorage(bool split)
+	{
+		if (split == particleData.splitStorage)
+			return;
+
+		if (split)
+		{
+			particleData.splitStorage = true;
+			if (particleData.initialized)
+			{
+				reallocateSlab(particleData.maxParticles,particleData.nbParticles);
+				for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+				{
+					SplitArray& splitArray = particleData.splitArrays[i];
+					SIMD::scatter(getVectorArray(static_cast<VectorArray>(i)),splitArray.coords[0],splitArray.coords[1],splitArray.coords[2],0,particleData.nbParticles);
+				}
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+				readVectors(static_cast<VectorArray>(i));
+			destroySplitArrays();
+			particleData.splitStorage = false;
+
+			if (particleData.initialized)
+				reallocateSlab(particleData.maxParticles,particleData.nbParticles); // Releases the memory of the split arrays
+		}
 	}
 
 	void Group::setColorInterpolator(const Ref<ColorInterpolator>& interpolator)
@@ -314,24 +785,20 @@ namespace SPK
 	{
 		if (paramInterpolators[param].obj != interpolator)
 		{
+			bool enabledChanged = !paramInterpolators[param].obj != !interpolator;
 			if (!paramInterpolators[param].obj && interpolator)
 			{
 				if (particleData.parameters[param] != NULL)
 					SPK_LOG_FATAL("Group::setParamInterpolator(Param,FloatInterpolator*) - Unexpected memory leak happened");
-
-				// Creates the data for the parameter
-				if (isInitialized())
-					particleData.parameters[param] = SPK_NEW_ARRAY(float,particleData.maxParticles);
 			}
 			else if (paramInterpolators[param].obj && !interpolator)
 			{
-				if (particleData.parameters[param] == NULL)
+				if (particleData.initialized && particleData.parameters[param] == NULL)
 				{
 					SPK_LOG_FATAL("Group::setParamInterpolator(Param,FloatInterpolator*) - Unexpected error happened");
 				}
 
-				// Destroys the data for the parameter
-				SPK_DELETE_ARRAY(particleData.parameters[param]);
+				// The data for the parameter is removed from the slab
 				particleData.parameters[param] = NULL;
 			}
 
@@ -341,6 +808,10 @@ namespace SPK
 			paramInterpolators[param].dataSet = attachDataSet(interpolator.get());
 
 			recomputeEnabledParamIndices();
+
+			// Creates or destroys the data for the parameter
+			if (enabledChanged && particleData.initialized)
+				reallocateSlab(particleData.maxParticles,particleData.nbParticles);
 		}
 	}
 
@@ -449,6 +920,9 @@ namespace SPK
 
 			this->renderer.obj = renderer;
 			this->renderer.dataSet = attachDataSet(renderer.get());
+
+			if (renderState != NULL)
+				renderState->rendererDataPending = false; // The data of the render state belongs to the previous renderer
 		}
 	}
 
@@ -460,76 +934,121 @@ namespace SPK
 				enabledParamIndices[nbEnabledParameters++] = i;
 	}
 
-	bool Group::initParticle(size_t index,size_t& emitterIndex,size_t& nbManualBorn)
+	void Group::updateRenderSide()
+	{
+		RandomStreamScope randomStreamScope(randomStream);
+		prepareAdditionnalData();
+
+		if (renderer.obj)
+		{
+			renderer.obj->update(*this,renderer.dataSet);
+			rendererDeltaTime = 0.0f;
+		}
+
+		if (distanceComputationEnabled)
+			updateDistances(0,particleData.nbParticles);
+	}
+
+	void Group::initParticles(size_t nb,size_t& emitterIndex,size_t& nbManualBorn)
 	{
-		Particle particle(getParticle(index));
+		if (nb == 0)
+			return;
 
-		particleData.ages[index] = 0.0f;
-		particleData.energies[index] = 1.0f;
-		particleData.lifeTimes[index] = SPK_RANDOM(minLifeTime,maxLifeTime);
+		// The particles are appended and initialized stage by stage so that each stage is a single call for the whole burst
+		size_t start = particleData.nbParticles;
+		size_t end = start + nb;
+		particleData.nbParticles = end;
+
+		std::fill(particleData.ages + start,particleData.ages + end,0.0f);
+		std::fill(particleData.energies + start,particleData.energies + end,1.0f);
+		randomStream.fill(particleData.lifeTimes + start,nb,minLifeTime,maxLifeTime);
 
 		if (colorInterpolator.obj)
-			colorInterpolator.obj->init(particleData.colors[index],particle,colorInterpolator.dataSet);
+			colorInterpolator.obj->initRange(particleData.colors,*this,colorInterpolator.dataSet,start,end);
 		else
-			particleData.colors[index] = 0xFFFFFFFF;
+			std::fill(particleData.colors + start,particleData.colors + end,Color(0xFFFFFFFF));
 
 		for (size_t i = 0; i < nbEnabledParameters; ++i)
 		{
 			FloatInterpolatorDef& interpolator = paramInterpolators[enabledParamIndices[i]];
-			interpolator.obj->init(particleData.parameters[enabledParamIndices[i]][index],particle,interpolator.dataSet);
+			interpolator.obj->initRange(particleData.parameters[enabledParamIndices[i]],*this,interpolator.dataSet,start,end);
 		}
 
-		if (nbManualBorn == 0)
-		{
-			activeEmitters[emitterIndex].obj->emit(particle);
-			if (--activeEmitters[emitterIndex].nbBorn == 0)
-				++emitterIndex;
-		}
-		else
+		// Buffered particles are born first, then the particles of the active emitters
+		for (size_t index = start; index < end;)
 		{
-			CreationData& creationData = creationBuffer.front();
-
-			if (creationData.zone)
-				creationData.zone->generatePosition(particle.position(),creationData.full,particle.getRadius());
-			else
-				particle.position() = creationData.position;
-
-			if (creationData.emitter)
+			if (nbManualBorn == 0)
 			{
-				float speed = SPK_RANDOM(creationData.emitter->getForceMin(),creationData.emitter->getForceMax()) / particle.getParam(PARAM_MASS);
-				creationData.emitter->generateVelocity(particle,speed);
+				WeakEmitterPair& emitterPair = activeEmitters[emitterIndex];
+				size_t nbEmitted = std::min(emitterPair.nbBorn,end - index);
+				emitterPair.obj->emitRange(*this,index,index + nbEmitted);
+				if (particleData.instanceIds != NULL)
+					std::fill(particleData.instanceIds + index,particleData.instanceIds + index + nbEmitted,static_cast<unsigned int>(emitterPair.instance));
+				if ((emitterPair.nbBorn -= nbEmitted) == 0)
+					++emitterIndex;
+				index += nbEmitted;
 			}
 			else
-				particle.velocity() = creationData.velocity;
+			{
+				// Particles added with addParticles are born before the enqueued ones
+				size_t nbCreated;
+				if (!creationBuffer.empty())
+				{
+					CreationData& creationData = creationBuffer.front();
+					nbCreated = std::min(static_cast<size_t>(creationData.nb),end - index);
+					generateBufferedParticles(index,index + nbCreated,creationData.position,creationData.velocity,creationData.zone.get(),creationData.emitter.get(),creationData.full);
+					if ((creationData.nb -= nbCreated) == 0)
+						creationBuffer.pop_front();
+				}
+				else
+				{
+					SpawnRequest& request = spawnRequests[spawnRequestIndex];
+					nbCreated = std::min(static_cast<size_t>(request.nb),end - index);
+					generateBufferedParticles(index,index + nbCreated,request.position,request.velocity,request.zone,request.emitter,request.full);
+					if ((request.nb -= nbCreated) == 0)
+						++spawnRequestIndex;
+				}
 
-			--creationBuffer.front().nb;
-			--nbManualBorn;
-			--nbBufferedParticles;
-			if (creationBuffer.front().nb <= 0)
-				creationBuffer.pop_front();
+				if (particleData.instanceIds != NULL)
+					std::fill(particleData.instanceIds + index,particleData.instanceIds + index + nbCreated,static_cast<unsigned int>(NO_INSTANCE));
+
+				nbManualBorn -= nbCreated;
+				nbBufferedParticles -= nbCreated;
+				index += nbCreated;
+			}
 		}
 
-		particleData.oldPositions[index] = particleData.positions[index];
+		for (GroupIterator particleIt(*this,start,end); !particleIt.end(); ++particleIt)
+			particleIt->oldPosition() = particleIt->position();
 
 		for (std::vector<WeakModifierDef>::iterator it = initModifiers.begin(); it != initModifiers.end(); ++it)
-			it->obj->init(particle,it->dataSet);
+			it->obj->initRange(*this,it->dataSet,start,end);
 
-		if (particle.isAlive())
-		{
-			if (renderer.obj && renderer.obj->isActive())
-				renderer.obj->init(particle,renderer.dataSet);
-
-			// birth action
-			if (birthAction && birthAction->isActive())
-				birthAction->apply(particle);
+		// Removes the particles born dead (no birth neither death actions on them)
+		deadParticles.clear();
+		for (size_t i = start; i < end; ++i)
+			if (particleData.energies[i] <= 0.0f)
+			{
+				SPK_LOG_DEBUG("Particle " << i << " of Group " << this << " is born-dead");
+				deadParticles.push_back(i);
+			}
 
-			return true;
-		}
-		else
+		if (!deadParticles.empty())
 		{
-			SPK_LOG_DEBUG("Particle " << index << " of Group " << this << " is born-dead");
-			return false; // No birth neither death actions on born-dead particles
+			compactParticles();
+			end = particleData.nbParticles;
 		}
+
+		if (renderer.obj && renderer.obj->isActive())
+			renderer.obj->initRange(*this,renderer.dataSet,start,end);
+
+		// birth action
+		if (birthAction && birthAction->isActive())
+			for (size_t i = start; i < end; ++i)
+			{
+				Particle particle = getParticle(i); // fix for gcc
+				birthAction->apply(particle);
+			}
 	}
 
 	void Group::swapParticles(size_t index0,size_t index1)
@@ -543,16 +1062,81 @@ namespace SPK
 		std::swap(particleData.lifeTimes[index0],particleData.lifeTimes[index1]);
 		std::swap(particleData.sqrDists[index0],particleData.sqrDists[index1]);
 		std::swap(particleData.colors[index0],particleData.colors[index1]);
+		if (particleData.instanceIds != NULL)
+			std::swap(particleData.instanceIds[index0],particleData.instanceIds[index1]);
 
 		// Swaps particles enabled parameters
 		for (size_t i = 0; i < nbEnabledParameters; ++i)
 			std::swap(particleData.parameters[enabledParamIndices[i]][index0],particleData.parameters[enabledParamIndices[i]][index1]);
 
+		// Swaps particles split vectors (both the split arrays and their view are swapped so they remain consistent)
+		if (particleData.splitStorage)
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			{
+				SplitArray& splitArray = particleData.splitArrays[i];
+				for (size_t j = 0; j < 3; ++j)
+					std::swap(splitArray.coords[j][index0],splitArray.coords[j][index1]);
+
+				bool dirty0 = index0 >= splitArray.dirtyStart && index0 < splitArray.dirtyEnd;
+				bool dirty1 = index1 >= splitArray.dirtyStart && index1 < splitArray.dirtyEnd;
+				if (dirty0 != dirty1)
+				{
+					splitArray.dirtyStart = std::min(splitArray.dirtyStart,std::min(index0,index1));
+					splitArray.dirtyEnd = std::max(splitArray.dirtyEnd,std::max(index0,index1) + 1);
+				}
+			}
+
 		// Swaps particles additionnal swappable data
 		for (std::list<DataSet>::iterator it = dataSets.begin(); it != dataSets.end(); ++it)
 			it->swap(index0,index1);
 	}
 
+	void Group::compactParticles()
+	{
+		const size_t* deadIndices = &deadParticles[0];
+		size_t nbDead = deadParticles.size();
+		size_t nbParticles = particleData.nbParticles;
+
+		// Compacts particles vectors (with split storage, the view is compacted only if up to date)
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+		{
+			VectorArray array = static_cast<VectorArray>(i);
+			if (particleData.splitStorage)
+			{
+				scatterVectors(array);
+				SplitArray& splitArray = particleData.splitArrays[i];
+				for (size_t j = 0; j < 3; ++j)
+					Data::compactArray(splitArray.coords[j],1,deadIndices,nbDead,nbParticles);
+				if (!splitArray.viewValid)
+					continue;
+			}
+			Data::compactArray(getVectorArray(array),1,deadIndices,nbDead,nbParticles);
+		}
+
+		// Compacts particles attributes
+		Data::compactArray(particleData.ages,1,deadIndices,nbDead,nbParticles);
+		Data::compactArray(particleData.energies,1,deadIndices,nbDead,nbParticles);
+		Data::compactArray(particleData.lifeTimes,1,deadIndices,nbDead,nbParticles);
+		Data::compactArray(particleData.sqrDists,1,deadIndices,nbDead,nbParticles);
+		Data::compactArray(particleData.colors,1,deadIndices,nbDead,nbParticles);
+		if (particleData.instanceIds != NULL)
+			Data::compactArray(particleData.instanceIds,1,deadIndices,nbDead,nbParticles);
+
+		// Compacts particles enabled parameters
+		for (size_t i = 0; i < nbEnabledParameters; ++i)
+			Data::compactArray(particleData.parameters[enabledParamIndices[i]],1,deadIndices,nbDead,nbParticles);
+
+		// Compacts particles additionnal data
+		for (std::list<DataSet>::iterator it = dataSets.begin(); it != dataSets.end(); ++it)
+			it->compact(deadIndices,nbDead,nbParticles);
+
+		// Keeps the order of the particles sorted by index
+		if (!sortedIndices.empty())
+			remapSortedIndices(deadIndices,nbDead,nbParticles);
+
+		particleData.nbParticles -= nbDead;
+	}
+
 	DataSet* Group::attachDataSet(DataHandler* dataHandler)
 	{
 		if (!isInitialized())
@@ -592,31 +1176,222 @@ namespace SPK
 			it->destroyAllData();
 	}
 
-	void Group::manageOctreeInstance(bool needsOctree)
+	void Group::manageNeighborStructureInstance(bool needsNeighborStructure)
 	{
-		if (needsOctree && octree == NULL) // creates an octree if needed
-			octree = SPK_NEW(Octree,this);
-		else if (!needsOctree && octree != NULL) // deletes the octree if no more needed
+		if (neighborStructure != NULL && (!needsNeighborStructure || neighborStructure->getType() != neighborStructureType)) // deletes the structure if no more needed or of another type
 		{
-			SPK_DELETE(octree);
-			octree = NULL;
+			SPK_DELETE(neighborStructure);
+			neighborStructure = NULL;
+		}
+
+		if (needsNeighborStructure && neighborStructure == NULL) // creates a structure if needed
+		{
+			if (neighborStructureType == NEIGHBOR_STRUCTURE_GRID)
+				neighborStructure = SPK_NEW(SpatialGrid,this);
+			else
+				neighborStructure = SPK_NEW(Octree,this);
 		}
 	}
 
-	Octree* Group::getOctree()
+	void Group::setNeighborStructureType(NeighborStructureType type)
+	{
+		neighborStructureType = type;
+		manageNeighborStructureInstance(neighborStructure != NULL); // The structure is replaced if one exists
+	}
+
+	void Group::setOctreeMaxLevel(unsigned int maxLevel)
+	{
+		if (maxLevel > Octree::MAX_LEVEL_INDEX_LIMIT)
+		{
+			maxLevel = Octree::MAX_LEVEL_INDEX_LIMIT;
+			SPK_LOG_WARNING("Group::setOctreeMaxLevel(unsigned int) - The maximum level of the octree cannot exceed " << Octree::MAX_LEVEL_INDEX_LIMIT << " - " << Octree::MAX_LEVEL_INDEX_LIMIT << " is used");
+		}
+		octreeMaxLevel = maxLevel;
+	}
+
+	void Group::setOctreeMaxParticlesPerCell(unsigned int maxParticlesPerCell)
+	{
+		if (maxParticlesPerCell == 0)
+		{
+			maxParticlesPerCell = Octree::DEFAULT_MAX_PARTICLES_NB_PER_CELL;
+			SPK_LOG_WARNING("Group::setOctreeMaxParticlesPerCell(unsigned int) - The maximum number of particles per cell cannot be set to 0 - " << Octree::DEFAULT_MAX_PARTICLES_NB_PER_CELL << " is used");
+		}
+		octreeMaxParticlesPerCell = maxParticlesPerCell;
+	}
+
+	void Group::setOctreeCellSizeFactor(float cellSizeFactor)
 	{
-		bool needsOctree = false;
+		if (cellSizeFactor <= 0.0f)
+		{
+			cellSizeFactor = Octree::DEFAULT_CELL_SIZE_FACTOR;
+			SPK_LOG_WARNING("Group::setOctreeCellSizeFactor(float) - The cell size factor must be positive - " << Octree::DEFAULT_CELL_SIZE_FACTOR << " is used");
+		}
+		octreeCellSizeFactor = cellSizeFactor;
+	}
+
+	void Group::setOctreeRebuildThreshold(float threshold)
+	{
+		if (threshold < 0.0f)
+		{
+			threshold = Octree::DEFAULT_REBUILD_THRESHOLD;
+			SPK_LOG_WARNING("Group::setOctreeRebuildThreshold(float) - The rebuild threshold must be positive - " << Octree::DEFAULT_REBUILD_THRESHOLD << " is used");
+		}
+		octreeRebuildThreshold = threshold;
+	}
+
+	NeighborStructure* Group::getNeighborStructure()
+	{
+		bool needsNeighborStructure = false;
 		for (std::vector<WeakModifierDef>::const_iterator it = sortedModifiers.begin(); it != sortedModifiers.end(); ++it)
-			needsOctree |= it->obj->NEEDS_OCTREE;
-		manageOctreeInstance(needsOctree);
+			needsNeighborStructure |= it->obj->NEEDS_OCTREE;
+		manageNeighborStructureInstance(needsNeighborStructure);
+
+		return neighborStructure;
+	}
 
-		return octree;
+	Octree* Group::getOctree()
+	{
+		NeighborStructure* structure = getNeighborStructure();
+		return structure != NULL && structure->getType() == NEIGHBOR_STRUCTURE_OCTREE ? static_cast<Octree*>(structure) : NULL;
 	}
 
 	void Group::sortParticles()
 	{
-		if (sortingEnabled)
+		if (!sortingEnabled)
+			return;
+
+		// With the asynchronous update, the group may not have written its particles since its render state was swapped
+		const ParticleData* renderColumns = separateRenderState();
+		if (renderColumns != NULL)
+			copyColumns(*renderColumns,0,particleData.nbParticles);
+		restoreRendererData();
+
+		if (indexSortingEnabled)
+			sortIndices();
+		else
+		{
+			sortedIndices.clear();
 			sortParticles(0,particleData.nbParticles - 1);
+		}
+	}
+
+	void Group::sortIndices()
+	{
+		size_t nbParticles = particleData.nbParticles;
+
+		// Starts from the order of the previous update (the indices of the particles removed since are discarded and the new particles are appended)
+		if (sortedIndices.size() > nbParticles)
+		{
+			size_t nbSorted = 0;
+			for (size_t i = 0; i < sortedIndices.size(); ++i)
+				if (sortedIndices[i] < nbParticles)
+					sortedIndices[nbSorted++] = sortedIndices[i];
+			sortedIndices.resize(nbSorted);
+		}
+		for (size_t i = sortedIndices.size(); i < nbParticles; ++i)
+			sortedIndices.push_back(static_cast<unsigned int>(i));
+
+		if (nbParticles < 2)
+			return;
+
+		// The bits of the floats are turned into unsigned keys increasing from the farthest to the nearest particle
+		sortKeys.resize(nbParticles);
+		for (size_t i = 0; i < nbParticles; ++i)
+		{
+			unsigned int bits;
+			std::memcpy(&bits,particleData.sqrDists + i,sizeof(float));
+			sortKeys[i] = ~((bits & 0x80000000) != 0 ? ~bits : bits | 0x80000000);
+		}
+
+		// Between 2 updates, particles hardly change their order so the previous one is refined if possible
+		if (!insertionSortIndices(MAX_SORT_SHIFTS_PER_PARTICLE * nbParticles))
+			radixSortIndices();
+	}
+
+	bool Group::insertionSortIndices(size_t maxShifts)
+	{
+		size_t nbShifts = 0;
+		for (size_t i = 1; i < sortedIndices.size(); ++i)
+		{
+			unsigned int index = sortedIndices[i];
+			unsigned int key = sortKeys[index];
+
+			size_t j = i;
+			while (j > 0 && sortKeys[sortedIndices[j - 1]] > key)
+			{
+				sortedIndices[j] = sortedIndices[j - 1];
+				--j;
+			}
+			sortedIndices[j] = index;
+
+			nbShifts += i - j;
+			if (nbShifts > maxShifts)
+				return false; // The order is too different, the indices are left partially sorted
+		}
+		return true;
+	}
+
+	void Group::radixSortIndices()
+	{
+		const size_t NB_PASSES = sizeof(unsigned int);
+		const size_t NB_BUCKETS = 256;
+
+		size_t nbParticles = sortedIndices.size();
+		sortBuffer.resize(nbParticles);
+
+		// Computes the histograms of all the passes at once
+		size_t counts[NB_PASSES][NB_BUCKETS] = {};
+		for (size_t i = 0; i < nbParticles; ++i)
+			for (size_t j = 0; j < NB_PASSES; ++j)
+				++counts[j][(sortKeys[i] >> (j << 3)) & 0xFF];
+
+		// Least significant digit first, each pass being stable
+		for (size_t j = 0; j < NB_PASSES; ++j)
+		{
+			size_t shift = j << 3;
+			size_t* count = counts[j];
+			if (count[(sortKeys[sortedIndices[0]] >> shift) & 0xFF] == nbParticles)
+				continue; // All the keys have the same digit
+
+			size_t offset = 0;
+			for (size_t k = 0; k < NB_BUCKETS; ++k)
+			{
+				size_t nb = count[k];
+				count[k] = offset;
+				offset += nb;
+			}
+
+			for (size_t i = 0; i < nbParticles; ++i)
+			{
+				unsigned int index = sortedIndices[i];
+				sortBuffer[count[(sortKeys[index] >> shift) & 0xFF]++] = index;
+			}
+			sortedIndices.swap(sortBuffer);
+		}
+	}
+
+	void Group::remapSortedIndices(const size_t* deadIndices,size_t nbDead,size_t nbParticles)
+	{
+		const unsigned int INVALID_INDEX = static_cast<unsigned int>(-1);
+
+		// Computes the index of every particle after the compaction
+		sortBuffer.resize(nbParticles);
+		size_t deadIndex = 0;
+		for (size_t i = 0; i < nbParticles; ++i)
+			if (deadIndex < nbDead && deadIndices[deadIndex] == i)
+			{
+				sortBuffer[i] = INVALID_INDEX;
+				++deadIndex;
+			}
+			else
+				sortBuffer[i] = static_cast<unsigned int>(i - deadIndex);
+
+		// Remaps the order so that it can be reused by the next sort
+		size_t nbSorted = 0;
+		for (size_t i = 0; i < sortedIndices.size(); ++i)
+			if (sortedIndices[i] < nbParticles && sortBuffer[sortedIndices[i]] != INVALID_INDEX)
+				sortedIndices[nbSorted++] = sortBuffer[sortedIndices[i]];
+		sortedIndices.resize(nbSorted);
 	}
 
 	void Group::computeAABB()
@@ -630,6 +1405,14 @@ namespace SPK
 			renderer.obj->prepareData(*this,renderer.dataSet);
 			renderer.obj->computeAABB(AABBMin,AABBMax,*this,renderer.dataSet);
 		}
+		else if (particleData.splitStorage) // Switches to default AABB computation
+		{
+			scatterVectors(VECTOR_ARRAY_POSITIONS);
+			const SplitArray& positions = particleData.splitArrays[VECTOR_ARRAY_POSITIONS];
+			SIMD::computeMinMax(positions.coords[0],0,particleData.nbParticles,AABBMin.x,AABBMax.x);
+			SIMD::computeMinMax(positions.coords[1],0,particleData.nbParticles,AABBMin.y,AABBMax.y);
+			SIMD::computeMinMax(positions.coords[2],0,particleData.nbParticles,AABBMin.z,AABBMax.z);
+		}
 		else // Switches to default AABB computation
 			for (size_t i = 0; i < particleData.nbParticles; ++i)
 			{
@@ -638,6 +1421,285 @@ namespace SPK
 			}
 	}
 
+	void Group::reallocateSlab(size_t capacity,size_t copySize)
+	{
+		// Computes the size of the slab from the columns needed by the group
+		size_t nbFloatColumns = 4 + nbEnabledParameters; // ages, energies, lifetimes, square distances and parameters
+		if (particleData.splitStorage)
+			nbFloatColumns += 3 * NB_VECTOR_ARRAYS;
+
+		size_t slabSize = NB_VECTOR_ARRAYS * getColumnSize(sizeof(Vector3D),capacity)
+			+ nbFloatColumns * getColumnSize(sizeof(float),capacity)
+			+ getColumnSize(sizeof(Color),capacity);
+		if (instancingEnabled)
+			slabSize += getColumnSize(sizeof(unsigned int),capacity);
+
+		char* oldSlab = particleData.slab;
+		particleData.slab = reinterpret_cast<char*>(SIMD::allocate(slabSize / sizeof(float)));
+		particleData.slabSize = slabSize;
+
+		// Places the columns one after the other and copies the data from the previous slab
+		char* address = particleData.slab;
+		placeColumn(particleData.positions,address,capacity,copySize);
+		placeColumn(particleData.velocities,address,capacity,copySize);
+		placeColumn(particleData.oldPositions,address,capacity,copySize);
+		placeColumn(particleData.ages,address,capacity,copySize);
+		placeColumn(particleData.energies,address,capacity,copySize);
+		placeColumn(particleData.lifeTimes,address,capacity,copySize);
+		placeColumn(particleData.sqrDists,address,capacity,copySize);
+		placeColumn(particleData.colors,address,capacity,copySize);
+		if (instancingEnabled)
+			placeColumn(particleData.instanceIds,address,capacity,copySize);
+		else
+			particleData.instanceIds = NULL;
+
+		for (size_t i = 0; i < nbEnabledParameters; ++i)
+			placeColumn(particleData.parameters[enabledParamIndices[i]],address,capacity,copySize);
+
+		if (particleData.splitStorage)
+			for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+				for (size_t j = 0; j < 3; ++j)
+					placeColumn(particleData.splitArrays[i].coords[j],address,capacity,copySize);
+
+		// The slab shared with the render state is released by the state
+		if (renderState == NULL || oldSlab != renderState->particleData.slab)
+			SIMD::deallocate(reinterpret_cast<float*>(oldSlab));
+	}
+
+	namespace
+	{
+		// Moves a column of particles to another slab where it is placed at the same offset
+		template<typename T>
+		void rebaseColumn(T*& column,const char* oldSlab,char* slab)
+		{
+			if (column != NULL)
+				column = reinterpret_cast<T*>(slab + (reinterpret_cast<const char*>(column) - oldSlab));
+		}
+
+		// Copies a range of a column of particles from a column with the same layout
+		template<typename T>
+		void copyColumn(T* column,const T* source,size_t start,size_t end)
+		{
+			if (column != NULL)
+				std::copy(source + start,source + end,column + start);
+		}
+	}
+
+	void Group::rebaseColumns(const char* oldSlab)
+	{
+		char* slab = particleData.slab;
+		rebaseColumn(particleData.positions,oldSlab,slab);
+		rebaseColumn(particleData.velocities,oldSlab,slab);
+		rebaseColumn(particleData.oldPositions,oldSlab,slab);
+		rebaseColumn(particleData.ages,oldSlab,slab);
+		rebaseColumn(particleData.energies,oldSlab,slab);
+		rebaseColumn(particleData.lifeTimes,oldSlab,slab);
+		rebaseColumn(particleData.sqrDists,oldSlab,slab);
+		rebaseColumn(particleData.colors,oldSlab,slab);
+		rebaseColumn(particleData.instanceIds,oldSlab,slab);
+		for (size_t i = 0; i < NB_PARAMETERS; ++i)
+			rebaseColumn(particleData.parameters[i],oldSlab,slab);
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			for (size_t j = 0; j < 3; ++j)
+				rebaseColumn(particleData.splitArrays[i].coords[j],oldSlab,slab);
+	}
+
+	void Group::copyColumns(const ParticleData& source,size_t start,size_t end)
+	{
+		copyColumn(particleData.positions,source.positions,start,end);
+		copyColumn(particleData.velocities,source.velocities,start,end);
+		copyColumn(particleData.oldPositions,source.oldPositions,start,end);
+		copyColumn(particleData.ages,source.ages,start,end);
+		copyColumn(particleData.energies,source.energies,start,end);
+		copyColumn(particleData.lifeTimes,source.lifeTimes,start,end);
+		copyColumn(particleData.sqrDists,source.sqrDists,start,end);
+		copyColumn(particleData.colors,source.colors,start,end);
+		copyColumn(particleData.instanceIds,source.instanceIds,start,end);
+		for (size_t i = 0; i < NB_PARAMETERS; ++i)
+			copyColumn(particleData.parameters[i],source.parameters[i],start,end);
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			for (size_t j = 0; j < 3; ++j)
+				copyColumn(particleData.splitArrays[i].coords[j],source.splitArrays[i].coords[j],start,end);
+	}
+
+	void Group::prepareRenderState()
+	{
+		if (renderState == NULL)
+		{
+			renderState = SPK_NEW(RenderState);
+
+			// The view does not draw from the random stream of the context so that the asynchronous update does not change the randomness
+			RandomStream stream;
+			RandomStreamScope randomStreamScope(stream);
+			renderView = SPK_NEW(Group,SPK_NULL_REF,1); // The view is not part of any system, it only points to the render state
+		}
+	}
+
+	void Group::completeRenderState()
+	{
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			readVectors(static_cast<VectorArray>(i)); // Only the arrays of vectors are rendered
+	}
+
+	void Group::swapRenderState()
+	{
+		if (renderState == NULL || renderState->shared)
+			return; // The group did not write its particles since the previous swap
+
+		// The slab of the previous state is the one the group will move to
+		RenderState& state = *renderState;
+		SIMD::deallocate(reinterpret_cast<float*>(state.spareSlab));
+		state.spareSlab = state.particleData.slab;
+		state.spareSlabSize = state.particleData.slabSize;
+
+		bool capacityChanged = state.particleData.maxParticles != particleData.maxParticles;
+		bool rendererChanged = renderView->renderer.obj != renderer.obj;
+
+#ifdef _DEBUG
+		// The view renders the arrays of vectors as they are so they must have been gathered (see completeRenderState())
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+			checkVectors(static_cast<VectorArray>(i));
+#endif
+
+		state.particleData = particleData;
+		state.shared = true;
+
+		// The view reads the columns of the state as arrays of vectors
+		Group& view = *renderView;
+		view.particleData = particleData;
+		view.particleData.splitStorage = false;
+		view.particleData.slab = NULL;
+		view.sortedIndices.swap(sortedIndices);
+		view.sortingEnabled = sortingEnabled;
+		view.indexSortingEnabled = indexSortingEnabled;
+		view.AABBMin = AABBMin;
+		view.AABBMax = AABBMax;
+		view.graphicalRadius = graphicalRadius;
+		view.physicalRadius = physicalRadius;
+
+		if (capacityChanged || rendererChanged)
+		{
+			view.destroyRenderBuffer(); // Render buffers are sized from the capacity
+			view.renderer.obj = renderer.obj;
+		}
+
+		// The data of the renderer is swapped and copied back to the group at its next update
+		if (renderer.dataSet != NULL)
+		{
+			state.rendererData.swapData(*renderer.dataSet);
+			if (capacityChanged || rendererChanged)
+				renderer.dataSet->destroyAllData(); // The previous data does not fit, it is created again
+			state.rendererDataPending = true;
+		}
+		else
+			state.rendererData.destroyAllData();
+	}
+
+	void Group::releaseRenderState()
+	{
+		if (renderState != NULL)
+		{
+			RenderState& state = *renderState;
+			if (state.shared)
+			{
+				// The group gets back its sorted indices and the data of its renderer
+				sortedIndices.swap(renderView->sortedIndices);
+				if (state.rendererDataPending)
+					renderer.dataSet->swapData(state.rendererData);
+			}
+			else
+				SIMD::deallocate(reinterpret_cast<float*>(state.particleData.slab));
+
+			SIMD::deallocate(reinterpret_cast<float*>(state.spareSlab));
+			SPK_DELETE(renderState);
+			renderState = NULL;
+		}
+
+		renderView = SPK_NULL_REF;
+	}
+
+	const Group::ParticleData* Group::separateRenderState()
+	{
+		if (renderState == NULL || !renderState->shared)
+			return NULL;
+
+		RenderState& state = *renderState;
+		state.shared = false;
+
+		sortedIndices = renderView->sortedIndices; // The sorting starts from the previous order
+
+		if (particleData.slab != state.particleData.slab)
+			return NULL; // The group was reallocated since the swap
+
+		if (state.spareSlabSize < particleData.slabSize)
+		{
+			SIMD::deallocate(reinterpret_cast<float*>(state.spareSlab));
+			state.spareSlab = reinterpret_cast<char*>(SIMD::allocate(particleData.slabSize / sizeof(float)));
+			state.spareSlabSize = particleData.slabSize;
+		}
+
+		// The group moves to the spare slab, the columns are copied by the caller (within the tiles of the update if possible)
+		char* oldSlab = particleData.slab;
+		particleData.slab = state.spareSlab;
+		particleData.slabSize = state.spareSlabSize;
+		state.spareSlab = NULL;
+		state.spareSlabSize = 0;
+		rebaseColumns(oldSlab);
+
+		return &state.particleData;
+	}
+
+	void Group::restoreRendererData()
+	{
+		if (renderState == NULL || !renderState->rendererDataPending)
+			return;
+
+		// The data of the renderer is copied back as its update may depend on its previous state (trails for instance)
+		renderState->rendererDataPending = false;
+		renderer.dataSet->copy(renderState->rendererData,particleData.nbParticles);
+		if (!renderer.dataSet->isInitialized())
+			renderer.obj->prepareData(*this,renderer.dataSet); // The data that could not be copied is created again
+	}
+
+	void Group::destroySplitArrays()
+	{
+		for (size_t i = 0; i < NB_VECTOR_ARRAYS; ++i)
+		{
+			SplitArray& splitArray = particleData.splitArrays[i];
+			for (size_t j = 0; j < 3; ++j)
+				splitArray.coords[j] = NULL; // The memory is released with the slab
+			splitArray.viewValid = true;
+			splitArray.dirtyStart = splitArray.dirtyEnd = 0;
+		}
+	}
+
+	void Group::gatherVectors(VectorArray array) const
+	{
+		const SplitArray& splitArray = particleData.splitArrays[array];
+		SIMD::gather(getVectorArray(array),splitArray.coords[0],splitArray.coords[1],splitArray.coords[2],0,particleData.nbParticles);
+		splitArray.viewValid = true;
+	}
+
+	void Group::scatterVectors(VectorArray array)
+	{
+		SplitArray& splitArray = particleData.splitArrays[array];
+		if (particleData.splitStorage && splitArray.dirtyStart != splitArray.dirtyEnd)
+		{
+			SIMD::scatter(getVectorArray(array),splitArray.coords[0],splitArray.coords[1],splitArray.coords[2],splitArray.dirtyStart,std::min(splitArray.dirtyEnd,particleData.nbParticles));
+			splitArray.dirtyStart = splitArray.dirtyEnd = 0;
+		}
+	}
+
+	void Group::invalidateVectors(VectorArray array)
+	{
+		if (particleData.splitStorage)
+		{
+			SplitArray& splitArray = particleData.splitArrays[array];
+			splitArray.viewValid = false;
+			splitArray.dirtyStart = splitArray.dirtyEnd = 0;
+		}
+	}
+
 	void Group::sortParticles(int start,int end)
 	{
 		// quick sort implementation (can be optimized)
@@ -671,6 +1733,11 @@ namespace SPK
 		for (std::vector<ModifierDef>::const_iterator it = modifiers.begin(); it != modifiers.end(); ++it)
 			if (!it->obj->isShared() && it->obj->isLocalToSystem())
 				it->obj->updateTransform(this);
+
+		for (std::vector<Instance>::const_iterator it = instances.begin(); it != instances.end(); ++it)
+			if (it->alive)
+				for (std::vector<Ref<Emitter> >::const_iterator emitterIt = it->emitters.begin(); emitterIt != it->emitters.end(); ++emitterIt)
+					(*emitterIt)->updateTransform(this);
 	}
 
 	void Group::addParticles(unsigned int nb,const Ref<Zone>& zone,const Ref<Emitter>& emitter,bool full)
@@ -769,19 +1836,69 @@ namespace SPK
 		nbBufferedParticles += nb;
 	}
 
+	bool Group::enqueueParticles(unsigned int nb,const Vector3D& position,const Vector3D& velocity,Zone* zone,Emitter* emitter,bool full)
+	{
+		if (nb == 0)
+			return true;
+
+		SpawnRequest request = {nb,position,velocity,zone,emitter,full};
+		return spawnQueue.push(request);
+	}
+
+	bool Group::enqueueParticles(unsigned int nb,Emitter* emitter)
+	{
+		SPK_ASSERT(emitter != NULL,"Group::enqueueParticles(unsigned int,Emitter*) - emitter must not be NULL");
+		int currentTank = emitter->getCurrentTank();
+		if (currentTank >= 0 && nb > static_cast<unsigned int>(currentTank))
+			nb = currentTank;
+
+		if (!enqueueParticles(nb,Vector3D(),Vector3D(),emitter->getZone().get(),emitter,emitter->isFullZone()))
+			return false;
+
+		emitter->updateTankFromNb(nb);
+		return true;
+	}
+
+	bool Group::enqueueParticles(Emitter* emitter,float deltaTime)
+	{
+		SPK_ASSERT(emitter != NULL,"Group::enqueueParticles(Emitter*,float) - emitter must not be NULL");
+		size_t nb = emitter->getNbBornFromTime(deltaTime); // The tank is left untouched if the request cannot be enqueued
+		if (!enqueueParticles(static_cast<unsigned int>(nb),Vector3D(),Vector3D(),emitter->getZone().get(),emitter,emitter->isFullZone()))
+			return false;
+
+		emitter->updateTankFromTime(deltaTime);
+		return true;
+	}
+
+	void Group::setSpawnQueueCapacity(unsigned int capacity)
+	{
+		// The requests already drained are discarded with the pending ones
+		for (size_t i = spawnRequestIndex; i < nbSpawnRequests; ++i)
+			nbBufferedParticles -= spawnRequests[i].nb;
+		nbSpawnRequests = spawnRequestIndex = 0;
+
+		spawnQueue.setCapacity(capacity);
+		spawnRequests.resize(spawnQueue.getCapacity());
+	}
+
 	void Group::flushBufferedParticles()
 	{
+		drainSpawnQueue();
+
 		if (nbBufferedParticles == 0)
 			return;
 
+		RandomStreamScope randomStreamScope(randomStream);
+
 		prepareAdditionnalData();
 
 		size_t nbManualBorn = nbBufferedParticles;
 
-		size_t dummy;
-		while (nbManualBorn > 0 && particleData.maxParticles - particleData.nbParticles > 0)
-			if (!initParticle(particleData.nbParticles++,dummy,nbManualBorn))
-				--particleData.nbParticles;
+		if (elasticCapacityEnabled && particleData.nbParticles + nbManualBorn > particleData.maxParticles)
+			growCapacity(particleData.nbParticles + nbManualBorn);
+
+		size_t dummy = 0;
+		initParticles(std::min(nbManualBorn,particleData.maxParticles - particleData.nbParticles),dummy,nbManualBorn);
 
 		emptyBufferedParticles();
 	}
@@ -790,28 +1907,224 @@ namespace SPK
 	{
 		creationBuffer.clear();
 		nbBufferedParticles = 0;
+		nbSpawnRequests = 0;
+		spawnRequestIndex = 0;
+		++nbSpawnCycles; // The zones and emitters of the requests drained so far are not used anymore
+	}
+
+	void Group::drainSpawnQueue()
+	{
+		// The drained requests are kept until the next update, when all of them have been born or discarded
+		size_t nbDrained = spawnQueue.pop(spawnRequests.empty() ? NULL : &spawnRequests[0] + nbSpawnRequests,spawnRequests.size() - nbSpawnRequests);
+		for (size_t i = nbSpawnRequests; i < nbSpawnRequests + nbDrained; ++i)
+			nbBufferedParticles += spawnRequests[i].nb;
+		nbSpawnRequests += nbDrained;
+	}
+
+	void Group::generateBufferedParticles(size_t start,size_t end,const Vector3D& position,const Vector3D& velocity,Zone* zone,Emitter* emitter,bool full)
+	{
+		if (zone != NULL)
+			zone->generatePositions(*this,start,end,full);
+		else
+			for (GroupIterator particleIt(*this,start,end); !particleIt.end(); ++particleIt)
+				particleIt->position() = position;
+
+		if (emitter != NULL)
+			emitter->generateVelocities(*this,start,end);
+		else
+			for (GroupIterator particleIt(*this,start,end); !particleIt.end(); ++particleIt)
+				particleIt->velocity() = velocity;
+	}
+
+	void Group::enableInstancing(bool instancing)
+	{
+		if (instancing == instancingEnabled)
+			return;
+
+		if (!instancing)
+		{
+			instances.clear();
+			freeInstances.clear();
+			nbInstances = 0;
+		}
+
+		instancingEnabled = instancing;
+
+		if (particleData.initialized)
+		{
+			reallocateSlab(particleData.maxParticles,particleData.nbParticles);
+			if (instancing)
+				std::fill(particleData.instanceIds,particleData.instanceIds + particleData.nbParticles,static_cast<unsigned int>(NO_INSTANCE));
+		}
+	}
+
+	size_t Group::createInstance(const float* transform)
+	{
+		if (!instancingEnabled)
+		{
+			SPK_LOG_WARNING("Group::createInstance(const float*) - Instancing is not enabled, no instance is created");
+			return NO_INSTANCE;
+		}
+
+		size_t id;
+		if (!freeInstances.empty())
+		{
+			id = freeInstances.back();
+			freeInstances.pop_back();
+		}
+		else
+		{
+			id = instances.size();
+			instances.push_back(Instance());
+		}
+
+		Instance& instance = instances[id];
+		instance.alive = true;
+		instance.age = 0.0f;
+		instance.nbParticles = 0;
+		instance.AABBMin = instance.AABBMax = Vector3D();
+		std::memcpy(instance.transform,transform,sizeof(float) * Transform::TRANSFORM_LENGTH);
+
+		// The copies of a recycled instance are reused if they were made from the current templates
+		bool recycled = instance.templates.size() == emitters.size();
+		for (size_t i = 0; i < emitters.size() && recycled; ++i)
+			recycled = instance.templates[i] == emitters[i].get();
+
+		if (recycled)
+			for (size_t i = 0; i < emitters.size(); ++i)
+			{
+				instance.emitters[i]->setActive(emitters[i]->isActive());
+				instance.emitters[i]->resetTank();
+			}
+		else
+		{
+			instance.emitters.clear();
+			instance.templates.clear();
+			for (std::vector<Ref<Emitter> >::const_iterator it = emitters.begin(); it != emitters.end(); ++it)
+			{
+				instance.emitters.push_back(SPKObject::copy(*it));
+				instance.templates.push_back(it->get());
+			}
+		}
+
+		placeInstanceEmitters(instance);
+		++nbInstances;
+		return id;
+	}
+
+	void Group::destroyInstance(size_t id)
+	{
+		if (!isInstanceAlive(id))
+		{
+			SPK_LOG_WARNING("Group::destroyInstance(size_t) - The instance does not exist : " << id);
+			return;
+		}
+
+		// The particles of the instance die at the next update (their age is set to their life time for the energy to be null)
+		for (size_t i = 0; i < particleData.nbParticles; ++i)
+			if (particleData.instanceIds[i] == id)
+			{
+				particleData.ages[i] = particleData.lifeTimes[i];
+				particleData.energies[i] = 0.0f;
+				particleData.instanceIds[i] = static_cast<unsigned int>(NO_INSTANCE);
+			}
+
+		instances[id].alive = false;
+		freeInstances.push_back(id);
+		--nbInstances;
+	}
+
+	void Group::setInstanceTransform(size_t id,const float* transform)
+	{
+		SPK_ASSERT(isInstanceAlive(id),"Group::setInstanceTransform(size_t,const float*) - The instance does not exist : " << id);
+		std::memcpy(instances[id].transform,transform,sizeof(float) * Transform::TRANSFORM_LENGTH);
+		placeInstanceEmitters(instances[id]);
+	}
+
+	void Group::placeInstanceEmitters(Instance& instance)
+	{
+		float local[Transform::TRANSFORM_LENGTH];
+		for (size_t i = 0; i < instance.emitters.size(); ++i)
+		{
+			Transform::multiply(local,instance.transform,instance.templates[i]->getTransform().getLocal());
+			instance.emitters[i]->getTransform().set(local);
+			instance.emitters[i]->updateTransform(this);
+		}
+	}
+
+	void Group::updateInstances(float deltaTime)
+	{
+		const float maxFloat = std::numeric_limits<float>::max();
+		for (std::vector<Instance>::iterator it = instances.begin(); it != instances.end(); ++it)
+			if (it->alive)
+			{
+				it->age += deltaTime;
+				it->nbParticles = 0;
+				it->AABBMin.set(maxFloat,maxFloat,maxFloat);
+				it->AABBMax.set(-maxFloat,-maxFloat,-maxFloat);
+			}
+
+		// Counts the particles of the instances and bounds them in a single pass
+		readVectors(VECTOR_ARRAY_POSITIONS);
+		for (size_t i = 0; i < particleData.nbParticles; ++i)
+		{
+			unsigned int id = particleData.instanceIds[i];
+			if (id != static_cast<unsigned int>(NO_INSTANCE))
+			{
+				Instance& instance = instances[id];
+				++instance.nbParticles;
+				instance.AABBMin.setMin(particleData.positions[i]);
+				instance.AABBMax.setMax(particleData.positions[i]);
+			}
+		}
+
+		// Destroys the instances without particles whose emitters are all exhausted
+		for (size_t i = 0; i < instances.size(); ++i)
+		{
+			Instance& instance = instances[i];
+			if (!instance.alive || instance.nbParticles > 0)
+				continue;
+
+			bool hasAliveEmitters = false;
+			for (std::vector<Ref<Emitter> >::const_iterator it = instance.emitters.begin(); it != instance.emitters.end(); ++it)
+				hasAliveEmitters |= (*it)->isActive() && (*it)->getCurrentTank() != 0;
+
+			if (!hasAliveEmitters)
+			{
+				instance.alive = false;
+				freeInstances.push_back(i);
+				--nbInstances;
+			}
+			else
+			{
+				// The bounding box of an instance without particles is reduced to its position
+				Transform::multiply(instance.AABBMin,Vector3D(instance.transform[12],instance.transform[13],instance.transform[14]),getTransform().getWorld());
+				instance.AABBMax = instance.AABBMin;
+			}
+		}
 	}
 
-	inline void Group::prepareAdditionnalData()
+	void Group::prepareAdditionnalData()
 	{
+		RandomStreamScope randomStreamScope(randomStream);
 		if (renderer.obj)
 			renderer.obj->prepareData(*this,renderer.dataSet);
 
 		activeModifiers.clear();
 		initModifiers.clear();
 
-		bool needsOctree = false;
+		bool needsNeighborStructure = false;
 		for (std::vector<WeakModifierDef>::const_iterator it = sortedModifiers.begin(); it != sortedModifiers.end(); ++it)
 		{
 			it->obj->prepareData(*this,it->dataSet);	// if it has a data set, it is prepared
 			if (it->obj->CALL_INIT)
 				initModifiers.push_back(*it); // if its init method needs to be called it is added to the init vector
-			if (it->obj->isActive())
+			if (it->obj->isActive() && !(prewarming && it->obj->isSkippedInPrewarm()))
 				activeModifiers.push_back(*it); // if the modifier is active, it is added to the active vector
-			needsOctree |= it->obj->NEEDS_OCTREE;
+			needsNeighborStructure |= it->obj->NEEDS_OCTREE;
 		}
 
-		manageOctreeInstance(needsOctree);
+		manageNeighborStructureInstance(needsNeighborStructure);
 
 		if (colorInterpolator.obj)
 			colorInterpolator.obj->prepareData(*this,colorInterpolator.dataSet);
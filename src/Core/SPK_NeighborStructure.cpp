@@ -0,0 +1,278 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <limits> // for max float value
+#include <algorithm> // for std::partial_sort
+#include <cmath> // for std::pow and std::isfinite
+
+#include <SPARK_Core.h>
+
+namespace SPK
+{
+	SPK_DEFINE_ENUM(NeighborStructureType, SPK_ENUM_NEIGHBOR_STRUCTURE_TYPE)
+
+	const float NeighborStructure::MIN_QUERY_RADIUS = 0.001f;
+
+	size_t NeighborStructure::getNbChunks() const
+	{
+		return (group.getNbParticles() + PARALLEL_GRAIN_SIZE - 1) / PARALLEL_GRAIN_SIZE;
+	}
+
+	size_t NeighborStructure::getChunkStart(size_t chunk) const
+	{
+		return std::min(static_cast<size_t>(group.getNbParticles()),chunk * PARALLEL_GRAIN_SIZE);
+	}
+
+	void NeighborStructure::computeBounds(float& maxRadius,float& radiusSum,TaskScheduler* taskScheduler)
+	{
+		const float MAX_FLOAT = std::numeric_limits<float>::max();
+		AABBMin.set(MAX_FLOAT,MAX_FLOAT,MAX_FLOAT);
+		AABBMax.set(-MAX_FLOAT,-MAX_FLOAT,-MAX_FLOAT);
+		maxRadius = 0.0f;
+		radiusSum = 0.0f;
+
+		size_t nbChunks = getNbChunks();
+		if (nbChunks == 0)
+			return;
+
+		// Gathers the positions on this thread so that the passes only read them
+		static_cast<const Group&>(group).getParticle(0).position();
+
+		chunkBounds.resize(nbChunks);
+		executePass(*this,&NeighborStructure::computeChunkBounds,nbChunks,taskScheduler);
+
+		// Merges the bounds of the chunks in order so that the sum of the radii does not depend on the threads
+		for (size_t i = 0; i < nbChunks; ++i)
+		{
+			const Bounds& bounds = chunkBounds[i];
+			AABBMin.setMin(bounds.AABBMin);
+			AABBMax.setMax(bounds.AABBMax);
+			if (maxRadius < bounds.maxRadius)
+				maxRadius = bounds.maxRadius;
+			radiusSum += bounds.radiusSum;
+		}
+	}
+
+	void NeighborStructure::computeChunkBounds(size_t startChunk,size_t endChunk)
+	{
+		const Group& group = this->group;
+		const float MAX_FLOAT = std::numeric_limits<float>::max();
+		for (size_t i = startChunk; i < endChunk; ++i)
+		{
+			Bounds& bounds = chunkBounds[i];
+			bounds.AABBMin.set(MAX_FLOAT,MAX_FLOAT,MAX_FLOAT);
+			bounds.AABBMax.set(-MAX_FLOAT,-MAX_FLOAT,-MAX_FLOAT);
+			bounds.maxRadius = 0.0f;
+			bounds.radiusSum = 0.0f;
+
+			size_t end = getChunkStart(i + 1);
+			for (size_t j = getChunkStart(i); j < end; ++j)
+			{
+				const Particle particle = group.getParticle(j);
+				float radius = particle.getRadius();
+				bounds.AABBMin.setMin(particle.position());
+				bounds.AABBMax.setMax(particle.position());
+				if (bounds.maxRadius < radius)
+					bounds.maxRadius = radius;
+				bounds.radiusSum += radius;
+			}
+		}
+	}
+
+	void NeighborStructure::queryPairs(float radius,NeighborVisitor& visitor) const
+	{
+		const Group& group = this->group;
+		size_t nbParticles = group.getNbParticles();
+		for (size_t i = 0; i < nbParticles; ++i)
+		{
+			// Only the particles of lower index are looked for so that each pair is found once
+			gatherNeighbors(group.getParticle(i).position(),radius,i,nbParticles);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				visitor.visit(i,queryNeighbors[j].index,queryNeighbors[j].sqrDist);
+		}
+	}
+
+	void NeighborStructure::queryNearest(size_t k,NeighborVisitor& visitor) const
+	{
+		const Group& group = this->group;
+		size_t nbParticles = group.getNbParticles();
+		for (size_t i = 0; i < nbParticles; ++i)
+		{
+			gatherNearest(group.getParticle(i).position(),k,i);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				visitor.visit(i,queryNeighbors[j].index,queryNeighbors[j].sqrDist);
+		}
+	}
+
+	void NeighborStructure::queryRadius(const Vector3D* points,size_t nbPoints,float radius,NeighborVisitor& visitor) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		for (size_t i = 0; i < nbPoints; ++i)
+		{
+			gatherNeighbors(points[i],radius,nbParticles,nbParticles);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				visitor.visit(i,queryNeighbors[j].index,queryNeighbors[j].sqrDist);
+		}
+	}
+
+	void NeighborStructure::queryRadius(const Vector3D* points,size_t nbPoints,float radius,std::vector<size_t>& neighbors,std::vector<size_t>& starts) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		neighbors.clear();
+		starts.resize(nbPoints + 1);
+		for (size_t i = 0; i < nbPoints; ++i)
+		{
+			starts[i] = neighbors.size();
+			gatherNeighbors(points[i],radius,nbParticles,nbParticles);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				neighbors.push_back(queryNeighbors[j].index);
+		}
+		starts[nbPoints] = neighbors.size();
+	}
+
+	size_t NeighborStructure::queryRadius(const Vector3D& point,float radius,std::vector<size_t>& neighbors) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		gatherNeighbors(point,radius,nbParticles,nbParticles);
+		neighbors.clear();
+		for (size_t i = 0; i < queryNeighbors.size(); ++i)
+			neighbors.push_back(queryNeighbors[i].index);
+		return neighbors.size();
+	}
+
+	void NeighborStructure::queryNearest(const Vector3D* points,size_t nbPoints,size_t k,NeighborVisitor& visitor) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		for (size_t i = 0; i < nbPoints; ++i)
+		{
+			gatherNearest(points[i],k,nbParticles);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				visitor.visit(i,queryNeighbors[j].index,queryNeighbors[j].sqrDist);
+		}
+	}
+
+	void NeighborStructure::queryNearest(const Vector3D* points,size_t nbPoints,size_t k,std::vector<size_t>& neighbors,std::vector<size_t>& starts) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		neighbors.clear();
+		starts.resize(nbPoints + 1);
+		for (size_t i = 0; i < nbPoints; ++i)
+		{
+			starts[i] = neighbors.size();
+			gatherNearest(points[i],k,nbParticles);
+			for (size_t j = 0; j < queryNeighbors.size(); ++j)
+				neighbors.push_back(queryNeighbors[j].index);
+		}
+		starts[nbPoints] = neighbors.size();
+	}
+
+	size_t NeighborStructure::queryNearest(const Vector3D& point,size_t k,std::vector<size_t>& neighbors) const
+	{
+		gatherNearest(point,k,group.getNbParticles());
+		neighbors.clear();
+		for (size_t i = 0; i < queryNeighbors.size(); ++i)
+			neighbors.push_back(queryNeighbors[i].index);
+		return neighbors.size();
+	}
+
+	void NeighborStructure::gatherNeighbors(const Vector3D& point,float radius,size_t endIndex,size_t excludedIndex) const
+	{
+		const Group& group = this->group;
+		queryNeighbors.clear();
+
+		if (queryMarks.size() < group.getNbParticles())
+			queryMarks.resize(group.getNbParticles(),0);
+		++queryStamp;
+
+		// Copied as the point may be the position of a particle
+		const Vector3D center = point;
+		const float sqrRadius = radius * radius;
+
+		// No particle can be found around a point that is not finite
+		if (!std::isfinite(center.x) || !std::isfinite(center.y) || !std::isfinite(center.z) || !(radius >= 0.0f))
+			return;
+
+		getCellsInBox(center - radius,center + radius,queryCells);
+		for (size_t i = 0; i < queryCells.size(); ++i)
+		{
+			const size_t* cellParticles = getParticlesInCell(queryCells[i]);
+			size_t nbParticlesInCell = getNbParticlesInCell(queryCells[i]);
+			for (size_t j = 0; j < nbParticlesInCell; ++j)
+			{
+				size_t index = cellParticles[j];
+				if (index >= endIndex)
+					break; // as particles are ordered
+
+				if (index == excludedIndex || queryMarks[index] == queryStamp)
+					continue;
+				queryMarks[index] = queryStamp;
+
+				float sqrDist = getSqrDist(center,group.getParticle(index).position());
+				if (sqrDist <= sqrRadius)
+				{
+					Neighbor neighbor = {index,sqrDist};
+					queryNeighbors.push_back(neighbor);
+				}
+			}
+		}
+	}
+
+	void NeighborStructure::gatherNearest(const Vector3D& point,size_t k,size_t excludedIndex) const
+	{
+		size_t nbParticles = group.getNbParticles();
+		size_t nbCandidates = excludedIndex < nbParticles ? nbParticles - 1 : nbParticles;
+		if (k > nbCandidates)
+			k = nbCandidates;
+
+		queryNeighbors.clear();
+		if (k == 0)
+			return;
+
+		// The initial radius is the distance to the structure plus the radius holding k particles if they were evenly spread
+		const Vector3D center = point;
+		Vector3D outside = AABBMin - center;
+		outside.setMax(center - AABBMax);
+		outside.setMax(Vector3D());
+		float radius = outside.getNorm() + 0.5f * (AABBMax - AABBMin).getMax() * std::pow(static_cast<float>(k) / nbCandidates,1.0f / 3.0f);
+		if (radius < MIN_QUERY_RADIUS)
+			radius = MIN_QUERY_RADIUS;
+
+		// Radius covering the whole structure from the point. Beyond it no more particles can be found
+		// (the particles born since the last update are not indexed and the point may not be finite)
+		Vector3D farthest = center - AABBMin;
+		farthest.setMax(AABBMax - center);
+		const float maxRadius = farthest.getNorm();
+
+		// All the particles within the radius are found so the k nearest are among them once at least k are found
+		while (true)
+		{
+			gatherNeighbors(center,radius,nbParticles,excludedIndex);
+			if (queryNeighbors.size() >= k || !(radius < maxRadius))
+				break;
+			radius *= 2.0f;
+		}
+
+		if (k > queryNeighbors.size())
+			k = queryNeighbors.size();
+		std::partial_sort(queryNeighbors.begin(),queryNeighbors.begin() + k,queryNeighbors.end());
+		queryNeighbors.resize(k);
+	}
+}
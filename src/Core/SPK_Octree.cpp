@@ -20,26 +20,37 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include <vector>
-#include <limits> // for max float value
+#include <algorithm> // for std::swap and std::lower_bound
 
 #include <SPARK_Core.h>
 
 namespace SPK
 {
-	// TODO Allows to tweak this
-	const size_t Octree::MAX_LEVEL_INDEX = 4; // A too high number will be highly memory comsuming
-	const size_t Octree::MAX_PARTICLES_NB_PER_CELL = 32;
-	const float Octree::OPTIMAL_CELL_SIZE_FACTOR = 4.0f; // optimal cell size is defined as : factor * mean radius
+	const size_t Octree::DEFAULT_MAX_LEVEL_INDEX = 4;
+	const size_t Octree::MAX_LEVEL_INDEX_LIMIT = 8;
+	const size_t Octree::DEFAULT_MAX_PARTICLES_NB_PER_CELL = 32;
+	const float Octree::DEFAULT_CELL_SIZE_FACTOR = 4.0f; // optimal cell size is defined as : factor * mean radius
+	const float Octree::DEFAULT_REBUILD_THRESHOLD = 0.1f;
 	const float Octree::MIN_CELL_SIZE = 0.001f;
 
 	Octree::Octree(const Ref<Group>& group) :
-		group(*group),
+		NeighborStructure(*group,NEIGHBOR_STRUCTURE_OCTREE),
 		cells(64),
 		nbCells(0),
 		nbParticles(0),
 		particleCells(NULL),
 		minPos(NULL),
-		maxPos(NULL)
+		maxPos(NULL),
+		maxLevel(0),
+		maxLevelIndex(DEFAULT_MAX_LEVEL_INDEX),
+		maxParticlesPerCell(DEFAULT_MAX_PARTICLES_NB_PER_CELL),
+		cellSizeFactor(DEFAULT_CELL_SIZE_FACTOR),
+		previousMinPos(NULL),
+		previousMaxPos(NULL),
+		nbBinnedParticles(0),
+		rebinnedParticles(64),
+		rebinned(NULL),
+		tracksRebinnedParticles(false)
 	{}
 
 	Octree::~Octree()
@@ -47,9 +58,12 @@ namespace SPK
 		SPK_DELETE_ARRAY(particleCells);
 		SPK_DELETE_ARRAY(minPos);
 		SPK_DELETE_ARRAY(maxPos);
+		SPK_DELETE_ARRAY(previousMinPos);
+		SPK_DELETE_ARRAY(previousMaxPos);
+		SPK_DELETE_ARRAY(rebinned);
 	}
 
-	void Octree::update()
+	void Octree::update(TaskScheduler* taskScheduler)
 	{
 		// Reallocates if necessary
 		if (group.getCapacity() != nbParticles)
@@ -58,31 +72,66 @@ namespace SPK
 			SPK_DELETE_ARRAY(particleCells);
 			SPK_DELETE_ARRAY(minPos);
 			SPK_DELETE_ARRAY(maxPos);
+			SPK_DELETE_ARRAY(previousMinPos);
+			SPK_DELETE_ARRAY(previousMaxPos);
+			SPK_DELETE_ARRAY(rebinned);
 
 			particleCells = SPK_NEW_ARRAY(Array<size_t>,nbParticles);
 			minPos = SPK_NEW_ARRAY(Triplet,nbParticles);
 			maxPos = SPK_NEW_ARRAY(Triplet,nbParticles);
-		}
+			previousMinPos = SPK_NEW_ARRAY(Triplet,nbParticles);
+			previousMaxPos = SPK_NEW_ARRAY(Triplet,nbParticles);
+			rebinned = SPK_NEW_ARRAY(bool,nbParticles);
+			for (size_t i = 0; i < nbParticles; ++i)
+				rebinned[i] = false;
 
-		const float MAX_FLOAT = std::numeric_limits<float>::max();
-		AABBMin.set(MAX_FLOAT,MAX_FLOAT,MAX_FLOAT);
-		AABBMax.set(-MAX_FLOAT,-MAX_FLOAT,-MAX_FLOAT);
+			nbBinnedParticles = 0;
+		}
 
 		// First traversal in O(n) needed to init the octree
+		float maxRadius = 0.0f;
 		float meanRadius = 0.0f;
-		for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
-		{
-			const Particle& particle = *particleIt;
-			float radius = particle.getRadius();
-			AABBMin.setMin(particle.position());
-			AABBMax.setMax(particle.position());
-			meanRadius += radius;
-			particleCells[particle.getIndex()].clear();
-		}
+		computeBounds(maxRadius,meanRadius,taskScheduler);
+
+		if (needsRebuild())
+			rebuild(meanRadius / group.getNbParticles(),taskScheduler);
+		else
+			updateIncrementally(taskScheduler);
+	}
+
+	bool Octree::needsRebuild() const
+	{
+		if (!group.isIncrementalOctreeEnabled() || nbBinnedParticles == 0 || group.getNbParticles() == 0)
+			return true;
+
+		if (maxLevelIndex != group.getOctreeMaxLevel() ||
+			maxParticlesPerCell != group.getOctreeMaxParticlesPerCell() ||
+			cellSizeFactor != group.getOctreeCellSizeFactor())
+			return true;
+
+		// The octree is rebuilt when the bounds of the particles moved by more than a fraction of the size of the group
+		float size = (rebuildAABBMax - rebuildAABBMin).getMax();
+		if (size < MIN_CELL_SIZE)
+			size = MIN_CELL_SIZE;
+		float tolerance = group.getOctreeRebuildThreshold() * size;
+
+		for (size_t i = 0; i < 3; ++i)
+			if (std::abs(AABBMin[i] - rebuildAABBMin[i]) > tolerance || std::abs(AABBMax[i] - rebuildAABBMax[i]) > tolerance)
+				return true;
+
+		return false;
+	}
+
+	void Octree::rebuild(float meanRadius,TaskScheduler* taskScheduler)
+	{
+		maxLevelIndex = group.getOctreeMaxLevel();
+		maxParticlesPerCell = group.getOctreeMaxParticlesPerCell();
+		cellSizeFactor = group.getOctreeCellSizeFactor();
+		rebuildAABBMin = AABBMin;
+		rebuildAABBMax = AABBMax;
 
 		// Tries to minimize the number of particles that belongs to several cell by setting minimum cell size function of the mean radius
-		meanRadius /= group.getNbParticles();
-		float minCellSize = meanRadius * OPTIMAL_CELL_SIZE_FACTOR;
+		float minCellSize = meanRadius * cellSizeFactor;
 		if (minCellSize < MIN_CELL_SIZE)
 			minCellSize = MIN_CELL_SIZE;
 
@@ -91,12 +140,12 @@ namespace SPK
 		Vector3D offset = AABBMin;
 
 		// Maximizes the possibilities of seperation
-		Vector3D cellSizes = dimensions / Vector3D(static_cast<float>(1 << MAX_LEVEL_INDEX));
+		Vector3D cellSizes = dimensions / Vector3D(static_cast<float>(1 << maxLevelIndex));
 		cellSizes.setMin(Vector3D(minCellSize));
 		Vector3D ratios = Vector3D(minCellSize) / cellSizes;
 
 		// Optimizes if possible by scaling down the octree in order to use less levels
-		size_t maxLevel = MAX_LEVEL_INDEX;
+		maxLevel = maxLevelIndex;
 		while (ratios.getMin() >= 2.0f && maxLevel > 0)
 		{
 			ratios /= 2.0f;
@@ -106,42 +155,193 @@ namespace SPK
 		// Updates the dimensions
 		offset -= dimensions * ((ratios + 1.0f) * 0.5f - 1.0f);
 		dimensions *= ratios;
-		AABBMin = offset;
-		AABBMax = offset + dimensions;
+		AABBMin = cellsAABBMin = offset;
+		AABBMax = cellsAABBMax = offset + dimensions;
 
 		// Inits root
 		nbCells = 0;
 		initNextCell(0,0,0,0);
 
+		// Computes the range of cells of each particle
+		ratio = Vector3D(static_cast<float>(1 << maxLevel)) / dimensions;
+		size_t nbChunks = getNbChunks();
+		executePass(*this,&Octree::computeParticleRanges,nbChunks,taskScheduler);
+
 		// Adds particles to correct cells
-		Vector3D ratio = Vector3D(static_cast<float>(1 << maxLevel)) / dimensions;
-		for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		size_t nbActiveParticles = group.getNbParticles();
+		for (size_t i = 0; i < nbActiveParticles; ++i)
+			addToCell(0,i);
+		nbBinnedParticles = nbActiveParticles;
+
+		// Fills results (particle/cell relationship)
+		activeCells.clear();
+		if (taskScheduler != NULL && nbChunks > 1)
 		{
-			const Particle& particle = *particleIt;
-			const Vector3D position = particle.position() - offset;
-			const float radius = particle.getRadius();
+			for (size_t i = 0; i < nbCells; ++i)
+				if (!cells[i].particles.empty())
+					activeCells.push(i);
+
+			executePass(*this,&Octree::computeParticleCells,nbChunks,taskScheduler);
+		}
+		else
+		{
+			for (size_t i = 0; i < nbActiveParticles; ++i)
+				particleCells[i].clear();
 
-			size_t particleIndex = particle.getIndex();
+			// Cells are traversed by index so they are ordered by index for each particle, as when computed in parallel
+			for (size_t i = 0; i < nbCells; ++i)
+				if (!cells[i].particles.empty())
+				{
+					activeCells.push(i);
+					size_t nbParticlesInCells = cells[i].particles.size();
+					for (size_t j = 0; j < nbParticlesInCells; ++j)
+						particleCells[cells[i].particles[j]].push(i);
+				}
+		}
+	}
 
-			Vector3D minPosf = (position - radius) * ratio;
-			Vector3D maxPosf = (position + radius) * ratio;
+	void Octree::updateIncrementally(TaskScheduler* taskScheduler)
+	{
+		// The cells keep the bounds of the last rebuild
+		AABBMin = cellsAABBMin;
+		AABBMax = cellsAABBMax;
+
+		// Computes the range of cells of each particle, keeping the previous ones to find the particles that crossed a cell boundary
+		std::swap(minPos,previousMinPos);
+		std::swap(maxPos,previousMaxPos);
+		executePass(*this,&Octree::computeParticleRanges,getNbChunks(),taskScheduler);
+
+		// Removes the dead particles and the ones that moved from their cells.
+		// Indices are reused when particles die but the cells of a particle only depend on its range so unchanged ranges are kept whatever the particle
+		size_t nbActiveParticles = group.getNbParticles();
+		rebinnedParticles.clear();
+		for (size_t i = 0; i < nbBinnedParticles; ++i)
+			if (i >= nbActiveParticles || minPos[i] != previousMinPos[i] || maxPos[i] != previousMaxPos[i])
+			{
+				removeFromCells(i);
+				if (i < nbActiveParticles)
+					markRebinned(i);
+			}
+
+		for (size_t i = nbBinnedParticles; i < nbActiveParticles; ++i)
+			markRebinned(i);
 
-			minPos[particleIndex].set(minPosf);
-			maxPos[particleIndex].set(maxPosf);
+		// Adds them back. Particles redistributed to the children of a cell split meanwhile are rebinned as well
+		size_t nbMovedParticles = rebinnedParticles.size();
+		tracksRebinnedParticles = true;
+		for (size_t i = 0; i < nbMovedParticles; ++i)
+			addToCell(0,rebinnedParticles[i]);
+		tracksRebinnedParticles = false;
+		nbBinnedParticles = nbActiveParticles;
 
-			addToCell(0,particleIndex,maxLevel);
+		// Fills results for the rebinned particles only
+		for (size_t i = 0; i < rebinnedParticles.size(); ++i)
+		{
+			size_t particleIndex = rebinnedParticles[i];
+			computeCellsOf(particleIndex);
+			rebinned[particleIndex] = false;
 		}
 
-		// Fills results (particle/cell relationship)
 		activeCells.clear();
 		for (size_t i = 0; i < nbCells; ++i)
 			if (!cells[i].particles.empty())
-			{
 				activeCells.push(i);
-				size_t nbParticlesInCells = cells[i].particles.size();
-				for (size_t j = 0; j < nbParticlesInCells; ++j)
-					particleCells[cells[i].particles[j]].push(i);
-			}
+	}
+
+	void Octree::computeParticleRanges(size_t startChunk,size_t endChunk)
+	{
+		const Group& group = this->group;
+		size_t start = getChunkStart(startChunk);
+		size_t end = getChunkStart(endChunk);
+		for (size_t i = start; i < end; ++i)
+		{
+			const Particle particle = group.getParticle(i);
+			const Vector3D position = particle.position() - AABBMin;
+			const float radius = particle.getRadius();
+
+			Vector3D minPosf = (position - radius) * ratio;
+			Vector3D maxPosf = (position + radius) * ratio;
+
+			minPos[i].set(minPosf);
+			maxPos[i].set(maxPosf);
+		}
+	}
+
+	void Octree::computeParticleCells(size_t startChunk,size_t endChunk)
+	{
+		size_t start = getChunkStart(startChunk);
+		size_t end = getChunkStart(endChunk);
+		for (size_t i = start; i < end; ++i)
+			computeCellsOf(i);
+	}
+
+	void Octree::computeCellsOf(size_t particleIndex)
+	{
+		// The cells of a particle are found back by going down the octree the way the particle was added
+		Array<size_t>& neighborCells = particleCells[particleIndex];
+		neighborCells.clear();
+		addCellsOf(0,minPos[particleIndex],maxPos[particleIndex],neighborCells);
+
+		// Cells are ordered by index (insertion sort as a particle lies in few cells)
+		for (size_t j = 1; j < neighborCells.size(); ++j)
+		{
+			size_t cellIndex = neighborCells[j];
+			size_t k = j;
+			for (; k > 0 && neighborCells[k - 1] > cellIndex; --k)
+				neighborCells[k] = neighborCells[k - 1];
+			neighborCells[k] = cellIndex;
+		}
+	}
+
+	void Octree::getCellsInBox(const Vector3D& boxMin,const Vector3D& boxMax,Array<size_t>& boxCells) const
+	{
+		boxCells.clear();
+		if (activeCells.empty())
+			return;
+
+		// The box is converted to a range of cells the way particles are, clamped so that the conversion cannot overflow
+		const Vector3D minPosition(-1.0f);
+		const Vector3D maxPosition(static_cast<float>(1 << maxLevel));
+
+		Vector3D minPosf = (boxMin - AABBMin) * ratio;
+		Vector3D maxPosf = (boxMax - AABBMin) * ratio;
+		minPosf.setMax(minPosition);
+		minPosf.setMin(maxPosition);
+		maxPosf.setMax(minPosition);
+		maxPosf.setMin(maxPosition);
+
+		Triplet min;
+		Triplet max;
+		min.set(minPosf);
+		max.set(maxPosf);
+
+		addCellsOf(0,min,max,boxCells);
+
+		// Only non empty leaves are kept
+		size_t nbBoxCells = 0;
+		for (size_t i = 0; i < boxCells.size(); ++i)
+			if (!cells[boxCells[i]].particles.empty())
+				boxCells[nbBoxCells++] = boxCells[i];
+		boxCells.resize(nbBoxCells);
+	}
+
+	void Octree::addCellsOf(size_t cellIndex,const Triplet& min,const Triplet& max,Array<size_t>& neighborCells) const
+	{
+		const Cell& cell = cells[cellIndex];
+		if (!cell.hasChildren)
+		{
+			neighborCells.push(cellIndex);
+			return;
+		}
+
+		int minIndex[3];
+		int maxIndex[3];
+		getChildrenRange(cell,min,max,minIndex,maxIndex);
+
+		for (int x = minIndex[0]; x <= maxIndex[0]; ++x)
+			for (int y = minIndex[1]; y <= maxIndex[1]; ++y)
+				for (int z = minIndex[2]; z <= maxIndex[2]; ++z)
+					addCellsOf(cell.children[(x << 2) | (y << 1) | z],min,max,neighborCells);
 	}
 
 	size_t Octree::initNextCell(size_t level,size_t offsetX,size_t offsetY,size_t offsetZ)
@@ -153,11 +353,17 @@ namespace SPK
 		return nbCells++;
 	}
 
-	void Octree::addToCell(size_t cellIndex,size_t particleIndex,size_t maxLevel)
+	void Octree::addToCell(size_t cellIndex,size_t particleIndex)
 	{
 		Cell& cell = cells[cellIndex];
-		if (!cell.hasChildren && (cell.particles.size() < MAX_PARTICLES_NB_PER_CELL || cell.level == maxLevel))
-			cell.particles.push(particleIndex);
+		if (!cell.hasChildren && (cell.particles.size() < maxParticlesPerCell || cell.level == maxLevel))
+		{
+			// Particles are kept ordered by index (they are added in order when the octree is rebuilt)
+			size_t index = cell.particles.size();
+			while (index > 0 && cell.particles[index - 1] > particleIndex)
+				--index;
+			cell.particles.insert(index,particleIndex);
+		}
 		else
 		{
 			// Creates children if necessary
@@ -179,38 +385,66 @@ namespace SPK
 				// Redistributes particles in this cell to its newly created children
 				size_t nbParticlesInCell = cells[cellIndex].particles.size();
 				for (size_t i = 0; i < nbParticlesInCell; ++i)
-					addToChildrenCells(cellIndex,cells[cellIndex].particles[i],maxLevel);
+				{
+					size_t redistributedIndex = cells[cellIndex].particles[i];
+					addToChildrenCells(cellIndex,redistributedIndex);
+					if (tracksRebinnedParticles)
+						markRebinned(redistributedIndex);
+				}
 				cells[cellIndex].particles.clear();
 			}
 
-			addToChildrenCells(cellIndex,particleIndex,maxLevel);
+			addToChildrenCells(cellIndex,particleIndex);
 		}
 	}
 
-	void Octree::addToChildrenCells(size_t parentIndex,size_t particleIndex,size_t maxLevel) // TODO This code may be optimized ?
+	void Octree::addToChildrenCells(size_t parentIndex,size_t particleIndex)
 	{
-		const Cell& parent = cells[parentIndex];
-		size_t childLevel = parent.level + 1;
-		size_t divisor = maxLevel - childLevel;
+		int minIndex[3];
+		int maxIndex[3];
+		getChildrenRange(cells[parentIndex],minPos[particleIndex],maxPos[particleIndex],minIndex,maxIndex);
+
+		for (int x = minIndex[0]; x <= maxIndex[0]; ++x)
+			for (int y = minIndex[1]; y <= maxIndex[1]; ++y)
+				for (int z = minIndex[2]; z <= maxIndex[2]; ++z)
+					addToCell(cells[parentIndex].children[(x << 2) | (y << 1) | z],particleIndex);
+	}
 
-		Triplet& min = minPos[particleIndex];
-		Triplet& max = maxPos[particleIndex];
+	void Octree::removeFromCells(size_t particleIndex)
+	{
+		const Array<size_t>& neighborCells = particleCells[particleIndex];
+		for (size_t i = 0; i < neighborCells.size(); ++i)
+		{
+			Array<size_t>& particles = cells[neighborCells[i]].particles;
+			const size_t* particleIt = std::lower_bound(particles.values,particles.values + particles.size(),particleIndex);
+			particles.erase(particleIt - particles.values);
+		}
+	}
 
-		int offsetX = cells[parentIndex].offsetX << 1;
-		int offsetY = cells[parentIndex].offsetY << 1;
-		int offsetZ = cells[parentIndex].offsetZ << 1;
+	void Octree::markRebinned(size_t particleIndex)
+	{
+		if (!rebinned[particleIndex])
+		{
+			rebinned[particleIndex] = true;
+			rebinnedParticles.push(particleIndex);
+		}
+	}
 
-		int minIndexX = (min.value[0] >> divisor) <= offsetX ? 0 : 1;
-		int minIndexY = (min.value[1] >> divisor) <= offsetY ? 0 : 1;
-		int minIndexZ = (min.value[2] >> divisor) <= offsetZ ? 0 : 1;
+	inline void Octree::getChildrenRange(const Cell& parent,const Triplet& min,const Triplet& max,int* minIndex,int* maxIndex) const
+	{
+		size_t childLevel = parent.level + 1;
+		size_t divisor = maxLevel - childLevel;
 
-		int maxIndexX = (max.value[0] >> divisor) <= offsetX ? 0 : 1;
-		int maxIndexY = (max.value[1] >> divisor) <= offsetY ? 0 : 1;
-		int maxIndexZ = (max.value[2] >> divisor) <= offsetZ ? 0 : 1;
+		int offsets[3] = {
+			static_cast<int>(parent.offsetX << 1),
+			static_cast<int>(parent.offsetY << 1),
+			static_cast<int>(parent.offsetZ << 1)
+		};
 
-		for (int x = minIndexX; x <= maxIndexX; ++x)
-			for (int y = minIndexY; y <= maxIndexY; ++y)
-				for (int z = minIndexZ; z <= maxIndexZ; ++z)
-					addToCell(parent.children[(x << 2) | (y << 1) | z],particleIndex,maxLevel);
+		for (size_t i = 0; i < 3; ++i)
+		{
+			minIndex[i] = (min.value[i] >> divisor) <= offsets[i] ? 0 : 1;
+			maxIndex[i] = (max.value[i] >> divisor) <= offsets[i] ? 0 : 1;
+		}
 	}
 }
@@ -35,4 +35,10 @@ namespace SPK
 	{
 		SPK_LOG_INFO("VBO hint is not yet considered");
 	}
+
+	void Renderer::initRange(const Group& group,DataSet* dataSet,size_t start,size_t end) const
+	{
+		for (ConstGroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			init(*particleIt,dataSet);
+	}
 }
@@ -0,0 +1,262 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <SPARK_Core.h>
+
+#if !defined(SPK_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define SPK_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(SPK_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SPK_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace SPK
+{
+namespace SIMD
+{
+#ifdef SPK_SSE2
+namespace
+{
+	// Low 32 bits of the products of the 4 integers (_mm_mullo_epi32 requires SSE4.1)
+	inline __m128i mul(__m128i a,__m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a,b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_si128(a,4),_mm_srli_si128(b,4));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even,_MM_SHUFFLE(0,0,2,0)),_mm_shuffle_epi32(odd,_MM_SHUFFLE(0,0,2,0)));
+	}
+
+	// Same as RandomStream::hash(uint32) on 4 integers
+	inline __m128i hash(__m128i x)
+	{
+		x = _mm_xor_si128(x,_mm_srli_epi32(x,16));
+		x = mul(x,_mm_set1_epi32(0x7FEB352D));
+		x = _mm_xor_si128(x,_mm_srli_epi32(x,15));
+		x = mul(x,_mm_set1_epi32(static_cast<int>(0x846CA68BU)));
+		x = _mm_xor_si128(x,_mm_srli_epi32(x,16));
+		return x;
+	}
+}
+#endif
+
+	float* allocate(size_t nb)
+	{
+		// The address of the allocated block is stored just before the aligned array
+		size_t size = getPaddedSize(nb) * sizeof(float) + ALIGNMENT + sizeof(char*);
+		char* block = SPK_NEW_ARRAY(char,size);
+		size_t address = reinterpret_cast<size_t>(block + sizeof(char*));
+		char* array = block + sizeof(char*) + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+		reinterpret_cast<char**>(array)[-1] = block;
+		return reinterpret_cast<float*>(array);
+	}
+
+	void deallocate(float* array)
+	{
+		if (array != NULL)
+		{
+			char* block = reinterpret_cast<char**>(array)[-1];
+			SPK_DELETE_ARRAY(block);
+		}
+	}
+
+	void updateAges(float* ages,size_t start,size_t end,float deltaTime)
+	{
+		size_t i = start;
+#ifdef SPK_SSE
+		const __m128 dt = _mm_set1_ps(deltaTime);
+		for (; i + 4 <= end; i += 4)
+			_mm_storeu_ps(ages + i,_mm_add_ps(_mm_loadu_ps(ages + i),dt));
+#endif
+		for (; i < end; ++i)
+			ages[i] += deltaTime;
+	}
+
+	void computeEnergies(float* energies,const float* ages,const float* lifeTimes,size_t start,size_t end)
+	{
+		size_t i = start;
+#ifdef SPK_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (; i + 4 <= end; i += 4)
+			_mm_storeu_ps(energies + i,_mm_sub_ps(one,_mm_div_ps(_mm_loadu_ps(ages + i),_mm_loadu_ps(lifeTimes + i))));
+#endif
+		for (; i < end; ++i)
+			energies[i] = 1.0f - ages[i] / lifeTimes[i];
+	}
+
+	void integrate(float* positions,float* oldPositions,const float* velocities,size_t start,size_t end,float deltaTime)
+	{
+		size_t i = start;
+#ifdef SPK_SSE
+		const __m128 dt = _mm_set1_ps(deltaTime);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 position = _mm_loadu_ps(positions + i);
+			_mm_storeu_ps(oldPositions + i,position);
+			_mm_storeu_ps(positions + i,_mm_add_ps(position,_mm_mul_ps(_mm_loadu_ps(velocities + i),dt)));
+		}
+#endif
+		for (; i < end; ++i)
+		{
+			oldPositions[i] = positions[i];
+			positions[i] += velocities[i] * deltaTime;
+		}
+	}
+
+	void computeSqrDists(float* sqrDists,const float* x,const float* y,const float* z,size_t start,size_t end,const Vector3D& point)
+	{
+		size_t i = start;
+#ifdef SPK_SSE
+		const __m128 px = _mm_set1_ps(point.x);
+		const __m128 py = _mm_set1_ps(point.y);
+		const __m128 pz = _mm_set1_ps(point.z);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i),px);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i),py);
+			__m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i),pz);
+			_mm_storeu_ps(sqrDists + i,_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,dx),_mm_mul_ps(dy,dy)),_mm_mul_ps(dz,dz)));
+		}
+#endif
+		for (; i < end; ++i)
+		{
+			float dx = x[i] - point.x;
+			float dy = y[i] - point.y;
+			float dz = z[i] - point.z;
+			sqrDists[i] = dx * dx + dy * dy + dz * dz;
+		}
+	}
+
+	size_t findIntersections(size_t* indices,const float* x,const float* y,const float* z,const float* radii,size_t start,size_t end,const Vector3D& point,float radius,float sqrScale)
+	{
+		size_t nb = 0;
+		size_t i = start;
+#ifdef SPK_SSE
+		const __m128 px = _mm_set1_ps(point.x);
+		const __m128 py = _mm_set1_ps(point.y);
+		const __m128 pz = _mm_set1_ps(point.z);
+		const __m128 r = _mm_set1_ps(radius);
+		const __m128 scale = _mm_set1_ps(sqrScale);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 dx = _mm_sub_ps(px,_mm_loadu_ps(x + i));
+			__m128 dy = _mm_sub_ps(py,_mm_loadu_ps(y + i));
+			__m128 dz = _mm_sub_ps(pz,_mm_loadu_ps(z + i));
+			__m128 sqrDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,dx),_mm_mul_ps(dy,dy)),_mm_mul_ps(dz,dz));
+			__m128 sum = _mm_add_ps(r,_mm_loadu_ps(radii + i));
+			int mask = _mm_movemask_ps(_mm_cmplt_ps(sqrDist,_mm_mul_ps(sum,_mm_mul_ps(sum,scale))));
+			if (mask != 0)
+				for (size_t j = 0; j < 4; ++j)
+					if ((mask >> j) & 1)
+						indices[nb++] = i + j;
+		}
+#endif
+		for (; i < end; ++i)
+		{
+			float dx = point.x - x[i];
+			float dy = point.y - y[i];
+			float dz = point.z - z[i];
+			float sum = radius + radii[i];
+			if (dx * dx + dy * dy + dz * dz < sum * (sum * sqrScale))
+				indices[nb++] = i;
+		}
+
+		return nb;
+	}
+
+	void computeMinMax(const float* values,size_t start,size_t end,float& min,float& max)
+	{
+		size_t i = start;
+#ifdef SPK_SSE
+		if (i + 4 <= end)
+		{
+			__m128 minValues = _mm_set1_ps(min);
+			__m128 maxValues = _mm_set1_ps(max);
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 v = _mm_loadu_ps(values + i);
+				minValues = _mm_min_ps(minValues,v);
+				maxValues = _mm_max_ps(maxValues,v);
+			}
+
+			float minArray[4];
+			float maxArray[4];
+			_mm_storeu_ps(minArray,minValues);
+			_mm_storeu_ps(maxArray,maxValues);
+			for (size_t j = 0; j < 4; ++j)
+			{
+				if (min > minArray[j]) min = minArray[j];
+				if (max < maxArray[j]) max = maxArray[j];
+			}
+		}
+#endif
+		for (; i < end; ++i)
+		{
+			if (min > values[i]) min = values[i];
+			if (max < values[i]) max = values[i];
+		}
+	}
+
+	void fillRandom(float* values,size_t start,size_t end,uint32 key,uint32 counter,float min,float max)
+	{
+		size_t i = start;
+		const float range = max - min;
+#ifdef SPK_SSE2
+		const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+		const __m128i four = _mm_set1_epi32(4);
+		const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+		const __m128 minValues = _mm_set1_ps(min);
+		const __m128 rangeValues = _mm_set1_ps(range);
+		__m128i counters = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(counter)),_mm_set_epi32(3,2,1,0));
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128i x = hash(_mm_add_epi32(hash(_mm_xor_si128(counters,k)),k));
+			__m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x,8)),scale);
+			_mm_storeu_ps(values + i,_mm_add_ps(minValues,_mm_mul_ps(unit,rangeValues)));
+			counters = _mm_add_epi32(counters,four);
+		}
+		counter += static_cast<uint32>(i - start);
+#endif
+		for (; i < end; ++i)
+			values[i] = min + RandomStream::toUnit(RandomStream::generateUint(key,counter++)) * range;
+	}
+
+	void gather(Vector3D* vectors,const float* x,const float* y,const float* z,size_t start,size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+		{
+			vectors[i].x = x[i];
+			vectors[i].y = y[i];
+			vectors[i].z = z[i];
+		}
+	}
+
+	void scatter(const Vector3D* vectors,float* x,float* y,float* z,size_t start,size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+		{
+			x[i] = vectors[i].x;
+			y[i] = vectors[i].y;
+			z[i] = vectors[i].z;
+		}
+	}
+}}
@@ -0,0 +1,419 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <limits> // for max float value
+#include <cmath> // for std::isfinite
+
+#include <SPARK_Core.h>
+
+namespace SPK
+{
+	const size_t SpatialGrid::MAX_CELLS_PER_PARTICLE = 4; // Bounds the memory of the grid and the cost of the counting sort when particles are sparse
+	const float SpatialGrid::MIN_CELL_SIZE = 0.001f;
+	const size_t SpatialGrid::RADIX_NB_BITS = 8;
+
+	SpatialGrid::SpatialGrid(const Ref<Group>& group) :
+		NeighborStructure(*group,NEIGHBOR_STRUCTURE_GRID),
+		nbParticles(0),
+		particleCoordinates(NULL),
+		sortedParticles(NULL),
+		activeCells(64),
+		cellSize(MIN_CELL_SIZE),
+		nbCellBits(0),
+		maxRadius(0.0f),
+		radixShift(0),
+		sortBuffer(0)
+	{
+		for (size_t i = 0; i < 3; ++i)
+			dimensions[i] = 0;
+		for (size_t i = 0; i < 2; ++i)
+		{
+			sortKeys[i] = NULL;
+			sortIndices[i] = NULL;
+		}
+	}
+
+	SpatialGrid::~SpatialGrid()
+	{
+		SPK_DELETE_ARRAY(particleCoordinates);
+		for (size_t i = 0; i < 2; ++i)
+		{
+			SPK_DELETE_ARRAY(sortKeys[i]);
+			SPK_DELETE_ARRAY(sortIndices[i]);
+		}
+	}
+
+	void SpatialGrid::getNeighborCells(size_t particleIndex,Array<size_t>& cells) const
+	{
+		cells.clear();
+		const Coordinates& coordinates = particleCoordinates[particleIndex];
+
+		// Bounds of the block of cells intersected by the enlarged sphere of the particle
+		unsigned int min[3];
+		unsigned int max[3];
+		for (size_t i = 0; i < 3; ++i)
+		{
+			min[i] = coordinates.value[i] - ((coordinates.lowerNeighbors >> i) & 1);
+			max[i] = coordinates.value[i] + ((coordinates.upperNeighbors >> i) & 1);
+		}
+
+		for (unsigned int x = min[0]; x <= max[0]; ++x)
+			for (unsigned int y = min[1]; y <= max[1]; ++y)
+				for (unsigned int z = min[2]; z <= max[2]; ++z)
+				{
+					size_t cellIndex = mortonCodes[0][x] | mortonCodes[1][y] | mortonCodes[2][z];
+					if (cellStarts[cellIndex + 1] != cellStarts[cellIndex]) // Empty cells are skipped
+						cells.push(cellIndex);
+				}
+	}
+
+	void SpatialGrid::getCellsInBox(const Vector3D& boxMin,const Vector3D& boxMax,Array<size_t>& cells) const
+	{
+		cells.clear();
+		if (activeCells.empty())
+			return;
+
+		// The coordinates are clamped the way the ones of the particles are
+		const float invCellSize = 1.0f / cellSize;
+		unsigned int min[3];
+		unsigned int max[3];
+		for (size_t i = 0; i < 3; ++i)
+		{
+			float minCoordinate = (boxMin[i] - AABBMin[i]) * invCellSize;
+			float maxCoordinate = (boxMax[i] - AABBMin[i]) * invCellSize;
+			min[i] = minCoordinate <= 0.0f ? 0 : (minCoordinate < dimensions[i] ? static_cast<unsigned int>(minCoordinate) : static_cast<unsigned int>(dimensions[i] - 1));
+			max[i] = maxCoordinate <= 0.0f ? 0 : (maxCoordinate < dimensions[i] ? static_cast<unsigned int>(maxCoordinate) : static_cast<unsigned int>(dimensions[i] - 1));
+		}
+
+		for (unsigned int x = min[0]; x <= max[0]; ++x)
+			for (unsigned int y = min[1]; y <= max[1]; ++y)
+				for (unsigned int z = min[2]; z <= max[2]; ++z)
+				{
+					size_t cellIndex = mortonCodes[0][x] | mortonCodes[1][y] | mortonCodes[2][z];
+					if (cellStarts[cellIndex + 1] != cellStarts[cellIndex]) // Empty cells are skipped
+						cells.push(cellIndex);
+				}
+	}
+
+	void SpatialGrid::update(TaskScheduler* taskScheduler)
+	{
+		// Reallocates if necessary
+		if (group.getCapacity() != nbParticles)
+		{
+			nbParticles = group.getCapacity();
+			SPK_DELETE_ARRAY(particleCoordinates);
+			particleCoordinates = SPK_NEW_ARRAY(Coordinates,nbParticles);
+			for (size_t i = 0; i < 2; ++i)
+			{
+				SPK_DELETE_ARRAY(sortKeys[i]);
+				SPK_DELETE_ARRAY(sortIndices[i]);
+				sortKeys[i] = SPK_NEW_ARRAY(size_t,nbParticles);
+				sortIndices[i] = SPK_NEW_ARRAY(size_t,nbParticles);
+			}
+		}
+
+		activeCells.clear();
+
+		// Traversal needed to size the grid
+		float radiusSum = 0.0f;
+		computeBounds(maxRadius,radiusSum,taskScheduler);
+
+		if (group.getNbParticles() == 0)
+		{
+			AABBMin.set(0.0f,0.0f,0.0f);
+			AABBMax.set(0.0f,0.0f,0.0f);
+			return;
+		}
+
+		computeDimensions();
+		computeMortonCodes();
+
+		size_t nbCells = mortonCodes[0].back() | mortonCodes[1].back() | mortonCodes[2].back(); // Index of the last cell
+		++nbCells;
+
+		// Computes the cells of the particles
+		size_t nbChunks = getNbChunks();
+		executePass(*this,&SpatialGrid::computeCells,nbChunks,taskScheduler);
+
+		// Both sorts are stable so that particles are ordered by index within a cell whatever the threads
+		if (taskScheduler != NULL && nbChunks > 1)
+			radixSort(nbCells,taskScheduler);
+		else
+			countingSort(nbCells);
+	}
+
+	void SpatialGrid::computeCells(size_t startChunk,size_t endChunk)
+	{
+		const Group& group = this->group;
+		const float invCellSize = 1.0f / cellSize;
+		size_t* keys = sortKeys[0];
+
+		size_t end = getChunkStart(endChunk);
+		for (size_t i = getChunkStart(startChunk); i < end; ++i)
+		{
+			const Particle particle = group.getParticle(i);
+			Coordinates& coordinates = particleCoordinates[i];
+			coordinates.lowerNeighbors = coordinates.upperNeighbors = 0;
+
+			// A neighbor intersecting the particle has its center within the sphere enlarged by the biggest radius, which is smaller than half a cell
+			float reach = (particle.getRadius() + maxRadius) * invCellSize;
+			for (size_t j = 0; j < 3; ++j)
+			{
+				float coordinate = (particle.position()[j] - AABBMin[j]) * invCellSize;
+				unsigned int cell = coordinate < dimensions[j] ? static_cast<unsigned int>(coordinate) : static_cast<unsigned int>(dimensions[j] - 1);
+				coordinates.value[j] = cell;
+				if (cell > 0 && coordinate - reach < cell)
+					coordinates.lowerNeighbors |= 1 << j;
+				if (cell + 1 < dimensions[j] && coordinate + reach >= cell + 1)
+					coordinates.upperNeighbors |= 1 << j;
+			}
+
+			keys[i] = getCellIndex(coordinates);
+		}
+	}
+
+	void SpatialGrid::countingSort(size_t nbCells)
+	{
+		const size_t* keys = sortKeys[0];
+		size_t nbActiveParticles = group.getNbParticles();
+
+		// The particles of a cell are counted 2 slots after it so that once summed, cellStarts[i + 1] is the start of the cell i
+		// and becomes its end while the particles are placed
+		cellStarts.assign(nbCells + 2,0);
+
+		// First pass : counts the particles per cell
+		for (size_t i = 0; i < nbActiveParticles; ++i)
+			++cellStarts[keys[i] + 2];
+
+		for (size_t i = 0; i < nbCells; ++i)
+		{
+			if (cellStarts[i + 2] != 0)
+				activeCells.push(i);
+			cellStarts[i + 2] += cellStarts[i + 1];
+		}
+
+		// Second pass : places the particles. Particles are traversed by index so they remain ordered by index within a cell
+		sortedParticles = sortIndices[0];
+		for (size_t i = 0; i < nbActiveParticles; ++i)
+			sortedParticles[cellStarts[keys[i] + 1]++] = i;
+	}
+
+	void SpatialGrid::radixSort(size_t nbCells,TaskScheduler* taskScheduler)
+	{
+		size_t nbChunks = getNbChunks();
+		const size_t RADIX_SIZE = static_cast<size_t>(1) << RADIX_NB_BITS;
+		radixOffsets.resize(nbChunks * RADIX_SIZE);
+
+		// Least significant digit first. Each pass is stable : within a digit, chunks are placed in order and so are the particles of a chunk
+		sortBuffer = 0;
+		for (radixShift = 0; radixShift == 0 || radixShift < nbCellBits; radixShift += RADIX_NB_BITS)
+		{
+			executePass(*this,&SpatialGrid::countDigits,nbChunks,taskScheduler);
+
+			size_t offset = 0;
+			for (size_t digit = 0; digit < RADIX_SIZE; ++digit)
+				for (size_t chunk = 0; chunk < nbChunks; ++chunk)
+				{
+					size_t& chunkOffset = radixOffsets[chunk * RADIX_SIZE + digit];
+					size_t nb = chunkOffset;
+					chunkOffset = offset;
+					offset += nb;
+				}
+
+			executePass(*this,&SpatialGrid::placeDigits,nbChunks,taskScheduler);
+			sortBuffer = 1 - sortBuffer;
+		}
+
+		sortedParticles = sortIndices[sortBuffer];
+
+		// The start of a cell is the position of its first particle or of the first particle of the next non empty cells
+		cellStarts.resize(nbCells + 2);
+		executePass(*this,&SpatialGrid::computeCellStarts,nbChunks,taskScheduler);
+		size_t nbActiveParticles = group.getNbParticles();
+		for (size_t i = sortKeys[sortBuffer][nbActiveParticles - 1] + 1; i <= nbCells; ++i)
+			cellStarts[i] = nbActiveParticles;
+
+		// Active cells are counted per chunk and then written at the offset of their chunk
+		chunkNbActiveCells.resize(nbChunks + 1);
+		executePass(*this,&SpatialGrid::countActiveCells,nbChunks,taskScheduler);
+		size_t nbActiveCells = 0;
+		for (size_t i = 0; i < nbChunks; ++i)
+		{
+			size_t nb = chunkNbActiveCells[i];
+			chunkNbActiveCells[i] = nbActiveCells;
+			nbActiveCells += nb;
+		}
+		activeCells.resize(nbActiveCells);
+		executePass(*this,&SpatialGrid::writeActiveCells,nbChunks,taskScheduler);
+	}
+
+	void SpatialGrid::countDigits(size_t startChunk,size_t endChunk)
+	{
+		const size_t RADIX_SIZE = static_cast<size_t>(1) << RADIX_NB_BITS;
+		const size_t* keys = sortKeys[sortBuffer];
+		for (size_t i = startChunk; i < endChunk; ++i)
+		{
+			size_t* counts = &radixOffsets[i * RADIX_SIZE];
+			for (size_t j = 0; j < RADIX_SIZE; ++j)
+				counts[j] = 0;
+
+			size_t end = getChunkStart(i + 1);
+			for (size_t j = getChunkStart(i); j < end; ++j)
+				++counts[(keys[j] >> radixShift) & (RADIX_SIZE - 1)];
+		}
+	}
+
+	void SpatialGrid::placeDigits(size_t startChunk,size_t endChunk)
+	{
+		const size_t RADIX_SIZE = static_cast<size_t>(1) << RADIX_NB_BITS;
+		const size_t* keys = sortKeys[sortBuffer];
+		const size_t* indices = radixShift == 0 ? NULL : sortIndices[sortBuffer]; // Particles are in index order before the first pass
+		size_t* sortedKeys = sortKeys[1 - sortBuffer];
+		size_t* sortedIndices = sortIndices[1 - sortBuffer];
+
+		for (size_t i = startChunk; i < endChunk; ++i)
+		{
+			size_t* offsets = &radixOffsets[i * RADIX_SIZE];
+			size_t end = getChunkStart(i + 1);
+			for (size_t j = getChunkStart(i); j < end; ++j)
+			{
+				size_t position = offsets[(keys[j] >> radixShift) & (RADIX_SIZE - 1)]++;
+				sortedKeys[position] = keys[j];
+				sortedIndices[position] = indices != NULL ? indices[j] : j;
+			}
+		}
+	}
+
+	void SpatialGrid::computeCellStarts(size_t startChunk,size_t endChunk)
+	{
+		const size_t* keys = sortKeys[sortBuffer];
+		size_t end = getChunkStart(endChunk);
+		for (size_t i = getChunkStart(startChunk); i < end; ++i)
+		{
+			// Each cell is written once, by the first particle after it
+			size_t firstCell = i > 0 ? keys[i - 1] + 1 : 0;
+			for (size_t j = firstCell; j <= keys[i]; ++j)
+				cellStarts[j] = i;
+		}
+	}
+
+	void SpatialGrid::countActiveCells(size_t startChunk,size_t endChunk)
+	{
+		const size_t* keys = sortKeys[sortBuffer];
+		for (size_t i = startChunk; i < endChunk; ++i)
+		{
+			size_t nb = 0;
+			size_t end = getChunkStart(i + 1);
+			for (size_t j = getChunkStart(i); j < end; ++j)
+				if (j == 0 || keys[j] != keys[j - 1])
+					++nb;
+			chunkNbActiveCells[i] = nb;
+		}
+	}
+
+	void SpatialGrid::writeActiveCells(size_t startChunk,size_t endChunk)
+	{
+		const size_t* keys = sortKeys[sortBuffer];
+		for (size_t i = startChunk; i < endChunk; ++i)
+		{
+			size_t index = chunkNbActiveCells[i];
+			size_t end = getChunkStart(i + 1);
+			for (size_t j = getChunkStart(i); j < end; ++j)
+				if (j == 0 || keys[j] != keys[j - 1])
+					activeCells[index++] = keys[j];
+		}
+	}
+
+	void SpatialGrid::computeDimensions()
+	{
+		// The cells are at least twice as big as the biggest particle so that the enlarged sphere of a particle intersects at most 2 cells per axis
+		cellSize = 4.0f * maxRadius;
+		if (cellSize < MIN_CELL_SIZE)
+			cellSize = MIN_CELL_SIZE;
+
+		size_t maxNbBits = 0;
+		while ((static_cast<size_t>(2) << maxNbBits) <= MAX_CELLS_PER_PARTICLE * group.getNbParticles())
+			++maxNbBits;
+		const float maxDimension = static_cast<float>(static_cast<size_t>(1) << maxNbBits);
+
+		// Particles at positions or of radii that are not finite cannot be spread in cells. They are all put in a single cell
+		const Vector3D extent = AABBMax - AABBMin;
+		if (!std::isfinite(extent.x) || !std::isfinite(extent.y) || !std::isfinite(extent.z) || !std::isfinite(cellSize))
+		{
+			cellSize = std::numeric_limits<float>::max();
+			for (size_t i = 0; i < 3; ++i)
+				dimensions[i] = 1;
+			return;
+		}
+
+		// Cells are enlarged until the Morton codes fit in the number of bits allowed
+		while (true)
+		{
+			size_t nbBits = 0;
+			for (size_t i = 0; i < 3 && nbBits <= maxNbBits; ++i)
+			{
+				float dimension = extent[i] / cellSize;
+				if (dimension >= maxDimension)
+				{
+					nbBits = maxNbBits + 1;
+					break;
+				}
+
+				dimensions[i] = static_cast<size_t>(dimension) + 1;
+				for (size_t axisNbBits = 0; (static_cast<size_t>(1) << axisNbBits) < dimensions[i]; ++axisNbBits)
+					++nbBits;
+			}
+
+			if (nbBits <= maxNbBits)
+				return;
+
+			cellSize *= 2.0f;
+		}
+	}
+
+	void SpatialGrid::computeMortonCodes()
+	{
+		// The codes only depend on the dimensions
+		if (mortonCodes[0].size() == dimensions[0] && mortonCodes[1].size() == dimensions[1] && mortonCodes[2].size() == dimensions[2])
+			return;
+
+		size_t nbBits[3];
+		for (size_t i = 0; i < 3; ++i)
+		{
+			nbBits[i] = 0;
+			while ((static_cast<size_t>(1) << nbBits[i]) < dimensions[i])
+				++nbBits[i];
+			mortonCodes[i].assign(dimensions[i],0);
+		}
+
+		// Interleaves the bits of the coordinates. Once an axis has no more bits, the remaining ones are interleaved between the other axes
+		nbCellBits = 0;
+		for (size_t level = 0; level < nbBits[0] || level < nbBits[1] || level < nbBits[2]; ++level)
+			for (size_t i = 0; i < 3; ++i)
+				if (level < nbBits[i])
+				{
+					for (size_t j = 0; j < dimensions[i]; ++j)
+						if ((j >> level) & 1)
+							mortonCodes[i][j] |= static_cast<size_t>(1) << nbCellBits;
+					++nbCellBits;
+				}
+	}
+}
@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <SPARK_Core.h>
+
+#ifdef SPK_THREADS
+#include <atomic>
+#endif
+
+namespace SPK
+{
+namespace
+{
+#ifdef SPK_THREADS
+
+	typedef std::atomic<size_t> AtomicSize;
+
+	const std::memory_order RELAXED = std::memory_order_relaxed;
+	const std::memory_order ACQUIRE = std::memory_order_acquire;
+	const std::memory_order RELEASE = std::memory_order_release;
+
+#else
+
+	enum MemoryOrder
+	{
+		RELAXED,
+		ACQUIRE,
+		RELEASE,
+	};
+
+	// Without threads, the queue is used from a single thread and needs no atomic operation
+	class AtomicSize
+	{
+	public :
+
+		AtomicSize(size_t value = 0) : value(value) {}
+
+		size_t load(MemoryOrder) const { return value; }
+		void store(size_t value,MemoryOrder) { this->value = value; }
+
+		bool compare_exchange_weak(size_t& expected,size_t desired,MemoryOrder)
+		{
+			if (value != expected)
+			{
+				expected = value;
+				return false;
+			}
+			value = desired;
+			return true;
+		}
+
+	private :
+
+		size_t value;
+	};
+
+#endif
+}
+
+	// Bounded queue in which each cell holds a sequence number telling whether it is free for a push or ready for a pop
+	struct SpawnQueue::Impl
+	{
+		struct Cell
+		{
+			AtomicSize sequence;
+			SpawnRequest request;
+		};
+
+		Cell* cells;
+		size_t mask;
+
+		AtomicSize pushPosition;
+		char padding[64]; // Keeps the positions of the producers and of the consumer on different cache lines
+		size_t popPosition;
+
+		Impl(size_t capacity) :
+			cells(SPK_NEW_ARRAY(Cell,capacity)),
+			mask(capacity - 1),
+			pushPosition(0),
+			popPosition(0)
+		{
+			for (size_t i = 0; i < capacity; ++i)
+				cells[i].sequence.store(i,RELAXED);
+		}
+
+		~Impl()
+		{
+			SPK_DELETE_ARRAY(cells);
+		}
+	};
+
+	SpawnQueue::SpawnQueue(size_t capacity) :
+		impl(NULL)
+	{
+		setCapacity(capacity);
+	}
+
+	SpawnQueue::~SpawnQueue()
+	{
+		SPK_DELETE(impl);
+	}
+
+	void SpawnQueue::setCapacity(size_t capacity)
+	{
+		SPK_DELETE(impl);
+		impl = NULL;
+
+		if (capacity > 0)
+		{
+			size_t roundedCapacity = 1;
+			while (roundedCapacity < capacity)
+				roundedCapacity <<= 1;
+			impl = SPK_NEW(Impl,roundedCapacity);
+		}
+	}
+
+	size_t SpawnQueue::getCapacity() const
+	{
+		return impl != NULL ? impl->mask + 1 : 0;
+	}
+
+	bool SpawnQueue::push(const SpawnRequest& request)
+	{
+		if (impl == NULL)
+			return false;
+
+		// Reserves a cell by moving the push position forward
+		size_t position = impl->pushPosition.load(RELAXED);
+		Impl::Cell* cell;
+		while (true)
+		{
+			cell = impl->cells + (position & impl->mask);
+			size_t sequence = cell->sequence.load(ACQUIRE);
+			if (sequence == position)
+			{
+				if (impl->pushPosition.compare_exchange_weak(position,position + 1,RELAXED))
+					break;
+			}
+			else if (sequence < position)
+				return false; // The cell still holds a request one lap behind so the ring is full
+			else
+				position = impl->pushPosition.load(RELAXED); // Another producer took the cell
+		}
+
+		cell->request = request;
+		cell->sequence.store(position + 1,RELEASE); // Publishes the request to the consumer
+		return true;
+	}
+
+	size_t SpawnQueue::pop(SpawnRequest* requests,size_t nb)
+	{
+		if (impl == NULL)
+			return 0;
+
+		size_t nbPopped = 0;
+		while (nbPopped < nb)
+		{
+			Impl::Cell& cell = impl->cells[impl->popPosition & impl->mask];
+			if (cell.sequence.load(ACQUIRE) != impl->popPosition + 1)
+				break; // The queue is empty or the next request is still being written
+
+			requests[nbPopped++] = cell.request;
+			cell.sequence.store(impl->popPosition + impl->mask + 1,RELEASE); // Frees the cell for the next lap
+			++impl->popPosition;
+		}
+
+		return nbPopped;
+	}
+}
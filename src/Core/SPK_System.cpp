@@ -38,32 +38,61 @@ namespace SPK
 		Transformable(SHARE_POLICY_TRUE),
 		groups(),
 		deltaStep(0.0f),
+		initialized(initialize),
+		active(true),
 		AABBComputationEnabled(false),
 		AABBMin(),
 		AABBMax(),
-		initialized(initialize),
-		active(true)
+		parallelUpdateEnabled(false),
+		asyncUpdateEnabled(false),
+		asyncUpdateTask(*this),
+		asyncTaskScheduler(NULL),
+		nbSkippedFrames(0),
+		skippedTime(0.0f),
+		visible(true),
+		sleepTime(0.0f),
+		catchUpStep(0.1f),
+		maxCatchUpSteps(4),
+		maxSleepTime(10.0f),
+		seed(SPKContext::get().getRandomStream().generateUint()),
+		priority(0)
 	{}
 
 	System::System(const System& system) :
 		Transformable(system),
 		deltaStep(0.0f),
+		initialized(system.initialized),
+		active(system.active),
 		AABBComputationEnabled(system.AABBComputationEnabled),
 		AABBMin(system.AABBMin),
 		AABBMax(system.AABBMax),
-		initialized(system.initialized),
-		active(system.active)
+		parallelUpdateEnabled(system.parallelUpdateEnabled),
+		asyncUpdateEnabled(system.asyncUpdateEnabled),
+		asyncUpdateTask(*this),
+		asyncTaskScheduler(NULL),
+		lodBands(system.lodBands),
+		nbSkippedFrames(0),
+		skippedTime(0.0f),
+		visible(true),
+		sleepTime(0.0f),
+		catchUpStep(system.catchUpStep),
+		maxCatchUpSteps(system.maxCatchUpSteps),
+		maxSleepTime(system.maxSleepTime),
+		seed(SPKContext::get().getRandomStream().generateUint()), // A copy does not replicate the randomness of the original
+		priority(system.priority)
 	{
 		for (std::vector<Ref<Group> >::const_iterator it = system.groups.begin(); it != system.groups.end(); ++it)
 		{
 			Ref<Group> group = system.copyChild(*it);
 			setGroupSystem(group,this);
 			groups.push_back(group);
+			seedGroup(groups.size() - 1);
 		}
 	}
 
 	System::~System()
 	{
+		joinUpdate();
 		while (groups.size() > 0)
 			removeGroup(groups.back());
 	}
@@ -78,6 +107,7 @@ namespace SPK
 
 		Ref<Group> newGroup = SPK_NEW(Group,this,capacity);
 		groups.push_back(newGroup);
+		seedGroup(groups.size() - 1);
 		return newGroup;
 	}
 
@@ -92,6 +122,7 @@ namespace SPK
 		Ref<Group> newGroup = copy(group);
 		setGroupSystem(newGroup,this);
 		groups.push_back(newGroup);
+		seedGroup(groups.size() - 1);
 		return newGroup;
 	}
 
@@ -105,6 +136,7 @@ namespace SPK
 
 		setGroupSystem(group,this);
 		groups.push_back(group);
+		seedGroup(groups.size() - 1);
 	}
 
 	void System::removeGroup(const Ref<Group>& group)
@@ -150,11 +182,102 @@ namespace SPK
 			return true;
 		}
 
+		if (asyncUpdateEnabled)
+			return launchUpdate(deltaTime);
+		else
+			return synchronousUpdate(deltaTime);
+	}
+
+	void System::joinUpdate()
+	{
+		if (asyncTaskScheduler != NULL)
+		{
+			asyncTaskScheduler->wait(asyncUpdateTask);
+			asyncTaskScheduler = NULL;
+
+			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+				(*it)->swapRenderState();
+		}
+	}
+
+	void System::enableAsyncUpdate(bool async)
+	{
+		if (asyncUpdateEnabled && !async)
+		{
+			joinUpdate();
+			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+				(*it)->releaseRenderState();
+		}
+
+		asyncUpdateEnabled = async;
+	}
+
+	bool System::launchUpdate(float deltaTime)
+	{
+		joinUpdate();
+
+		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+			(*it)->prepareRenderState();
+
+		// The state of the system is the one of the joined update as the new one has not started yet
+		bool alive = active;
+
+		asyncUpdateTask.deltaTime = deltaTime;
+		asyncTaskScheduler = SPKContext::get().getTaskScheduler();
+		if (asyncTaskScheduler != NULL)
+			asyncTaskScheduler->launch(asyncUpdateTask,0,1,1);
+		else
+		{
+			// Without scheduler, the update is performed and joined at once
+			asyncUpdateTask.execute(0,1);
+			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+				(*it)->swapRenderState();
+			alive = active;
+		}
+
+		return alive;
+	}
+
+	bool System::synchronousUpdate(float deltaTime)
+	{
 		bool alive = true;
 
 		if (clampStepEnabled && deltaTime > clampStep)
 			deltaTime = clampStep;
 
+		// Systems out of the frustum only accumulate the time and catch up with it once visible again
+		visible = frustumPlanes.empty() || isInFrustum();
+		if (!visible)
+		{
+			sleepTime += deltaTime;
+			if (maxSleepTime > 0.0f && sleepTime > maxSleepTime)
+				sleepTime = maxSleepTime;
+			return active;
+		}
+
+		if (sleepTime > 0.0f)
+			catchUp();
+
+		// Distant systems are updated less often with the time accumulated since their last update
+		bool rendererUpdate = true;
+		bool sorting = true;
+		const LODBand* lodBand = getCurrentLODBand();
+		if (lodBand != NULL)
+		{
+			if (++nbSkippedFrames < lodBand->updateInterval)
+			{
+				skippedTime += deltaTime;
+				return active;
+			}
+
+			rendererUpdate = lodBand->rendererUpdateEnabled;
+			sorting = lodBand->sortingEnabled;
+		}
+
+		deltaTime += skippedTime;
+		nbSkippedFrames = 0;
+		skippedTime = 0.0f;
+
 		if (stepMode != STEP_MODE_REAL)
 		{
 			deltaTime += deltaStep;
@@ -174,17 +297,83 @@ namespace SPK
 
 			while(deltaTime >= updateStep)
 			{
+				// Only the last substep is rendered
+				float remainingTime = deltaTime - updateStep;
+				enableGroupsRenderSide(rendererUpdate,true,remainingTime < updateStep);
+
 				if (alive && !innerUpdate(updateStep))
 					alive = false;
-				deltaTime -= updateStep;
+				deltaTime = remainingTime;
 			}
 			deltaStep = deltaTime;
 		}
 		else
+		{
+			enableGroupsRenderSide(rendererUpdate,true);
 			alive = innerUpdate(deltaTime);
+		}
+
+		finalizeUpdate(sorting);
+
+		active = alive;
+		return active;
+	}
+
+	bool System::prewarm(float duration,float step)
+	{
+		joinUpdate();
+
+		if (!initialized)
+		{
+			SPK_LOG_WARNING("System::prewarm(float,float) - An uninitialized system cannot be prewarmed");
+			return true;
+		}
+
+		if (step <= 0.0f)
+		{
+			SPK_LOG_WARNING("System::prewarm(float,float) - The step must be positive - The system is not prewarmed");
+			return active;
+		}
+
+		// Only the simulation runs, the render side is updated once at the end
+		enableGroupsRenderSide(false,false);
+		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+			(*it)->prewarming = true;
+
+		while (duration > 0.0f)
+		{
+			float prewarmStep = step;
+			if (prewarmStep >= duration)
+			{
+				prewarmStep = duration;
+				duration = 0.0f;
+			}
+			else
+				duration -= prewarmStep;
+
+			active = innerUpdate(prewarmStep);
+		}
 
 		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
-			(*it)->sortParticles();
+			(*it)->prewarming = false;
+		enableGroupsRenderSide(true,true);
+
+		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+			(*it)->updateRenderSide();
+
+		finalizeUpdate(true);
+		return active;
+	}
+
+	void System::finalizeUpdate(bool sorting)
+	{
+		// Sorts the groups and computes their AABB (concurrently if possible)
+		GroupFinalizeTask task(groups,sorting,isAABBComputationEnabled());
+		TaskScheduler* taskScheduler = getGroupsTaskScheduler();
+		if (taskScheduler != NULL)
+			taskScheduler->parallelFor(task,0,groups.size(),1);
+		else
+			task.execute(0,groups.size());
 
 		if (isAABBComputationEnabled())
 		{
@@ -194,8 +383,6 @@ namespace SPK
 
 			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
 			{
-				(*it)->computeAABB();
-
 				AABBMin.setMin((*it)->getAABBMin());
 				AABBMax.setMax((*it)->getAABBMax());
 			}
@@ -205,9 +392,186 @@ namespace SPK
 			const Vector3D pos = getTransform().getWorldPos();
 			AABBMin = AABBMax = pos;
 		}
+	}
 
-		active = alive;
-		return active;
+	void System::enableGroupsRenderSide(bool rendererUpdate,bool distanceUpdate,bool lastStep)
+	{
+		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+		{
+			bool deferred = !lastStep && (*it)->deferredRenderSideEnabled;
+			(*it)->rendererUpdateEnabled = rendererUpdate && !deferred;
+			(*it)->distanceUpdateEnabled = distanceUpdate && !deferred;
+		}
+	}
+
+	void System::addLODBand(float distance,unsigned int updateInterval,bool rendererUpdate,bool sorting)
+	{
+		LODBand band = {distance,updateInterval,rendererUpdate,sorting};
+		lodBands.push_back(band);
+	}
+
+	void System::removeLODBand(unsigned int index)
+	{
+		if (index >= lodBands.size())
+		{
+			SPK_LOG_WARNING("System::removeLODBand(unsigned int) - Index of LOD band is out of bounds : " << index);
+			return;
+		}
+
+		description::lodBands::elementRemoved(this,index);
+		lodBands.erase(lodBands.begin() + index);
+	}
+
+	void System::clearLODBands()
+	{
+		description::lodBands::elementsCleared(this);
+		lodBands.clear();
+	}
+
+	void System::createLODBand()
+	{
+		addLODBand(lodBands.empty() ? 0.0f : lodBands.back().distance,1);
+	}
+
+	float System::getSqrDistanceToCamera() const
+	{
+		Vector3D boundsMin,boundsMax;
+		getBounds(boundsMin,boundsMax);
+		Vector3D delta;
+		delta.setMax(boundsMin - cameraPosition);
+		delta.setMax(cameraPosition - boundsMax);
+		return delta.getSqrNorm();
+	}
+
+	const System::LODBand* System::getCurrentLODBand() const
+	{
+		if (lodBands.empty())
+			return NULL;
+
+		float sqrDist = getSqrDistanceToCamera();
+
+		const LODBand* band = NULL;
+		for (std::vector<LODBand>::const_iterator it = lodBands.begin(); it != lodBands.end(); ++it)
+			if (it->distance * it->distance <= sqrDist && (band == NULL || it->distance > band->distance))
+				band = &*it;
+
+		return band;
+	}
+
+	void System::getBounds(Vector3D& min,Vector3D& max) const
+	{
+		// The AABB of an empty system is inverted, its position is used instead
+		if (isAABBComputationEnabled() && AABBMin.x <= AABBMax.x)
+		{
+			min = AABBMin;
+			max = AABBMax;
+		}
+		else
+			min = max = getTransform().getWorldPos();
+	}
+
+	void System::setFrustum(const float* planes,size_t nbPlanes)
+	{
+		frustumPlanes.assign(planes,planes + nbPlanes * 4);
+		if (nbPlanes == 0)
+			visible = true;
+	}
+
+	bool System::isInFrustum() const
+	{
+		Vector3D boundsMin,boundsMax;
+		getBounds(boundsMin,boundsMax);
+
+		// The bounds are outside if their corner the farthest along the normal of a plane is outside
+		for (size_t i = 0; i < frustumPlanes.size(); i += 4)
+		{
+			const float* plane = &frustumPlanes[i];
+			float x = plane[0] >= 0.0f ? boundsMax.x : boundsMin.x;
+			float y = plane[1] >= 0.0f ? boundsMax.y : boundsMin.y;
+			float z = plane[2] >= 0.0f ? boundsMax.z : boundsMin.z;
+			if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f)
+				return false;
+		}
+
+		return true;
+	}
+
+	void System::setCatchUpStep(float catchUpStep)
+	{
+		if (catchUpStep <= 0.0f)
+		{
+			SPK_LOG_WARNING("System::setCatchUpStep(float) - The catch up step must be positive - The step is not set");
+			return;
+		}
+
+		this->catchUpStep = catchUpStep;
+	}
+
+	void System::setSeed(unsigned int seed)
+	{
+		this->seed = seed;
+		for (size_t i = 0; i < groups.size(); ++i)
+			seedGroup(i);
+	}
+
+	void System::restart(const System& prototype)
+	{
+		joinUpdate();
+
+		SPK_ASSERT(groups.size() == prototype.groups.size(),"System::restart(const System&) - The system is not a copy of the prototype");
+
+		active = true;
+		deltaStep = 0.0f;
+		nbSkippedFrames = 0;
+		skippedTime = 0.0f;
+		visible = true;
+		sleepTime = 0.0f;
+
+		for (size_t i = 0; i < groups.size(); ++i)
+		{
+			Group& group = *groups[i];
+			const Group& prototypeGroup = *prototype.groups[i];
+
+			group.empty();
+			group.drainSpawnQueue(); // The pending requests are discarded
+			group.emptyBufferedParticles();
+			group.rendererDeltaTime = 0.0f;
+			group.shrinkTime = 0.0f;
+
+			for (size_t j = 0; j < group.emitters.size() && j < prototypeGroup.emitters.size(); ++j)
+			{
+				group.emitters[j]->setActive(prototypeGroup.emitters[j]->isActive());
+				group.emitters[j]->resetTank();
+			}
+		}
+
+		setSeed(SPKContext::get().getRandomStream().generateUint());
+		AABBMin = AABBMax = getTransform().getWorldPos();
+	}
+
+	void System::seedGroup(size_t index)
+	{
+		groups[index]->randomStream.setSeed(RandomStream::hash(seed + static_cast<uint32>(index)));
+	}
+
+	void System::catchUp()
+	{
+		// The catch up only simulates the particles, the render side is left to the regular update
+		enableGroupsRenderSide(false,false);
+
+		for (unsigned int i = 0; i < maxCatchUpSteps && sleepTime > 0.0f; ++i)
+		{
+			float step = catchUpStep;
+			if (step >= sleepTime)
+			{
+				step = sleepTime;
+				sleepTime = 0.0f;
+			}
+			else
+				sleepTime -= step;
+
+			active = innerUpdate(step);
+		}
 	}
 
 	void System::renderParticles() const
@@ -260,11 +624,193 @@ namespace SPK
 
 		// Particles
 		bool alive = false;
-		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
-			alive |= (*it)->updateParticles(deltaTime);
+
+		if (parallelUpdateEnabled)
+		{
+			// The data are prepared on the calling thread as they may be created (each group draws from its own stream so the results are not changed)
+			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+				(*it)->prepareAdditionnalData();
+
+			sortGroupsByDependencies();
+			aliveGroups.assign(groups.size(),0);
+
+			// The chains are updated concurrently if there are several ones, otherwise the groups may split their own update
+			TaskScheduler* taskScheduler = getGroupsTaskScheduler();
+			bool concurrent = taskScheduler != NULL && chainEnds.size() > 1;
+			GroupUpdateTask task(*this,deltaTime,concurrent);
+			if (concurrent)
+				taskScheduler->parallelFor(task,0,chainEnds.size(),1);
+			else
+				task.execute(0,chainEnds.size());
+
+			for (std::vector<unsigned char>::const_iterator it = aliveGroups.begin(); it != aliveGroups.end(); ++it)
+				alive |= (*it != 0);
+		}
+		else
+			for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
+				alive |= (*it)->updateParticles(deltaTime);
+
 		return alive;
 	}
 
+	namespace
+	{
+		// Finds the first group of the chain of a group (with path halving)
+		size_t findChain(std::vector<size_t>& chains,size_t index)
+		{
+			while (chains[index] != index)
+				index = chains[index] = chains[chains[index]];
+			return index;
+		}
+
+		void mergeChains(std::vector<size_t>& chains,size_t index0,size_t index1)
+		{
+			index0 = findChain(chains,index0);
+			index1 = findChain(chains,index1);
+			chains[std::max(index0,index1)] = std::min(index0,index1);
+		}
+	}
+
+	void System::sortGroupsByDependencies()
+	{
+		const size_t nbGroups = groups.size();
+		groupChains.resize(nbGroups);
+		nbGroupProducers.assign(nbGroups,0);
+		for (size_t i = 0; i < nbGroups; ++i)
+			groupChains[i] = i;
+
+		// Gathers the groups of this system each group adds particles to
+		groupDependencies.clear();
+		for (size_t i = 0; i < nbGroups; ++i)
+		{
+			const Group& group = *groups[i];
+			targetGroups.clear();
+			for (std::vector<Group::ModifierDef>::const_iterator it = group.modifiers.begin(); it != group.modifiers.end(); ++it)
+				it->obj->getTargetGroups(targetGroups);
+			if (group.birthAction)
+				group.birthAction->getTargetGroups(targetGroups);
+			if (group.deathAction)
+				group.deathAction->getTargetGroups(targetGroups);
+
+			for (std::vector<Group*>::const_iterator it = targetGroups.begin(); it != targetGroups.end(); ++it)
+			{
+				size_t index = std::find(groups.begin(),groups.end(),*it) - groups.begin();
+				if (index != nbGroups && index != i)
+				{
+					groupDependencies.push_back(std::make_pair(i,index));
+					++nbGroupProducers[index];
+					mergeChains(groupChains,i,index);
+				}
+			}
+		}
+
+		// Groups sharing an object whose state is modified by their update belong to the same chain
+		groupObjects.clear();
+		for (size_t i = 0; i < nbGroups; ++i)
+		{
+			const Group& group = *groups[i];
+			for (std::vector<Ref<Emitter> >::const_iterator it = group.emitters.begin(); it != group.emitters.end(); ++it)
+				groupObjects.push_back(std::make_pair(it->get(),i));
+			for (std::vector<Group::ModifierDef>::const_iterator it = group.modifiers.begin(); it != group.modifiers.end(); ++it)
+				groupObjects.push_back(std::make_pair(it->obj.get(),i));
+			if (group.birthAction)
+				groupObjects.push_back(std::make_pair(group.birthAction.get(),i));
+			if (group.deathAction)
+				groupObjects.push_back(std::make_pair(group.deathAction.get(),i));
+		}
+
+		std::sort(groupObjects.begin(),groupObjects.end());
+		for (size_t i = 1; i < groupObjects.size(); ++i)
+			if (groupObjects[i].first == groupObjects[i - 1].first)
+				mergeChains(groupChains,groupObjects[i - 1].second,groupObjects[i].second);
+
+		// Orders each chain topologically (a group whose producers are all updated is picked in the order of the system, or the first one left in case of cycle)
+		const size_t SORTED = std::numeric_limits<size_t>::max();
+		groupOrder.clear();
+		chainEnds.clear();
+		for (size_t first = 0; first < nbGroups; ++first)
+			if (findChain(groupChains,first) == first)
+			{
+				for (;;)
+				{
+					size_t next = nbGroups;
+					for (size_t i = first; i < nbGroups && next == nbGroups; ++i)
+						if (nbGroupProducers[i] == 0 && findChain(groupChains,i) == first)
+							next = i;
+					for (size_t i = first; i < nbGroups && next == nbGroups; ++i)
+						if (nbGroupProducers[i] != SORTED && findChain(groupChains,i) == first)
+							next = i;
+					if (next == nbGroups)
+						break;
+
+					nbGroupProducers[next] = SORTED;
+					groupOrder.push_back(next);
+					for (std::vector<std::pair<size_t,size_t> >::const_iterator it = groupDependencies.begin(); it != groupDependencies.end(); ++it)
+						if (it->first == next && nbGroupProducers[it->second] != SORTED)
+							--nbGroupProducers[it->second];
+				}
+
+				chainEnds.push_back(groupOrder.size());
+			}
+	}
+
+	TaskScheduler* System::getGroupsTaskScheduler() const
+	{
+		TaskScheduler* taskScheduler = SPKContext::get().getTaskScheduler();
+		if (!parallelUpdateEnabled || taskScheduler == NULL || taskScheduler->getNbWorkers() == 0 || groups.size() < 2)
+			return NULL;
+		return taskScheduler;
+	}
+
+	System::GroupUpdateTask::GroupUpdateTask(System& system,float deltaTime,bool concurrent) :
+		system(system),
+		deltaTime(deltaTime),
+		concurrent(concurrent)
+	{}
+
+	void System::GroupUpdateTask::execute(size_t start,size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+			for (size_t j = (i == 0 ? 0 : system.chainEnds[i - 1]); j < system.chainEnds[i]; ++j)
+			{
+				size_t index = system.groupOrder[j];
+				Group& group = *system.groups[index];
+				group.concurrentUpdate = concurrent;
+				group.updateRanges(deltaTime);
+				system.aliveGroups[index] = group.completeUpdate(deltaTime);
+				group.concurrentUpdate = false;
+			}
+	}
+
+	System::AsyncUpdateTask::AsyncUpdateTask(System& system) :
+		deltaTime(0.0f),
+		system(system)
+	{}
+
+	void System::AsyncUpdateTask::execute(size_t,size_t)
+	{
+		system.synchronousUpdate(deltaTime);
+		for (std::vector<Ref<Group> >::const_iterator it = system.groups.begin(); it != system.groups.end(); ++it)
+			(*it)->completeRenderState();
+	}
+
+	System::GroupFinalizeTask::GroupFinalizeTask(const std::vector<Ref<Group> >& groups,bool sort,bool computeAABB) :
+		groups(groups),
+		sort(sort),
+		computeAABB(computeAABB)
+	{}
+
+	void System::GroupFinalizeTask::execute(size_t start,size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+		{
+			if (sort)
+				groups[i]->sortParticles();
+			if (computeAABB)
+				groups[i]->computeAABB();
+		}
+	}
+
 	void System::propagateUpdateTransform()
 	{
 		for (std::vector<Ref<Group> >::const_iterator it = groups.begin(); it != groups.end(); ++it)
@@ -281,6 +827,7 @@ namespace SPK
 			if (remove && group->system != NULL)
 				group->system->removeGroup(group);
 
+			group->releaseRenderState(); // Created again if the new system is updated asynchronously
 			group->system = system;
 			group->initData(); // To initialize the group if needed
 		}
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <SPARK_Core.h>
+
+namespace SPK
+{
+namespace
+{
+	void shareObject(SPKObject* object,std::vector<SPKObject*>& sharedObjects)
+	{
+		if (object != NULL && !object->isShared())
+		{
+			object->setShared(true);
+			sharedObjects.push_back(object);
+		}
+	}
+}
+
+	SystemPool::SystemPool(const Ref<System>& prototype,size_t capacity) :
+		prototype(prototype),
+		maxInstances(0),
+		nbActiveInstances(0)
+	{
+		SPK_ASSERT(prototype,"SystemPool::SystemPool(const Ref<System>&,size_t) - The prototype must not be NULL");
+		reserve(capacity);
+	}
+
+	void SystemPool::reserve(size_t capacity)
+	{
+		if (maxInstances > 0 && capacity > maxInstances)
+			capacity = maxInstances;
+
+		instances.reserve(capacity);
+		while (instances.size() < capacity)
+			instances.push_back(createInstance());
+	}
+
+	Ref<System> SystemPool::acquire()
+	{
+		if (nbActiveInstances == instances.size())
+		{
+			if (maxInstances > 0 && instances.size() >= maxInstances)
+				return SPK_NULL_REF;
+			instances.push_back(createInstance());
+		}
+
+		const Ref<System>& instance = instances[nbActiveInstances++];
+		instance->restart(*prototype);
+		return instance;
+	}
+
+	bool SystemPool::release(const Ref<System>& instance)
+	{
+		for (size_t i = 0; i < nbActiveInstances; ++i)
+			if (instances[i] == instance)
+			{
+				releaseInstance(i);
+				return true;
+			}
+
+		return false;
+	}
+
+	void SystemPool::releaseAll()
+	{
+		nbActiveInstances = 0;
+	}
+
+	void SystemPool::updateInstances(float deltaTime)
+	{
+		for (size_t i = 0; i < nbActiveInstances;)
+			if (!instances[i]->updateParticles(deltaTime))
+				releaseInstance(i); // The last active instance takes its place
+			else
+				++i;
+	}
+
+	void SystemPool::renderInstances() const
+	{
+		for (size_t i = 0; i < nbActiveInstances; ++i)
+			instances[i]->renderParticles();
+	}
+
+	Ref<System> SystemPool::createInstance() const
+	{
+		// The configuration objects are shared for the time of the copy so that the instances reference them
+		std::vector<SPKObject*> sharedObjects;
+		for (size_t i = 0; i < prototype->getNbGroups(); ++i)
+		{
+			const Ref<Group>& group = prototype->getGroup(i);
+			shareObject(group->getColorInterpolator().get(),sharedObjects);
+			for (int j = PARAM_SCALE; j <= PARAM_ROTATION_SPEED; ++j)
+				shareObject(group->getParamInterpolator(static_cast<Param>(j)).get(),sharedObjects);
+			shareObject(group->getRenderer().get(),sharedObjects);
+		}
+
+		Ref<System> instance = SPKObject::copy(prototype);
+		instance->initialize();
+
+		for (std::vector<SPKObject*>::const_iterator it = sharedObjects.begin(); it != sharedObjects.end(); ++it)
+			(*it)->setShared(false);
+
+		return instance;
+	}
+
+	void SystemPool::releaseInstance(size_t index)
+	{
+		std::swap(instances[index],instances[--nbActiveInstances]);
+	}
+}
@@ -0,0 +1,360 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <SPARK_Core.h>
+
+#ifdef SPK_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace SPK
+{
+#ifdef SPK_THREADS
+
+	struct ThreadPool::Impl
+	{
+		// A parallel execution
+		struct Batch
+		{
+			RangeTask* task;
+			size_t start;
+			size_t end;
+			size_t grainSize;
+			std::atomic<size_t> nbRemainingRanges;
+
+			Batch(RangeTask* task,size_t start,size_t end,size_t grainSize,size_t nbRanges) :
+				task(task),
+				start(start),
+				end(end),
+				grainSize(grainSize),
+				nbRemainingRanges(nbRanges)
+			{}
+		};
+
+		// Consecutive sub ranges of a parallel execution
+		struct Job
+		{
+			Batch* batch;
+			size_t firstRange;
+			size_t nbRanges;
+		};
+
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<Queue*> queues; // One per worker and a last one shared by the other threads
+
+		std::mutex mutex;
+		std::condition_variable wakeUp;
+		unsigned int epoch; // Incremented each time a job is pushed or a parallel execution ends
+		bool stop;
+
+		std::mutex launchMutex;
+		std::vector<Batch*> launchedBatches;
+
+		Impl(size_t nbWorkers) :
+			epoch(0),
+			stop(false)
+		{
+			for (size_t i = 0; i <= nbWorkers; ++i)
+				queues.push_back(SPK_NEW(Queue));
+			for (size_t i = 0; i < nbWorkers; ++i)
+				workers.push_back(std::thread(&Impl::run,this,i));
+		}
+
+		~Impl()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wakeUp.notify_all();
+			for (size_t i = 0; i < workers.size(); ++i)
+				workers[i].join();
+
+			for (size_t i = 0; i < queues.size(); ++i)
+				SPK_DELETE(queues[i]);
+			for (size_t i = 0; i < launchedBatches.size(); ++i)
+				SPK_DELETE(launchedBatches[i]);
+		}
+
+		size_t getQueueIndex() const
+		{
+			std::thread::id id = std::this_thread::get_id();
+			for (size_t i = 0; i < workers.size(); ++i)
+				if (workers[i].get_id() == id)
+					return i;
+			return workers.size();
+		}
+
+		unsigned int getEpoch()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return epoch;
+		}
+
+		void signal()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				++epoch;
+			}
+			wakeUp.notify_all();
+		}
+
+		void push(size_t queueIndex,const Job& job)
+		{
+			{
+				std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+				queues[queueIndex]->jobs.push_back(job);
+			}
+			signal();
+		}
+
+		// Pops the last job of the own queue of the thread or steals the first job of another queue
+		bool findJob(size_t queueIndex,Job& job)
+		{
+			for (size_t i = 0; i < queues.size(); ++i)
+			{
+				Queue& queue = *queues[(queueIndex + i) % queues.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.jobs.empty())
+				{
+					if (i == 0)
+					{
+						job = queue.jobs.back();
+						queue.jobs.pop_back();
+					}
+					else
+					{
+						job = queue.jobs.front();
+						queue.jobs.pop_front();
+					}
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void execute(size_t queueIndex,Job job)
+		{
+			// The second half of the job is left to be stolen until a single range remains
+			while (job.nbRanges > 1)
+			{
+				Job half = job;
+				half.nbRanges = job.nbRanges / 2;
+				half.firstRange = job.firstRange + job.nbRanges - half.nbRanges;
+				job.nbRanges -= half.nbRanges;
+				push(queueIndex,half);
+			}
+
+			Batch& batch = *job.batch;
+			size_t rangeStart = batch.start + job.firstRange * batch.grainSize;
+			batch.task->execute(rangeStart,std::min(rangeStart + batch.grainSize,batch.end));
+
+			if (batch.nbRemainingRanges.fetch_sub(1) == 1)
+				signal();
+		}
+
+		// Executes jobs until the batch is over
+		void wait(size_t queueIndex,Batch& batch)
+		{
+			while (batch.nbRemainingRanges > 0)
+			{
+				unsigned int lastEpoch = getEpoch();
+				Job job;
+				if (findJob(queueIndex,job))
+					execute(queueIndex,job);
+				else
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					while (epoch == lastEpoch && batch.nbRemainingRanges > 0)
+						wakeUp.wait(lock);
+				}
+			}
+		}
+
+		void run(size_t queueIndex)
+		{
+			// Each worker has its own random stream so that SPK_RANDOM never uses the global stream of the context concurrently
+			RandomStream randomStream(RandomStream::hash(static_cast<uint32>(queueIndex)));
+			SPKContext::get().setCurrentRandomStream(&randomStream);
+
+			while (true)
+			{
+				unsigned int lastEpoch;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (stop)
+					{
+						SPKContext::get().setCurrentRandomStream(NULL);
+						return;
+					}
+					lastEpoch = epoch;
+				}
+
+				Job job;
+				if (findJob(queueIndex,job))
+					execute(queueIndex,job);
+				else
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					while (!stop && epoch == lastEpoch)
+						wakeUp.wait(lock);
+				}
+			}
+		}
+	};
+
+	ThreadPool::ThreadPool(size_t nbWorkers) :
+		impl(SPK_NEW(Impl,nbWorkers))
+	{}
+
+	ThreadPool::~ThreadPool()
+	{
+		SPK_DELETE(impl);
+	}
+
+	size_t ThreadPool::getNbWorkers() const
+	{
+		return impl->workers.size();
+	}
+
+	size_t ThreadPool::getNbHardwareThreads()
+	{
+		return std::max(static_cast<size_t>(std::thread::hardware_concurrency()),static_cast<size_t>(1));
+	}
+
+	void ThreadPool::parallelFor(RangeTask& task,size_t start,size_t end,size_t grainSize)
+	{
+		if (start >= end)
+			return;
+
+		if (grainSize == 0)
+			grainSize = 1;
+
+		size_t nbRanges = (end - start + grainSize - 1) / grainSize;
+		if (nbRanges == 1 || impl->workers.empty())
+		{
+			task.execute(start,end);
+			return;
+		}
+
+		Impl::Batch batch(&task,start,end,grainSize,nbRanges);
+		Impl::Job job = { &batch,0,nbRanges };
+		size_t queueIndex = impl->getQueueIndex();
+		impl->execute(queueIndex,job);
+		impl->wait(queueIndex,batch);
+	}
+
+	void ThreadPool::launch(RangeTask& task,size_t start,size_t end,size_t grainSize)
+	{
+		if (start >= end)
+			return;
+
+		if (impl->workers.empty())
+		{
+			task.execute(start,end);
+			return;
+		}
+
+		if (grainSize == 0)
+			grainSize = 1;
+
+		size_t nbRanges = (end - start + grainSize - 1) / grainSize;
+		Impl::Batch* batch = SPK_NEW(Impl::Batch,&task,start,end,grainSize,nbRanges);
+		{
+			std::lock_guard<std::mutex> lock(impl->launchMutex);
+			impl->launchedBatches.push_back(batch);
+		}
+
+		Impl::Job job = { batch,0,nbRanges };
+		impl->push(impl->getQueueIndex(),job);
+	}
+
+	void ThreadPool::wait(RangeTask& task)
+	{
+		Impl::Batch* batch = NULL;
+		{
+			std::lock_guard<std::mutex> lock(impl->launchMutex);
+			for (std::vector<Impl::Batch*>::iterator it = impl->launchedBatches.begin(); it != impl->launchedBatches.end(); ++it)
+				if ((*it)->task == &task)
+				{
+					batch = *it;
+					impl->launchedBatches.erase(it);
+					break;
+				}
+		}
+
+		if (batch != NULL)
+		{
+			impl->wait(impl->getQueueIndex(),*batch);
+			SPK_DELETE(batch);
+		}
+	}
+
+#else
+
+	struct ThreadPool::Impl {};
+
+	ThreadPool::ThreadPool(size_t nbWorkers) :
+		impl(NULL)
+	{
+		if (nbWorkers > 0)
+			SPK_LOG_WARNING("ThreadPool::ThreadPool(size_t) - Threads are not available - Tasks will be executed on the calling thread");
+	}
+
+	ThreadPool::~ThreadPool() {}
+
+	size_t ThreadPool::getNbWorkers() const
+	{
+		return 0;
+	}
+
+	size_t ThreadPool::getNbHardwareThreads()
+	{
+		return 1;
+	}
+
+	void ThreadPool::parallelFor(RangeTask& task,size_t start,size_t end,size_t)
+	{
+		if (start < end)
+			task.execute(start,end);
+	}
+
+	void ThreadPool::launch(RangeTask& task,size_t start,size_t end,size_t grainSize)
+	{
+		parallelFor(task,start,end,grainSize);
+	}
+
+	void ThreadPool::wait(RangeTask&) {}
+
+#endif
+}
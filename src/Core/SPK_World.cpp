@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////////
+// SPARK particle engine														//
+// Copyright (C) 2008-2013 - Julien Fryer - julienfryer@gmail.com				//
+//																				//
+// This software is provided 'as-is', without any express or implied			//
+// warranty.  In no event will the authors be held liable for any damages		//
+// arising from the use of this software.										//
+//																				//
+// Permission is granted to anyone to use this software for any purpose,		//
+// including commercial applications, and to alter it and redistribute it		//
+// freely, subject to the following restrictions:								//
+//																				//
+// 1. The origin of this software must not be misrepresented; you must not		//
+//    claim that you wrote the original software. If you use this software		//
+//    in a product, an acknowledgment in the product documentation would be		//
+//    appreciated but is not required.											//
+// 2. Altered source versions must be plainly marked as such, and must not be	//
+//    misrepresented as being the original software.							//
+// 3. This notice may not be removed or altered from any source distribution.	//
+//////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm> // for std::find
+
+#include <SPARK_Core.h>
+
+namespace SPK
+{
+	World::World() :
+		updateTask(*this),
+		taskScheduler(NULL),
+		deltaTime(0.0f),
+		updating(false)
+	{}
+
+	World::~World()
+	{
+		join();
+	}
+
+	void World::addSystem(const Ref<System>& system)
+	{
+		SPK_ASSERT(system,"World::addSystem(const Ref<System>&) - The system must not be NULL");
+		SPK_ASSERT(!updating,"World::addSystem(const Ref<System>&) - A system cannot be added while the world is updated");
+		if (std::find(systems.begin(),systems.end(),system) != systems.end())
+		{
+			SPK_LOG_WARNING("World::addSystem(const Ref<System>&) - The system is already in the world");
+			return;
+		}
+		systems.push_back(system);
+		aliveSystems.push_back(1);
+	}
+
+	void World::removeSystem(const Ref<System>& system)
+	{
+		SPK_ASSERT(!updating,"World::removeSystem(const Ref<System>&) - A system cannot be removed while the world is updated");
+		std::vector<Ref<System> >::iterator it = std::find(systems.begin(),systems.end(),system);
+		if (it == systems.end())
+		{
+			SPK_LOG_WARNING("World::removeSystem(const Ref<System>&) - The system is not in the world");
+			return;
+		}
+		aliveSystems.erase(aliveSystems.begin() + (it - systems.begin()));
+		systems.erase(it);
+	}
+
+	void World::removeAllSystems()
+	{
+		SPK_ASSERT(!updating,"World::removeAllSystems() - The systems cannot be removed while the world is updated");
+		systems.clear();
+		aliveSystems.clear();
+	}
+
+	void World::update(float deltaTime)
+	{
+		if (updating)
+		{
+			SPK_LOG_WARNING("World::update(float) - The previous update was not joined, it is joined now");
+			join();
+		}
+
+		this->deltaTime = deltaTime;
+		taskScheduler = SPKContext::get().getTaskScheduler();
+		if (taskScheduler != NULL)
+		{
+			taskScheduler->launch(updateTask,0,systems.size(),1);
+			updating = true;
+		}
+		else
+			updateTask.execute(0,systems.size());
+	}
+
+	void World::join()
+	{
+		if (updating)
+		{
+			taskScheduler->wait(updateTask);
+			updating = false;
+		}
+	}
+
+	void World::render() const
+	{
+		SPK_ASSERT(!updating,"World::render() - The update must be joined before rendering");
+		for (std::vector<Ref<System> >::const_iterator it = systems.begin(); it != systems.end(); ++it)
+			(*it)->renderParticles();
+	}
+
+	World::SystemUpdateTask::SystemUpdateTask(World& world) :
+		world(world)
+	{}
+
+	void World::SystemUpdateTask::execute(size_t start,size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+			world.aliveSystems[i] = world.systems[i]->updateParticles(world.deltaTime);
+	}
+}
@@ -35,6 +35,12 @@ namespace SPK
 		&Zone::checkAlways,
 	};
 
+	void Zone::generatePositions(Group& group,size_t start,size_t end,bool full) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			generatePosition(particleIt->position(),full,particleIt->getRadius());
+	}
+
 	bool Zone::checkInside(const Particle& particle,Vector3D* normal) const
 	{
 		return contains(particle.position(),particle.getRadius());
@@ -71,6 +71,12 @@ namespace SPK
 			(*it)->apply(particle);
 	}
 
+	void ActionSet::getTargetGroups(std::vector<Group*>& targets) const
+	{
+		for (std::vector<Ref<Action> >::const_iterator it = actions.begin(); it != actions.end(); ++it)
+			(*it)->getTargetGroups(targets);
+	}
+
 	Ref<SPKObject> ActionSet::findByName(const std::string& name)
 	{
 		Ref<SPKObject> object = Action::findByName(name);
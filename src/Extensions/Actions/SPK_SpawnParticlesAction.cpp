@@ -74,14 +74,22 @@ namespace SPK
 		if (!checkValidity())
 			return;
 
-		const Ref<Emitter>& emitter = getNextAvailableEmitter();
+		Emitter* emitter = getNextAvailableEmitter();
 		emitter->setTank(baseEmitter->getMinTank(),baseEmitter->getMaxTank());
 
 		const Ref<Zone>& zone = emitter->getZone();
 		zone->getTransform().setPosition(particle.position());
 		zone->updateTransform();
 
-		targetGroup->addParticles(SPK_RANDOM(minNb,maxNb + 1),emitter);
+		unsigned int nb = SPK_RANDOM(minNb,maxNb + 1);
+		if (!targetGroup->enqueueParticles(nb,emitter)) // Falls back to the sequential buffer when the spawn queue is full or disabled
+			targetGroup->addParticles(nb,emitter);
+	}
+
+	void SpawnParticlesAction::getTargetGroups(std::vector<Group*>& targets) const
+	{
+		if (targetGroup)
+			targets.push_back(targetGroup.get());
 	}
 
 	bool SpawnParticlesAction::checkValidity() const
@@ -111,20 +119,26 @@ namespace SPK
 		return true;
 	}
 
-	const Ref<Emitter>& SpawnParticlesAction::getNextAvailableEmitter() const
+	Emitter* SpawnParticlesAction::getNextAvailableEmitter() const
 	{
+		// The spawn requests only point to the emitters so an emitter is available once the target group does not use it anymore
+		unsigned int spawnCycle = targetGroup->getNbSpawnCycles();
 		for (size_t i = 0; i < emitterPool.size(); ++i)
 		{
 			emitterPool.push_back(emitterPool.front());
 			emitterPool.pop_front();
-			if (emitterPool.back()->getNbReferences() == 1) // the emitter is available
-				return emitterPool.back();
+			if (spawnCycle - emitterPool.back().spawnCycle >= 2) // the emitter is available
+			{
+				emitterPool.back().spawnCycle = spawnCycle;
+				return emitterPool.back().emitter.get();
+			}
 		}
 
 		// No emitter is available in the pool, a new one must be created
-		emitterPool.push_back(copy(baseEmitter));
-		emitterPool.back()->getTransform().reset();
-		return emitterPool.back();
+		PooledEmitter pooledEmitter = {copy(baseEmitter),spawnCycle};
+		pooledEmitter.emitter->getTransform().reset();
+		emitterPool.push_back(pooledEmitter);
+		return emitterPool.back().emitter.get();
 	}
 
 	void SpawnParticlesAction::resetPool()
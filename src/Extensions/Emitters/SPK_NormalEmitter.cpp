@@ -76,6 +76,13 @@ namespace SPK
 	{
 		if (inverted) speed = -speed;
 		const Ref<Zone>& zone = (!normalZone ? getZone() : normalZone);
-		particle.velocity() = zone->computeNormal(particle.position()) * speed;
+		const Particle& constParticle = particle;
+		particle.velocity() = zone->computeNormal(constParticle.position()) * speed;
+	}
+
+	void NormalEmitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			NormalEmitter::generateVelocity(*particleIt,generateSpeed(*particleIt)); // Non virtual call
 	}
 }
@@ -32,11 +32,17 @@ namespace SPK
 		
 		do 
 		{
-			particle.velocity().set(SPK_RANDOM(-1.0f,1.0f),SPK_RANDOM(-1.0f,1.0f),SPK_RANDOM(-1.0f,1.0f));
+			particle.velocity() = SPK_RANDOM(Vector3D(-1.0f,-1.0f,-1.0f),Vector3D(1.0f,1.0f,1.0f)); // The coordinates are generated in order
 			sqrNorm = particle.velocity().getSqrNorm();
 		}
 		while((sqrNorm > 1.0f) || (sqrNorm == 0.0f));
 
 		particle.velocity() *= speed / std::sqrt(sqrNorm);
 	}
+
+	void RandomEmitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			RandomEmitter::generateVelocity(*particleIt,generateSpeed(*particleIt)); // Non virtual call
+	}
 }
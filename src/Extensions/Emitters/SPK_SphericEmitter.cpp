@@ -132,6 +132,12 @@ namespace SPK
 		particle.velocity().z = speed * (matrix[6] * x + matrix[7] * y + matrix[8] * z);
 	}
 
+	void SphericEmitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			SphericEmitter::generateVelocity(*particleIt,generateSpeed(*particleIt)); // Non virtual call
+	}
+
 	void SphericEmitter::innerUpdateTransform()
 	{
 		Emitter::innerUpdateTransform();
@@ -58,6 +58,12 @@ namespace SPK
 		particle.velocity() *= speed;
 	}
 
+	void StraightEmitter::generateVelocities(Group& group,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			particleIt->velocity() = tDirection * generateSpeed(*particleIt);
+	}
+
 	void StraightEmitter::innerUpdateTransform()
 	{
 		Emitter::innerUpdateTransform();
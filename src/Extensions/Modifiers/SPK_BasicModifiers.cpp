@@ -27,25 +27,35 @@
 namespace SPK
 {
 	void Gravity::modify(Group& group,DataSet* dataSet,float deltaTime) const
+	{
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	void Gravity::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
 	{
 		const Vector3D discreteGravity = tValue * deltaTime;
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 			particleIt->velocity() += discreteGravity;
 	}
 
 	void Friction::modify(Group& group,DataSet* dataSet,float deltaTime) const
+	{
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	void Friction::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
 	{
 		const float discreteFriction = value * deltaTime;
 
 		if (group.isEnabled(PARAM_MASS))
 		{
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 				particleIt->velocity() *= 1.0f - std::min(1.0f,discreteFriction / particleIt->getParamNC(PARAM_MASS));
 		}
 		else
 		{
 			const float ratio =  1.0f - std::min(1.0f,discreteFriction);
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 				particleIt->velocity() *= ratio;
 		}
 	}
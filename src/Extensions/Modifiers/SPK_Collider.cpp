@@ -19,6 +19,9 @@
 // 3. This notice may not be removed or altered from any source distribution.	//
 //////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm> // for std::sort and std::unique
+#include <vector>
+
 #include <SPARK_Core.h>
 #include "Extensions/Modifiers/SPK_Collider.h"
 
@@ -35,58 +38,93 @@ namespace SPK
 		this->elasticity = elasticity;
 	}
 
-	void Collider::modify(Group& group,DataSet* dataSet,float deltaTime) const
+	void Collider::createData(DataSet& dataSet,const Group& group) const
+	{
+		dataSet.init(NB_DATA);
+		if (parallelCollisionsEnabled)
+			createParallelData(dataSet,group);
+	}
+
+	void Collider::checkData(DataSet& dataSet,const Group& group) const
+	{
+		// The data follows the resolution mode
+		bool hasParallelData = dataSet.getData(VELOCITY_CHANGE_INDEX) != NULL;
+		if (parallelCollisionsEnabled && !hasParallelData)
+			createParallelData(dataSet,group);
+		else if (!parallelCollisionsEnabled && hasParallelData)
+			for (size_t i = 0; i < NB_DATA; ++i)
+				dataSet.destroyData(i);
+	}
+
+	void Collider::createParallelData(DataSet& dataSet,const Group& group) const
+	{
+		dataSet.setData(VELOCITY_CHANGE_INDEX,SPK_NEW(Vector3DArrayData,group.getCapacity(),1));
+		dataSet.setData(FLAGS_INDEX,SPK_NEW(ArrayData<unsigned char>,group.getCapacity(),1));
+		dataSet.setData(SPHERES_INDEX,SPK_NEW(FloatArrayData,group.getCapacity(),4));
+		dataSet.setData(BUFFERS_INDEX,SPK_NEW(BufferData));
+	}
+
+	void Collider::modify(Group& group,DataSet* dataSet,float) const
 	{
+		if (parallelCollisionsEnabled)
+		{
+			modifyParallel(group,dataSet);
+			return;
+		}
+
 		float groupSqrRadius = group.getPhysicalRadius() * group.getPhysicalRadius();
-		SPK_ASSERT(group.getOctree() != NULL,"GLQuadRenderer::render(const Group&,const DataSet*,RenderBuffer*) - renderBuffer must not be NULL");
-		const Octree& octree = *group.getOctree();
+		SPK_ASSERT(group.getNeighborStructure() != NULL,"Collider::modify(Group&,DataSet*,float) - The group has no neighbor structure");
+		const NeighborStructure& neighborStructure = *group.getNeighborStructure();
+		NeighborStructure::Array<size_t> neighborCells(8);
 
 		for (GroupIterator particleIt0(group); !particleIt0.end(); ++particleIt0)
 		{
 			Particle& particle0 = *particleIt0;
+			const Particle& constParticle0 = particle0; // The vectors are read through the const accessors so that they are only marked as modified when written
 			float radius0 = particle0.getParam(PARAM_SCALE);
 			float m0 = particle0.getParam(PARAM_MASS);
 
 			size_t index0 = particle0.getIndex();
 
-			const Octree::Array<size_t>& neighborCells = octree.getNeighborCells(index0);
+			neighborStructure.getNeighborCells(index0,neighborCells);
 			size_t nbCells = neighborCells.size();
 
-			for (size_t i = 0; i < nbCells; ++i) // For each neighboring cell in the octree
+			for (size_t i = 0; i < nbCells; ++i) // For each neighboring cell in the structure
 			{
-				const Octree::Cell& cell = octree.getCell(neighborCells[i]);
-				size_t nbParticleInCells = cell.particles.size();
+				const size_t* cellParticles = neighborStructure.getParticlesInCell(neighborCells[i]);
+				size_t nbParticleInCells = neighborStructure.getNbParticlesInCell(neighborCells[i]);
 
 				for (size_t j = 0; j < nbParticleInCells; ++j) // for each particles in the cell
 				{
-					size_t index1 = cell.particles[j];
+					size_t index1 = cellParticles[j];
 					if (index1 >= index0)
 						break; // as particle are ordered
 
 					Particle particle1 = group.getParticle(index1);
+					const Particle& constParticle1 = particle1;
 					float radius1 = particle1.getParam(PARAM_SCALE);
 
 					float sqrRadius = radius0 + radius1;
 					sqrRadius *= sqrRadius * groupSqrRadius;
 
 					// Gets the normal of the collision plane
-					Vector3D normal = particle0.position() - particle1.position();
+					Vector3D normal = constParticle0.position() - constParticle1.position();
 					float sqrDist = normal.getSqrNorm();
 
 					if (sqrDist < sqrRadius) // particles are intersecting each other
 					{
-						Vector3D delta = particle0.velocity() - particle1.velocity();
+						Vector3D delta = constParticle0.velocity() - constParticle1.velocity();
 
 						if (dotProduct(normal,delta) < 0.0f) // particles are moving towards each other
 						{
-							float oldSqrDist = getSqrDist(particle0.oldPosition(),particle1.oldPosition());
+							float oldSqrDist = getSqrDist(constParticle0.oldPosition(),constParticle1.oldPosition());
 							if (oldSqrDist > sqrDist)
 							{
 								// Disables the move from this frame
-								particle0.position() = particle0.oldPosition();
-								particle1.position() = particle1.oldPosition();
+								particle0.position() = constParticle0.oldPosition();
+								particle1.position() = constParticle1.oldPosition();
 
-								normal = particle0.position() - particle1.position();
+								normal = constParticle0.position() - constParticle1.position();
 
 								if (dotProduct(normal,delta) >= 0.0f)
 									continue;
@@ -95,8 +133,8 @@ namespace SPK
 							normal.normalize();
 
 							// Gets the normal components of the velocities
-							Vector3D normal0 = normal * dotProduct(normal,particle0.velocity());
-							Vector3D normal1 = normal * dotProduct(normal,particle1.velocity());
+							Vector3D normal0 = normal * dotProduct(normal,constParticle0.velocity());
+							Vector3D normal1 = normal * dotProduct(normal,constParticle1.velocity());
 
 							// Resolves collision
 							float m1 = particle1.getParam(PARAM_MASS);
@@ -129,7 +167,7 @@ namespace SPK
 								particle1.velocity() -= (1.0f + (elasticityM0 - m1) * invM01) * normal1;
 
 								normal0 *= (elasticityM0 + m0) * invM01;
-								normal1 *= (elasticityM1 + m0) * invM01;
+								normal1 *= (elasticityM1 + m1) * invM01;
 
 								particle0.velocity() += normal1;
 								particle1.velocity() += normal0;
@@ -140,4 +178,200 @@ namespace SPK
 			}
 		}
 	}
+
+	void Collider::modifyParallel(Group& group,DataSet* dataSet) const
+	{
+		SPK_ASSERT(group.getNeighborStructure() != NULL,"Collider::modifyParallel(Group&,DataSet*) - The group has no neighbor structure");
+		size_t nbParticles = group.getNbParticles();
+		if (nbParticles == 0)
+			return;
+
+		// Gathers the vectors on this thread so that the tasks only read them
+		const Group& constGroup = group;
+		const Particle particle = constGroup.getParticle(0);
+		particle.position();
+		particle.velocity();
+		particle.oldPosition();
+
+		// Packs the spheres of the particles so that the narrow phase reads them from a single array
+		float* spheres = SPK_GET_DATA(FloatArrayData,dataSet,SPHERES_INDEX).getData();
+		for (ConstGroupIterator particleIt(constGroup); !particleIt.end(); ++particleIt)
+		{
+			const Vector3D& position = particleIt->position();
+			*(spheres++) = position.x;
+			*(spheres++) = position.y;
+			*(spheres++) = position.z;
+			*(spheres++) = particleIt->getParam(PARAM_SCALE);
+		}
+
+		// First phase : the velocity changes are computed from the state of the particles at the beginning of the step
+		size_t nbChunks = (nbParticles + PARALLEL_GRAIN_SIZE - 1) / PARALLEL_GRAIN_SIZE;
+		std::vector<Buffers>& buffers = SPK_GET_DATA(BufferData,dataSet,BUFFERS_INDEX).buffers;
+		if (buffers.size() < nbChunks)
+			buffers.resize(nbChunks);
+
+		CollisionTask task(*this,group,*group.getNeighborStructure(),dataSet);
+		TaskScheduler* taskScheduler = group.getTaskScheduler();
+		if (taskScheduler != NULL)
+			taskScheduler->parallelFor(task,0,nbChunks,1);
+		else
+			task.execute(0,nbChunks);
+
+		// Second phase : the velocity changes are applied
+		const Vector3D* velocityChanges = SPK_GET_DATA(Vector3DArrayData,dataSet,VELOCITY_CHANGE_INDEX).getData();
+		const unsigned char* flags = SPK_GET_DATA(ArrayData<unsigned char>,dataSet,FLAGS_INDEX).getData();
+		for (size_t i = 0; i < nbParticles; ++i)
+			if (flags[i] != 0)
+			{
+				Particle particle = group.getParticle(i);
+				const Particle& constParticle = particle;
+				if (flags[i] & FLAG_RESET_POSITION)
+					particle.position() = constParticle.oldPosition();
+				particle.velocity() += velocityChanges[i];
+			}
+	}
+
+	void Collider::computeCollisions(const Group& group,const NeighborStructure& neighborStructure,DataSet* dataSet,size_t start,size_t end,Buffers& buffers) const
+	{
+		float groupSqrRadius = group.getPhysicalRadius() * group.getPhysicalRadius();
+		Vector3D* velocityChanges = SPK_GET_DATA(Vector3DArrayData,dataSet,VELOCITY_CHANGE_INDEX).getData();
+		unsigned char* flags = SPK_GET_DATA(ArrayData<unsigned char>,dataSet,FLAGS_INDEX).getData();
+		const float* spheres = SPK_GET_DATA(FloatArrayData,dataSet,SPHERES_INDEX).getData();
+
+		NeighborStructure::Array<size_t>& neighborCells = buffers.neighborCells;
+		std::vector<size_t>& neighbors = buffers.neighbors;
+		std::vector<float>& x = buffers.x;
+		std::vector<float>& y = buffers.y;
+		std::vector<float>& z = buffers.z;
+		std::vector<float>& radii = buffers.radii;
+		std::vector<size_t>& hits = buffers.hits;
+
+		for (size_t index0 = start; index0 < end; ++index0)
+		{
+			const Particle particle0 = group.getParticle(index0);
+			float radius0 = particle0.getParam(PARAM_SCALE);
+			float m0 = particle0.getParam(PARAM_MASS);
+
+			// Gathers the neighbors
+			neighbors.clear();
+			neighborStructure.getNeighborCells(index0,neighborCells);
+			for (size_t i = 0; i < neighborCells.size(); ++i)
+			{
+				const size_t* cellParticles = neighborStructure.getParticlesInCell(neighborCells[i]);
+				size_t nbParticlesInCell = neighborStructure.getNbParticlesInCell(neighborCells[i]);
+				for (size_t j = 0; j < nbParticlesInCell; ++j)
+					if (cellParticles[j] != index0)
+						neighbors.push_back(cellParticles[j]);
+			}
+
+			size_t nbNeighbors = neighbors.size();
+			if (x.size() < nbNeighbors) // The buffers only grow
+			{
+				x.resize(nbNeighbors);
+				y.resize(nbNeighbors);
+				z.resize(nbNeighbors);
+				radii.resize(nbNeighbors);
+				hits.resize(nbNeighbors);
+			}
+
+			for (size_t i = 0; i < nbNeighbors; ++i)
+			{
+				const float* sphere = spheres + (neighbors[i] << 2);
+				x[i] = sphere[0];
+				y[i] = sphere[1];
+				z[i] = sphere[2];
+				radii[i] = sphere[3];
+			}
+
+			// Narrow phase
+			size_t nbHits = nbNeighbors > 0 ? SIMD::findIntersections(&hits[0],&x[0],&y[0],&z[0],&radii[0],0,nbNeighbors,particle0.position(),radius0,groupSqrRadius) : 0;
+
+			// A neighbor sharing several cells with the particle is resolved once
+			for (size_t i = 0; i < nbHits; ++i)
+				hits[i] = neighbors[hits[i]];
+			if (neighborCells.size() > 1)
+			{
+				std::sort(hits.begin(),hits.begin() + nbHits);
+				nbHits = std::unique(hits.begin(),hits.begin() + nbHits) - hits.begin();
+			}
+
+			// Accumulates the velocity changes of the particle. Each change is the one the sequential resolution gives the particle for an isolated pair.
+			// Unlike the sequential resolution, all the changes are computed from the velocities at the beginning of the step
+			Vector3D velocityChange;
+			size_t nbCollisions = 0;
+			unsigned char particleFlags = 0;
+			for (size_t i = 0; i < nbHits; ++i)
+			{
+				const Particle particle1 = group.getParticle(hits[i]);
+				float radius1 = particle1.getParam(PARAM_SCALE);
+
+				float sqrRadius = radius0 + radius1;
+				sqrRadius *= sqrRadius * groupSqrRadius;
+
+				Vector3D normal = particle0.position() - particle1.position();
+				float sqrDist = normal.getSqrNorm();
+				Vector3D delta = particle0.velocity() - particle1.velocity();
+
+				if (dotProduct(normal,delta) >= 0.0f) // particles are not moving towards each other
+					continue;
+
+				float oldSqrDist = getSqrDist(particle0.oldPosition(),particle1.oldPosition());
+				if (oldSqrDist > sqrDist)
+				{
+					// Disables the move from this frame
+					particleFlags |= FLAG_RESET_POSITION;
+					normal = particle0.oldPosition() - particle1.oldPosition();
+
+					if (dotProduct(normal,delta) >= 0.0f)
+						continue;
+				}
+
+				particleFlags |= FLAG_COLLIDED;
+				++nbCollisions;
+				normal.normalize();
+
+				// Gets the normal components of the velocities
+				Vector3D normal0 = normal * dotProduct(normal,particle0.velocity());
+				Vector3D normal1 = normal * dotProduct(normal,particle1.velocity());
+
+				if (oldSqrDist < sqrRadius)
+				{
+					// Particles intersecting at both t - deltaTime and t are separated
+					if (dotProduct(normal,normal0) < 0.0f)
+						velocityChange -= normal0;
+					if (dotProduct(normal,normal1) > 0.0f)
+						velocityChange += normal1;
+				}
+				else
+				{
+					float m1 = particle1.getParam(PARAM_MASS);
+					float invM01 = 1 / (m0 + m1);
+					velocityChange -= (1.0f + (elasticity * m1 - m0) * invM01) * normal0;
+					velocityChange += normal1 * ((elasticity * m1 + m1) * invM01);
+				}
+			}
+
+			// The changes are averaged as they are all computed from the same velocity
+			if (nbCollisions > 1)
+				velocityChange /= static_cast<float>(nbCollisions);
+
+			velocityChanges[index0] = velocityChange;
+			flags[index0] = particleFlags;
+		}
+	}
+
+	Collider::CollisionTask::CollisionTask(const Collider& collider,const Group& group,const NeighborStructure& neighborStructure,DataSet* dataSet) :
+		collider(collider),
+		group(group),
+		neighborStructure(neighborStructure),
+		dataSet(dataSet)
+	{}
+
+	void Collider::CollisionTask::execute(size_t start,size_t end)
+	{
+		std::vector<Buffers>& buffers = SPK_GET_DATA(BufferData,dataSet,BUFFERS_INDEX).buffers;
+		size_t nbParticles = group.getNbParticles();
+		for (size_t i = start; i < end; ++i)
+			collider.computeCollisions(group,neighborStructure,dataSet,i * PARALLEL_GRAIN_SIZE,std::min(nbParticles,(i + 1) * PARALLEL_GRAIN_SIZE),buffers[i]);
+	}
 }
@@ -43,6 +43,12 @@ namespace SPK
 
 	EmitterAttacher::~EmitterAttacher(){}
 
+	void EmitterAttacher::getTargetGroups(std::vector<Group*>& targets) const
+	{
+		if (targetGroup)
+			targets.push_back(targetGroup.get());
+	}
+
 	EmitterAttacher::EmitterData::EmitterData(size_t nbParticles,Group* emittingGroup) :
 		data(SPK_NEW_ARRAY(Ref<Emitter>,nbParticles)),
 		dataSize(nbParticles),
@@ -156,7 +162,8 @@ namespace SPK
 			}
 
 			emitter->updateTransform();
-			targetGroup->addParticles(emitter,deltaTime);
+			if (!targetGroup->enqueueParticles(emitter.get(),deltaTime)) // Falls back to the sequential buffer when the spawn queue is full or disabled
+				targetGroup->addParticles(emitter,deltaTime);
 
 			++emitterIt;
 		}
@@ -164,7 +171,29 @@ namespace SPK
 
 	void EmitterAttacher::EmitterData::setEmitter(size_t index,const Ref<Emitter>& emitter)
 	{
+		// The spawn requests only point to the emitters so they are released once the target group does not use them anymore
+		while (!releasedEmitters.empty() && (group == NULL || group->getNbSpawnCycles() - releasedEmitters.front().spawnCycle >= 2))
+			releasedEmitters.pop_front();
+
+		if (data[index] && group != NULL)
+		{
+			releasedEmitters.push_back(ReleasedEmitter());
+			SPK::swap(releasedEmitters.back().emitter,data[index]);
+			releasedEmitters.back().spawnCycle = group->getNbSpawnCycles();
+		}
+
 		data[index] = copy(emitter);
 		data[index]->getTransform().reset();
 	}
+
+	bool EmitterAttacher::EmitterData::resize(size_t capacity,size_t nbParticles)
+	{
+		Ref<Emitter>* oldData = data;
+		data = SPK_NEW_ARRAY(Ref<Emitter>,capacity);
+		for (size_t i = 0; i < nbParticles; ++i)
+			SPK::swap(data[i],oldData[i]); // The emitters are moved without touching their reference counters
+		SPK_DELETE_ARRAY(oldData);
+		dataSize = capacity;
+		return true;
+	}
 }
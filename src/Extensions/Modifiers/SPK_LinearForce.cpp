@@ -25,7 +25,7 @@
 namespace SPK
 {
 	LinearForce::LinearForce(const Vector3D& value,const Ref<Zone>& zone,ZoneTest zoneTest) :
-		ZonedModifier(MODIFIER_PRIORITY_FORCE,false,false,false,ZONE_TEST_FLAG_ALWAYS | ZONE_TEST_FLAG_INSIDE | ZONE_TEST_FLAG_OUTSIDE,zoneTest,zone),
+		ZonedModifier(MODIFIER_PRIORITY_FORCE,false,false,false,ZONE_TEST_FLAG_ALWAYS | ZONE_TEST_FLAG_INSIDE | ZONE_TEST_FLAG_OUTSIDE,zoneTest,zone,true,true),
 		relative(false),
 		squaredSpeed(false),
 		param(PARAM_SCALE),
@@ -131,6 +131,11 @@ namespace SPK
 	}
 
 	void LinearForce::modify(Group& group,DataSet* dataSet,float deltaTime) const
+	{
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	void LinearForce::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
 	{
 		// Optimization to compute the factor only if needed
 		bool factorByParticle = true;
@@ -151,20 +156,20 @@ namespace SPK
 
 			if (!factorByParticle)
 			{
-				for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+				for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 					if (checkZone(*particleIt))
 						particleIt->velocity() += discreteForce;
 			}
 			else
 			{
-				for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+				for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 					if (checkZone(*particleIt))
 						particleIt->velocity() += discreteForce * getDiscreteFactor(*particleIt);
 			}
 		}
 		else
 		{
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 				if (checkZone(*particleIt))
 				{
 					Particle& particle = *particleIt;
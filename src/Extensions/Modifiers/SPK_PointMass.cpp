@@ -25,7 +25,7 @@
 namespace SPK
 {
 	PointMass::PointMass(const Vector3D& pos,float mass,float offset) :
-		Modifier(MODIFIER_PRIORITY_FORCE,false,false,false),
+		Modifier(MODIFIER_PRIORITY_FORCE,false,false,false,true,true),
 		mass(mass)
 	{
 		setPosition(pos);
@@ -52,14 +52,20 @@ namespace SPK
 	}
 
 	void PointMass::modify(Group& group,DataSet* dataSet,float deltaTime) const
+	{
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	void PointMass::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
 	{
 		float sqrOffset = offset * offset;
 		float massSecond = mass * deltaTime;
 
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 		{
 			Particle& particle = *particleIt;
-			Vector3D force = tPosition - particle.position();
+			const Particle& constParticle = particle; // Reads the position without marking it as modified
+			Vector3D force = tPosition - constParticle.position();
 			force *= massSecond / (force.getSqrNorm() + sqrOffset);
 			particle.velocity() += force;
 		}
@@ -25,7 +25,7 @@
 namespace SPK
 {
 	RandomForce::RandomForce(const Vector3D& minVector,const Vector3D& maxVector,float minPeriod,float maxPeriod) :
-		Modifier(MODIFIER_PRIORITY_FORCE,true,true,false),
+		Modifier(MODIFIER_PRIORITY_FORCE,true,true,false,true,true),
 		minPeriod(1.0f),
 		maxPeriod(1.0f)
 	{
@@ -87,14 +87,6 @@ namespace SPK
 		initParticle(particle,dataSet);
 	}
 
-	void RandomForce::advanceTime(const Particle& particle,DataSet* dataSet,float deltaTime,float& time) const
-	{
-		if (time <= 0.0f)
-			initParticle(particle,dataSet);
-		else
-			time -= deltaTime;
-	}
-
 	void RandomForce::initParticle(const Particle& particle,DataSet* dataSet) const
 	{
 		size_t index = particle.getIndex();
@@ -104,30 +96,34 @@ namespace SPK
 
 	void RandomForce::modify(Group& group,DataSet* dataSet,float deltaTime) const
 	{
-		Vector3D* forceIt = SPK_GET_DATA(Vector3DArrayData,dataSet,FORCE_VECTOR_INDEX).getData();
-		float* timeIt = SPK_GET_DATA(FloatArrayData,dataSet,REMAINING_TIME_INDEX).getData();
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
 
-		if (group.isEnabled(PARAM_MASS))
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
-			{
-				Particle& particle = *particleIt;
-				advanceTime(particle,dataSet,deltaTime,*timeIt);
+	void RandomForce::modifyRange(Group& group,DataSet* dataSet,float deltaTime,size_t start,size_t end) const
+	{
+		Vector3D* forces = SPK_GET_DATA(Vector3DArrayData,dataSet,FORCE_VECTOR_INDEX).getData();
+		float* times = SPK_GET_DATA(FloatArrayData,dataSet,REMAINING_TIME_INDEX).getData();
+		bool massEnabled = group.isEnabled(PARAM_MASS);
 
-				particle.velocity() += *forceIt * deltaTime / particle.getParamNC(PARAM_MASS);
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+		{
+			Particle& particle = *particleIt;
+			size_t index = particle.getIndex();
 
-				++forceIt;
-				++timeIt;
-			}
-		else
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			if (times[index] <= 0.0f)
 			{
-				Particle& particle = *particleIt;
-				advanceTime(particle,dataSet,deltaTime,*timeIt);
-
-				particle.velocity() += *forceIt * deltaTime; // opti for unset mass
-
-				++forceIt;
-				++timeIt;
+				// The stream of the particle is used so that the range can be modified on any thread
+				RandomStream randomStream = group.getParticleRandomStream(index);
+				forces[index] = randomStream.generate(tMinVector,tMaxVector);
+				times[index] = randomStream.generate(minPeriod,maxPeriod);
 			}
+			else
+				times[index] -= deltaTime;
+
+			if (massEnabled)
+				particle.velocity() += forces[index] * deltaTime / particle.getParamNC(PARAM_MASS);
+			else
+				particle.velocity() += forces[index] * deltaTime; // opti for unset mass
+		}
 	}
 }
@@ -27,12 +27,24 @@ namespace SPK
 	void Rotator::modify(Group& group,DataSet* dataSet,float deltaTime) const
 	{
 		if (group.isEnabled(PARAM_ANGLE) && group.isEnabled(PARAM_ROTATION_SPEED))
-			for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
-			{
-				float angle = particleIt->getParamNC(PARAM_ANGLE) + particleIt->getParamNC(PARAM_ROTATION_SPEED) * deltaTime;
-				particleIt->setParamNC(PARAM_ANGLE,angle);
-			}
+			rotate(group,deltaTime,0,group.getNbParticles());
 		else
 			SPK_LOG_WARNING("Rotator::modify(Group&,DataSet*,float) - PARAM_ANGLE and PARAM_ROTATION_SPEED must be enabled to use a rotator");
 	}
+
+	void Rotator::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
+	{
+		// Within the fused update, the range is skipped silently (the warning is logged by modify(Group&,DataSet*,float) const)
+		if (group.isEnabled(PARAM_ANGLE) && group.isEnabled(PARAM_ROTATION_SPEED))
+			rotate(group,deltaTime,start,end);
+	}
+
+	void Rotator::rotate(Group& group,float deltaTime,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+		{
+			float angle = particleIt->getParamNC(PARAM_ANGLE) + particleIt->getParamNC(PARAM_ROTATION_SPEED) * deltaTime;
+			particleIt->setParamNC(PARAM_ANGLE,angle);
+		}
+	}
 }
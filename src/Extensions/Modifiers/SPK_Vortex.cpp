@@ -25,7 +25,7 @@
 namespace SPK
 {
 	Vortex::Vortex(const Vector3D& position,const Vector3D& direction,float rotationSpeed,float attractionSpeed) :
-		Modifier(MODIFIER_PRIORITY_POSITION,false,false,false),
+		Modifier(MODIFIER_PRIORITY_POSITION,false,false,false,true,true),
 		rotationSpeed(rotationSpeed),
 		attractionSpeed(attractionSpeed),
 		angularSpeedEnabled(false),
@@ -62,12 +62,18 @@ namespace SPK
 
 	void Vortex::modify(Group& group,DataSet* dataSet,float deltaTime) const
 	{
-		for (GroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		modifyRange(group,dataSet,deltaTime,0,group.getNbParticles());
+	}
+
+	void Vortex::modifyRange(Group& group,DataSet*,float deltaTime,size_t start,size_t end) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
 		{
 			Particle& particle = *particleIt;
+			const Particle& constParticle = particle; // The position is only marked as modified when it is written
 
 			// Distance of the projection point from the position of the vortex
-			float dist = dotProduct(tDirection,particle.position() - tPosition);
+			float dist = dotProduct(tDirection,constParticle.position() - tPosition);
 			
 			// Position of the rotation center (orthogonal projection of the particle)
 			Vector3D rotationCenter = tDirection;
@@ -75,19 +81,19 @@ namespace SPK
 			rotationCenter += tPosition;
 
 			// Distance of the particle from the eye of the vortex
-			dist = getDist(rotationCenter,particle.position());
+			dist = getDist(rotationCenter,constParticle.position());
 
 			if (dist <= eyeRadius)
 			{
 				if (killingParticleEnabled)
 					particle.kill();
-				return;
+				continue;
 			}
 		
 			float angle = angularSpeedEnabled ? rotationSpeed * deltaTime : rotationSpeed * deltaTime / dist;
 
 			// Computes ortho base
-			Vector3D normal = (particle.position() - rotationCenter) / dist;
+			Vector3D normal = (constParticle.position() - rotationCenter) / dist;
 			Vector3D tangent = crossProduct(tDirection,normal);
 
 			float endRadius = linearSpeedEnabled ? dist * (1.0f - attractionSpeed * deltaTime) : dist - attractionSpeed * deltaTime;
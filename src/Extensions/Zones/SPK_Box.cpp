@@ -113,6 +113,12 @@ namespace SPK
 			v += randomDim[i] * tAxis[i];
 	}
 
+	void Box::generatePositions(Group& group,size_t start,size_t end,bool full) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			Box::generatePosition(particleIt->position(),full,particleIt->getRadius()); // Non virtual call
+	}
+
 	bool Box::contains(const Vector3D& v,float radius) const
 	{
 		Vector3D d(v - getTransformedPosition());
@@ -101,6 +101,12 @@ namespace SPK
 		v += SPK_RANDOM(-relHeight,relHeight) * tAxis;
 		v += getTransformedPosition();
 	}
+
+	void Cylinder::generatePositions(Group& group,size_t start,size_t end,bool full) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			Cylinder::generatePosition(particleIt->position(),full,particleIt->getRadius()); // Non virtual call
+	}
 	
 	bool Cylinder::contains(const Vector3D& v,float radius) const
 	{
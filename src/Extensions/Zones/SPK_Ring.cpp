@@ -91,6 +91,12 @@ namespace SPK
 		v += getTransformedPosition();
 	}
 
+	void Ring::generatePositions(Group& group,size_t start,size_t end,bool full) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			Ring::generatePosition(particleIt->position(),full,particleIt->getRadius()); // Non virtual call
+	}
+
 	bool Ring::intersects(const Vector3D& v0,const Vector3D& v1,float radius,Vector3D* normal) const
 	{
 		Vector3D r0 = v0 - getTransformedPosition();
@@ -61,6 +61,12 @@ namespace SPK
 		v += getTransformedPosition();
 	}
 
+	void Sphere::generatePositions(Group& group,size_t start,size_t end,bool full) const
+	{
+		for (GroupIterator particleIt(group,start,end); !particleIt.end(); ++particleIt)
+			Sphere::generatePosition(particleIt->position(),full,particleIt->getRadius()); // Non virtual call
+	}
+
 	bool Sphere::contains(const Vector3D& v,float radius) const
 	{
 		const float relRadius = this->radius - radius;
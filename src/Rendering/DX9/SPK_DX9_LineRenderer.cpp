@@ -56,7 +56,7 @@ namespace DX9
 
 		DX9Info::getDevice()->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_FLAT);
 
-		for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 		{
 			const Particle& particle = *particleIt;
 
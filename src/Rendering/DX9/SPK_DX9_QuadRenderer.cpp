@@ -185,14 +185,14 @@ namespace DX9
 			computeGlobalOrientation3D(group);
 
 			buffer.lock(lockType);
-			for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 				(this->*renderParticle)(*particleIt,buffer);
 			buffer.unlock();
 		}
 		else
 		{
 			buffer.lock(lockType);
-			for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 			{
 				computeSingleOrientation3D(*particleIt);
 				(this->*renderParticle)(*particleIt,buffer);
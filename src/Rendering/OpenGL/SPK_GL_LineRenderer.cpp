@@ -54,7 +54,7 @@ namespace GL
 		glDisable(GL_TEXTURE_2D);
 		glShadeModel(GL_FLAT);
 
-		for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+		for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 		{
 			const Particle& particle = *particleIt;
 
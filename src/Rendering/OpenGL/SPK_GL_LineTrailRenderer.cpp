@@ -132,12 +132,24 @@ namespace GL
 			const Particle& particle = *particleIt;
 			float age = particle.getAge();
 
-			if (age - *(ageIt + 1) >= ageStep) // shifts the data by one
+			float elapsedTime = age - *(ageIt + 1);
+			if (elapsedTime >= ageStep) // shifts the data by the number of samples elapsed (several if the renderer was not updated at each step)
 			{
-				std::memmove(vertexIt + 2,vertexIt + 1,(nbSamples - 1) * sizeof(Vector3D));
-				std::memmove(colorIt + 2,colorIt + 1,(nbSamples - 1) * sizeof(Color));
-				std::memmove(ageIt + 1,ageIt,(nbSamples - 1) * sizeof(float));
-				std::memmove(startAlphaIt + 1,startAlphaIt,(nbSamples - 1) * sizeof(unsigned char));
+				size_t nbShifts = std::min(static_cast<size_t>(elapsedTime / ageStep),nbSamples - 1);
+				std::memmove(vertexIt + 1 + nbShifts,vertexIt + 1,(nbSamples - nbShifts) * sizeof(Vector3D));
+				std::memmove(colorIt + 1 + nbShifts,colorIt + 1,(nbSamples - nbShifts) * sizeof(Color));
+				std::memmove(ageIt + nbShifts,ageIt,(nbSamples - nbShifts) * sizeof(float));
+				std::memmove(startAlphaIt + nbShifts,startAlphaIt,(nbSamples - nbShifts) * sizeof(unsigned char));
+
+				// The samples skipped are interpolated between the last current sample and the current position
+				for (size_t i = 1; i < nbShifts; ++i)
+				{
+					float ratio = static_cast<float>(i) / nbShifts;
+					vertexIt[nbShifts + 1 - i] = vertexIt[nbShifts + 1] + (particle.position() - vertexIt[nbShifts + 1]) * ratio;
+					colorIt[nbShifts + 1 - i] = colorIt[nbShifts + 1];
+					ageIt[nbShifts - i] = ageIt[nbShifts] + (age - ageIt[nbShifts]) * ratio;
+					startAlphaIt[nbShifts - i] = startAlphaIt[nbShifts];
+				}
 
 				// post degenerated vertex copy
 				std::memcpy(vertexIt + (nbSamples + 1),vertexIt + nbSamples,sizeof(Vector3D));
@@ -129,7 +129,12 @@ namespace GL
 		glVertexPointer(3,GL_FLOAT,0,group.getPositionAddress());
 		glColorPointer(4,GL_UNSIGNED_BYTE,0,group.getColorAddress());
 
-		glDrawArrays(GL_POINTS,0,group.getNbParticles());
+		// Particles sorted by index are drawn in their sorting order without moving their data
+		const unsigned int* sortedIndices = group.getSortedIndices();
+		if (sortedIndices != NULL)
+			glDrawElements(GL_POINTS,group.getNbParticles(),GL_UNSIGNED_INT,sortedIndices);
+		else
+			glDrawArrays(GL_POINTS,0,group.getNbParticles());
 
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glDisableClientState(GL_COLOR_ARRAY);
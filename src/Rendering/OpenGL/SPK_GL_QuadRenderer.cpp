@@ -175,12 +175,12 @@ namespace GL
 		{
 			computeGlobalOrientation3D(group);
 
-			for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 				(this->*renderParticle)(*particleIt,buffer);
 		}
 		else
 		{
-			for (ConstGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
+			for (ConstSortedGroupIterator particleIt(group); !particleIt.end(); ++particleIt)
 			{
 				computeSingleOrientation3D(*particleIt);
 				(this->*renderParticle)(*particleIt,buffer);